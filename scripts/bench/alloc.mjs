@@ -0,0 +1,99 @@
+#!/usr/bin/env node
+// Allocator comparison across bundles built with different MJWF_MALLOC: handle
+// create/free churn, mj_makeData/mj_deleteData on a live model, and stepping a
+// contact pile while reading the contact views, plus peak heap and free-space
+// fragmentation after the churn.
+// Usage: node scripts/bench/alloc.mjs [dist dirs, comma separated] [churn] [steps]
+// e.g.   node scripts/bench/alloc.mjs 3.3.7,3.3.7-emmalloc,3.3.7-mimalloc
+// Build the variants with -DMJWF_MALLOC=<name> into dist/<mjver>-<name>.
+
+import { performance } from "node:perf_hooks";
+import { loadHandleBundle, makeHandle, heapF64 } from "../../tests/handles/_harness.mjs";
+
+const DIRS = (process.argv[2] || "3.3.7").split(",");
+const CHURN = Number(process.argv[3] || 2000);
+const STEPS = Number(process.argv[4] || 2000);
+const HEAP_MEMORY = 0;
+const HEAP_IN_USE = 2;
+const HEAP_FREE = 3;
+const HEAP_ARENA = 4;
+const HEAP_NSTAT = 5;
+
+// 6 x 6 boxes dropped on a floor: a few hundred contacts once settled.
+const boxes = [];
+for (let i = 0; i < 36; i += 1) {
+  const x = 0.12 * (i % 6) - 0.3;
+  const y = 0.12 * Math.floor(i / 6) - 0.3;
+  boxes.push(`<body pos="${x.toFixed(2)} ${y.toFixed(2)} ${(0.1 + 0.11 * (i % 3)).toFixed(2)}">` +
+    `<freejoint/><geom type="box" size="0.05 0.05 0.05"/></body>`);
+}
+const PILE_XML = `<mujoco model="pile">
+  <option timestep="0.002"/>
+  <worldbody>
+    <geom type="plane" size="2 2 0.1"/>
+    ${boxes.join("\n    ")}
+  </worldbody>
+</mujoco>`;
+
+const runs = [];
+for (const dir of DIRS) {
+  const ctx = await loadHandleBundle(`bench-alloc ${dir}`, dir);
+  if (!ctx) continue;
+  const { Module } = ctx;
+  const call = (name, ...args) => Module.ccall(name, "number", args.map(() => "number"), args);
+  const stats = call("mjwf_mju_malloc", 8 * HEAP_NSTAT);
+  const heapStats = () => {
+    call("mjwf_heap_stats", stats);
+    return Array.from(heapF64(Module, stats, HEAP_NSTAT));
+  };
+  const base = heapStats();
+
+  // Handle churn: a rolling set of 16 handles, one create + one free per op.
+  Module.FS.writeFile("/pile.xml", PILE_XML);
+  const live = [];
+  const t0 = performance.now();
+  for (let i = 0; i < CHURN; i += 1) {
+    live.push(Module.ccall("mjwf_make_from_xml", "number", ["string"], ["/pile.xml"]));
+    if (live.length > 16) call("mjwf_free", live.splice((i * 7) % live.length, 1)[0]);
+  }
+  const churn = CHURN / ((performance.now() - t0) / 1000);
+
+  // mjData churn on one model, bypassing the handle layer.
+  const m = call("mjwf_model_ptr", live[0]);
+  const t1 = performance.now();
+  for (let i = 0; i < CHURN; i += 1) call("mjwf_mj_deleteData", call("mjwf_mj_makeData", m));
+  const makeData = CHURN / ((performance.now() - t1) / 1000);
+
+  // Stepping with contact views read every step (per-handle view buffers).
+  const h = live[live.length - 1];
+  call("mjwf_step", h, 200);
+  const t2 = performance.now();
+  let ncon = 0;
+  for (let i = 0; i < STEPS; i += 1) {
+    call("mjwf_step", h, 1);
+    ncon = call("mjwf_ncon", h);
+    call("mjwf_contact_pos_ptr", h);
+    call("mjwf_contact_frame_ptr", h);
+  }
+  const stepUs = (performance.now() - t2) * 1000 / STEPS;
+
+  const s = heapStats();
+  for (const x of live) call("mjwf_free", x);
+  const after = heapStats();
+  const frag = (v) => (v[HEAP_IN_USE] < 0 ? null : +(v[HEAP_FREE] / (v[HEAP_IN_USE] + v[HEAP_FREE])).toFixed(3));
+  runs.push({
+    dist: dir,
+    malloc: Module.ccall("mjwf_malloc_name", "string", [], []),
+    handle_churn_per_s: Math.round(churn),
+    make_data_per_s: Math.round(makeData),
+    step_us: +stepUs.toFixed(2),
+    ncon,
+    heap_start: base[HEAP_MEMORY],
+    heap_peak: s[HEAP_MEMORY],
+    arena_bytes: s[HEAP_ARENA],
+    frag_live: frag(s),
+    frag_after_free: frag(after),
+  });
+}
+
+console.log(JSON.stringify({ bench: "alloc", churn: CHURN, steps: STEPS, runs }));
@@ -0,0 +1,79 @@
+#!/usr/bin/env node
+// Loading many variants of one mesh-heavy robot with and without the asset
+// cache. Without it MuJoCo reads every mesh file for every variant; with it
+// the loader registers the meshes (read + hash once, then stat-only hits) and
+// every load is served from the shared VFS.
+// Usage: node scripts/bench/assets.mjs [mjver] [variants] [meshes] [verts]
+
+import { performance } from "node:perf_hooks";
+import { loadHandleBundle } from "../../tests/handles/_harness.mjs";
+
+const VARIANTS = Number(process.argv[3] || 50);
+const MESHES = Number(process.argv[4] || 8);
+const VERTS = Number(process.argv[5] || 2000);
+
+const ctx = await loadHandleBundle("bench-assets");
+if (!ctx) process.exit(0);
+const { Module, mjver } = ctx;
+const c = (name, ret, args) => Module.cwrap(name, ret, args);
+const make = c("mjwf_make_from_xml", "number", ["string"]);
+const freeH = c("mjwf_free", null, ["number"]);
+const addFile = c("mjwf_asset_add_file", "number", ["string"]);
+const clear = c("mjwf_asset_cache_clear", null, []);
+const statsPtr = Module.ccall("mjwf_mju_malloc", "number", ["number"], [8 * 7]);
+
+// Vertex-only OBJ point clouds; the compiler computes their convex hulls.
+Module.FS.mkdirTree("/robot/meshes");
+const meshPaths = [];
+for (let m = 0; m < MESHES; m += 1) {
+  const lines = [];
+  for (let i = 0; i < VERTS; i += 1) {
+    const y = 1 - (2 * (i + 0.5)) / VERTS;
+    const r = Math.sqrt(1 - y * y);
+    const a = i * Math.PI * (3 - Math.sqrt(5)) + m;
+    lines.push(`v ${(0.04 * r * Math.cos(a)).toFixed(6)} ${(0.03 * y).toFixed(6)} ${(0.05 * r * Math.sin(a)).toFixed(6)}`);
+  }
+  const p = `/robot/meshes/link${m}.obj`;
+  Module.FS.writeFile(p, `${lines.join("\n")}\n`);
+  meshPaths.push(p);
+}
+const variantXml = (v) => {
+  const assets = meshPaths.map((p, m) => `<mesh name="link${m}" file="${p}"/>`).join("");
+  let bodies = "";
+  for (let m = MESHES - 1; m >= 0; m -= 1) {
+    bodies = `<body name="l${m}" pos="0 0 ${m ? 0.1 + 0.001 * v : 0.5}"><joint type="hinge" axis="0 1 0"/>` +
+      `<geom type="mesh" mesh="link${m}"/>${bodies}</body>`;
+  }
+  return `<mujoco model="variant${v}"><asset>${assets}</asset><worldbody>${bodies}</worldbody></mujoco>`;
+};
+for (let v = 0; v < VARIANTS; v += 1) Module.FS.writeFile(`/robot/variant${v}.xml`, variantXml(v));
+
+const loadAll = (withCache) => {
+  const t = performance.now();
+  for (let v = 0; v < VARIANTS; v += 1) {
+    if (withCache) meshPaths.forEach(addFile);
+    const h = make(`/robot/variant${v}.xml`);
+    if (h <= 0) throw new Error(Module.ccall("mjwf_errmsg_last_global", "string", [], []));
+    freeH(h);
+  }
+  return performance.now() - t;
+};
+
+clear();
+const uncachedMs = loadAll(false);
+const cachedMs = loadAll(true);
+Module.ccall("mjwf_asset_cache_stats", "number", ["number"], [statsPtr]);
+const [entries, bytes, hits, misses, evictions, bytesRead] = new Float64Array(Module.HEAP8.buffer, statsPtr, 7);
+console.log(JSON.stringify({
+  bench: "assets",
+  mjver,
+  variants: VARIANTS,
+  meshes: MESHES,
+  verts_per_mesh: VERTS,
+  uncached_ms_per_variant: Number((uncachedMs / VARIANTS).toFixed(2)),
+  cached_ms_per_variant: Number((cachedMs / VARIANTS).toFixed(2)),
+  speedup: Number((uncachedMs / cachedMs).toFixed(2)),
+  cache: { entries, bytes, hits, misses, evictions, bytes_read: bytesRead },
+}));
+clear();
+Module.ccall("mjwf_mju_free", null, ["number"], [statsPtr]);
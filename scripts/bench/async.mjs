@@ -0,0 +1,76 @@
+#!/usr/bin/env node
+// Blocking vs async model creation seen from a frame loop: a pendulum handle
+// is stepped every frame (yielding to the event loop in between, as a UI or a
+// worker's step loop would) while a mesh-heavy model is created with
+// mjwf_make_from_xml or with mjwf_make_from_xml_async + one poll per frame.
+// Reports compile wall time, the longest frame gap, and steps taken on the
+// other handle while the model was compiling.
+// Usage: node scripts/bench/async.mjs [mjver] [meshes] [vertices per mesh]
+// Only a pthread bundle (-DMJWF_THREADS=ON) compiles in the background;
+// single-threaded bundles run the async make inline and match the sync column.
+
+import { performance } from "node:perf_hooks";
+import { loadHandleBundle, makeHandle, PENDULUM_XML } from "../../tests/handles/_harness.mjs";
+
+const NMESH = Number(process.argv[3] || 16);
+const NVERT = Number(process.argv[4] || 20000);
+const STEPS = 10;  // per frame
+const MAKE_PENDING = 0;
+
+let seed = 7;
+const rnd = () => (seed = (seed * 16807) % 2147483647) / 2147483647 - 0.5;
+const meshes = [];
+const bodies = [];
+for (let i = 0; i < NMESH; i += 1) {
+  const v = [];
+  for (let k = 0; k < NVERT; k += 1) v.push((0.1 * rnd()).toFixed(5), (0.1 * rnd()).toFixed(5), (0.1 * rnd()).toFixed(5));
+  meshes.push(`<mesh name="m${i}" vertex="${v.join(" ")}"/>`);
+  bodies.push(`<body pos="${(0.3 * i).toFixed(1)} 0 0.5"><freejoint/><geom type="mesh" mesh="m${i}"/></body>`);
+}
+const PILE_XML = `<mujoco model="meshpile"><asset>${meshes.join("")}</asset>
+  <worldbody><geom type="plane" size="10 10 0.1"/>${bodies.join("")}</worldbody></mujoco>`;
+
+const ctx = await loadHandleBundle("bench-async", process.argv[2] || process.env.MJVER || "3.3.7");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const call = (name, ...args) => Module.ccall(name, "number", args.map(() => "number"), args);
+  const tick = () => new Promise((resolve) => setImmediate(resolve));
+  Module.FS.writeFile("/pile.xml", PILE_XML);
+  const other = makeHandle(Module, PENDULUM_XML, "/pendulum.xml");
+
+  const runs = {};
+  for (const mode of ["sync", "async"]) {
+    let h = 0;
+    let steps = 0;
+    let maxGap = 0;
+    let last = performance.now();
+    const t0 = last;
+    for (let frame = 0; ; frame += 1) {
+      steps += STEPS * call("mjwf_step", other, STEPS);
+      if (mode === "sync") {
+        h = Module.ccall("mjwf_make_from_xml", "number", ["string"], ["/pile.xml"]);
+      } else if (frame === 0) {
+        h = Module.ccall("mjwf_make_from_xml_async", "number", ["string"], ["/pile.xml"]);
+      }
+      const done = mode === "sync" || call("mjwf_make_poll", h) !== MAKE_PENDING;
+      await tick();
+      const now = performance.now();
+      maxGap = Math.max(maxGap, now - last);
+      last = now;
+      if (done) break;
+    }
+    const wallMs = performance.now() - t0;
+    runs[mode] = {
+      compile_ms: +wallMs.toFixed(1),
+      max_frame_gap_ms: +maxGap.toFixed(2),
+      steps_during_compile: steps,
+      steps_per_s: Math.round(steps / (wallMs / 1000)),
+      ok: call("mjwf_valid", h) === 1,
+    };
+    call("mjwf_free", h);
+  }
+  call("mjwf_free", other);
+  console.log(JSON.stringify({
+    bench: "async", mjver, threads: call("mjwf_threads"), meshes: NMESH, vertices: NVERT, runs,
+  }));
+}
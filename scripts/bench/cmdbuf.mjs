@@ -0,0 +1,78 @@
+#!/usr/bin/env node
+// Microbenchmark: per-call cwrap path vs one mjwf_cmdbuf_exec per control tick.
+// Usage: node scripts/bench/cmdbuf.mjs [mjver] [ticks]
+// Requires a bundle built with -DMJWF_HANDLE_API=ON.
+
+import { performance } from "node:perf_hooks";
+import { loadHandleBundle, makeHandle, heapF64, PENDULUM_XML } from "../../tests/handles/_harness.mjs";
+import { CmdBufRunner } from "../../wrappers/js/mjwf_cmdbuf.mjs";
+
+const ticks = Number(process.argv[3] || 20000);
+const ctx = await loadHandleBundle("bench-cmdbuf");
+if (!ctx) process.exit(0);
+const { Module, mjver } = ctx;
+
+const setCtrl = Module.cwrap("mjwf_set_ctrl", null, ["number", "number", "number"]);
+const step = Module.cwrap("mjwf_step", "number", ["number", "number"]);
+const sensPtr = Module.cwrap("mjwf_sensordata_ptr", "number", ["number"]);
+const nsens = Module.cwrap("mjwf_nsensordata", "number", ["number"]);
+const ncon = Module.cwrap("mjwf_ncon", "number", ["number"]);
+const contactPos = Module.cwrap("mjwf_contact_pos_ptr", "number", ["number"]);
+const malloc = Module.cwrap("mjwf_mju_malloc", "number", ["number"]);
+const viewId = (name) => Module.ccall("mjwf_view_id", "number", ["string"], [name]);
+
+const h = makeHandle(Module, PENDULUM_XML);
+const ns = nsens(h);
+const ctrlBuf = malloc(8);
+const sink = new Float64Array(ns);
+
+// Per-call path: set_ctrl -> step -> read sensors -> read contacts.
+const perCall = () => {
+  const t0 = performance.now();
+  for (let i = 0; i < ticks; i += 1) {
+    heapF64(Module, ctrlBuf, 1)[0] = Math.sin(i * 1e-2);
+    setCtrl(h, ctrlBuf, 1);
+    step(h, 1);
+    sink.set(heapF64(Module, sensPtr(h), ns));
+    const n = ncon(h);
+    if (n > 0) sink[0] += heapF64(Module, contactPos(h), n * 3)[0];
+  }
+  return performance.now() - t0;
+};
+
+// Command-buffer path: the same tick as one exec.
+const runner = new CmdBufRunner(Module);
+const CTRL = viewId("ctrl");
+const SENS = viewId("sensordata");
+const ctrlVal = [0];
+const batched = () => {
+  const t0 = performance.now();
+  for (let i = 0; i < ticks; i += 1) {
+    ctrlVal[0] = Math.sin(i * 1e-2);
+    const reply = runner.run(runner.begin().setView(h, CTRL, ctrlVal).step(h, 1).gatherView(h, SENS).gatherContacts(h));
+    sink[0] += reply[2].payload.getFloat64(0, true);
+  }
+  return performance.now() - t0;
+};
+
+Module.ccall("mjwf_reset", "number", ["number"], [h]);
+perCall(); // warm-up
+Module.ccall("mjwf_reset", "number", ["number"], [h]);
+const tCall = perCall();
+Module.ccall("mjwf_reset", "number", ["number"], [h]);
+batched(); // warm-up
+Module.ccall("mjwf_reset", "number", ["number"], [h]);
+const tBuf = batched();
+
+const perTick = (ms) => ((ms * 1e6) / ticks).toFixed(0);
+console.log(JSON.stringify({
+  bench: "cmdbuf",
+  mjver,
+  ticks,
+  per_call_ns_per_tick: Number(perTick(tCall)),
+  cmdbuf_ns_per_tick: Number(perTick(tBuf)),
+  speedup: Number((tCall / tBuf).toFixed(2)),
+}));
+
+runner.dispose();
+Module.ccall("mjwf_free", null, ["number"], [h]);
@@ -0,0 +1,69 @@
+#!/usr/bin/env node
+// Collision checks/sec: set_qpos + mjwf_forward + mjwf_ncon per configuration
+// vs one mjwf_collision_batch call (kinematics + collision only).
+// Usage: node scripts/bench/collide.mjs [mjver] [configs] [threads]
+// Requires a bundle built with -DMJWF_HANDLE_API=ON (threads > 1 needs MJWF_THREADS).
+
+import { performance } from "node:perf_hooks";
+import { loadHandleBundle, makeHandle, heapF64, PENDULUM_XML } from "../../tests/handles/_harness.mjs";
+
+const K = Number(process.argv[3] || 4096);
+const threads = Number(process.argv[4] || 1);
+const ctx = await loadHandleBundle("bench-collide");
+if (!ctx) process.exit(0);
+const { Module, mjver } = ctx;
+const c = (name, ret, args) => Module.cwrap(name, ret, args);
+const malloc = c("mjwf_mju_malloc", "number", ["number"]);
+const setQpos = c("mjwf_set_qpos", null, ["number", "number", "number"]);
+const forward = c("mjwf_forward", "number", ["number"]);
+const ncon = c("mjwf_ncon", "number", ["number"]);
+const collide = c("mjwf_collision_batch", "number",
+  ["number", "number", "number", "number", "number", "number", "number"]);
+
+const h = makeHandle(Module, PENDULUM_XML);
+const usedThreads = Module.ccall("mjwf_set_threads", "number", ["number"], [threads]);
+const nq = Module.ccall("mjwf_nq", "number", ["number"], [h]);
+
+// Random hinge angles and ball positions; roughly half touch the floor or link.
+const qpos = malloc(8 * nq * K);
+const flags = malloc(K);
+const Q = heapF64(Module, qpos, nq * K);
+let seed = 11;
+const rnd = () => ((seed = (seed * 1103515245 + 12345) % 2147483648) / 2147483648);
+for (let k = 0; k < K; k += 1) {
+  Q.set([Math.PI * (2 * rnd() - 1), rnd() - 0.5, rnd() - 0.5, 1.1 * rnd(), 1, 0, 0, 0], nq * k);
+}
+
+const time = (fn, reps = 3) => {
+  fn();
+  const t0 = performance.now();
+  for (let r = 0; r < reps; r += 1) fn();
+  return (performance.now() - t0) / reps;
+};
+let hitsForward = 0;
+const viaForward = () => {
+  hitsForward = 0;
+  for (let k = 0; k < K; k += 1) {
+    setQpos(h, qpos + 8 * nq * k, nq);
+    forward(h);
+    hitsForward += ncon(h) > 0 ? 1 : 0;
+  }
+};
+let hitsBatch = 0;
+const batched = () => { hitsBatch = collide(h, qpos, K, 0, flags, 0, 0); };
+
+const tForward = time(viaForward);
+const tBatch = time(batched);
+const rate = (ms) => Math.round(K / (ms / 1000));
+console.log(JSON.stringify({
+  bench: "collide",
+  mjver,
+  configs: K,
+  threads: usedThreads,
+  colliding: hitsBatch,
+  colliding_forward: hitsForward,
+  forward_checks_per_s: rate(tForward),
+  batch_checks_per_s: rate(tBatch),
+  speedup: Number((tForward / tBatch).toFixed(2)),
+}));
+Module.ccall("mjwf_free", null, ["number"], [h]);
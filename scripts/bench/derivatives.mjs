@@ -0,0 +1,80 @@
+#!/usr/bin/env node
+// Derivatives/sec: per-step mjwf_mjd_transitionFD calls vs mjwf_transition_fd_batch.
+// Usage: node scripts/bench/derivatives.mjs [mjver] [horizon] [threads]
+// Requires a bundle built with -DMJWF_HANDLE_API=ON (threads > 1 needs MJWF_THREADS).
+
+import { performance } from "node:perf_hooks";
+import { loadHandleBundle, makeHandle, PENDULUM_XML } from "../../tests/handles/_harness.mjs";
+
+const STATE_INTEGRATION = 8191;
+const horizon = Number(process.argv[3] || 100);
+const threads = Number(process.argv[4] || 1);
+const ctx = await loadHandleBundle("bench-derivatives");
+if (!ctx) process.exit(0);
+const { Module, mjver } = ctx;
+const c = (name, ret, args) => Module.cwrap(name, ret, args);
+const modelPtr = c("mjwf_model_ptr", "number", ["number"]);
+const dataPtr = c("mjwf_data_ptr", "number", ["number"]);
+const stateSize = c("mjwf_mj_stateSize", "number", ["number", "number"]);
+const getState = c("mjwf_mj_getState", null, ["number", "number", "number", "number"]);
+const setState = c("mjwf_mj_setState", null, ["number", "number", "number", "number"]);
+const transitionFD = c("mjwf_mjd_transitionFD", null,
+  ["number", "number", "number", "number", "number", "number", "number", "number"]);
+const stride = c("mjwf_transition_fd_stride", "number", ["number", "number"]);
+const batch = c("mjwf_transition_fd_batch", "number",
+  ["number", "number", "number", "number", "number", "number", "number", "number"]);
+const malloc = c("mjwf_mju_malloc", "number", ["number"]);
+const step = c("mjwf_step", "number", ["number", "number"]);
+
+const h = makeHandle(Module, PENDULUM_XML);
+const m = modelPtr(h);
+const d = dataPtr(h);
+const nv = Module.ccall("mjwf_nv", "number", ["number"], [h]);
+const nu = Module.ccall("mjwf_nu", "number", ["number"], [h]);
+const ndx = 2 * nv;
+const nstate = stateSize(m, STATE_INTEGRATION);
+const states = malloc(8 * horizon * nstate);
+for (let t = 0; t < horizon; t += 1) {
+  getState(m, d, states + 8 * t * nstate, STATE_INTEGRATION);
+  step(h, 1);
+}
+const S = stride(h, 0);
+const out = malloc(8 * horizon * S);
+const A = malloc(8 * ndx * ndx);
+const B = malloc(8 * ndx * nu);
+const usedThreads = Module.ccall("mjwf_set_threads", "number", ["number"], [threads]);
+
+const reps = 5;
+const perCall = () => {
+  const t0 = performance.now();
+  for (let r = 0; r < reps; r += 1) {
+    for (let t = 0; t < horizon; t += 1) {
+      setState(m, d, states + 8 * t * nstate, STATE_INTEGRATION);
+      transitionFD(m, d, 1e-6, 0, A, B, 0, 0);
+      // JS-side copy into the trajectory tensor, as an iLQR loop would do.
+      Module.HEAP8.copyWithin(out + 8 * t * S, A, A + 8 * ndx * ndx);
+    }
+  }
+  return performance.now() - t0;
+};
+const batched = () => {
+  const t0 = performance.now();
+  for (let r = 0; r < reps; r += 1) batch(h, states, STATE_INTEGRATION, 0, horizon, 1e-6, 0, out);
+  return performance.now() - t0;
+};
+
+perCall();
+batched();
+const tCall = perCall();
+const tBatch = batched();
+const rate = (ms) => Math.round((reps * horizon) / (ms / 1000));
+console.log(JSON.stringify({
+  bench: "derivatives",
+  mjver,
+  horizon,
+  threads: usedThreads,
+  per_call_derivs_per_s: rate(tCall),
+  batch_derivs_per_s: rate(tBatch),
+  speedup: Number((tCall / tBatch).toFixed(2)),
+}));
+Module.ccall("mjwf_free", null, ["number"], [h]);
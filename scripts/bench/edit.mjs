@@ -0,0 +1,93 @@
+#!/usr/bin/env node
+// Edit-to-next-frame latency on a mesh-heavy scene: move one body and get a
+// forward-ed model back, either with mjwf_edit_body + mjwf_recompile (state
+// kept in place) or with a full reload (free, make_from_xml, copy qpos/qvel
+// back, forward).
+// Usage: node scripts/bench/edit.mjs [mjver] [meshes] [verts]
+
+import { performance } from "node:perf_hooks";
+import { loadHandleBundle, heapF64 } from "../../tests/handles/_harness.mjs";
+
+const MESHES = Number(process.argv[3] || 40);
+const VERTS = Number(process.argv[4] || 200);
+const REPS = 5;
+
+// Golden-spiral points on a unit sphere; the compiler builds the hull.
+const sphere = Array.from({ length: VERTS }, (_, i) => {
+  const y = 1 - (2 * (i + 0.5)) / VERTS;
+  const r = Math.sqrt(1 - y * y);
+  const a = i * Math.PI * (3 - Math.sqrt(5));
+  return `${(0.05 * r * Math.cos(a)).toFixed(5)} ${(0.05 * y).toFixed(5)} ${(0.05 * r * Math.sin(a)).toFixed(5)}`;
+}).join(" ");
+const assets = Array.from({ length: MESHES }, (_, i) => `<mesh name="m${i}" vertex="${sphere}" scale="1 1 ${1 + i / MESHES}"/>`);
+const bodies = Array.from({ length: MESHES }, (_, i) =>
+  `<body name="b${i}" pos="${(i % 8) * 0.15} ${Math.floor(i / 8) * 0.15} 0.2"><freejoint/><geom type="mesh" mesh="m${i}"/></body>`);
+const XML = `<mujoco model="meshes">
+  <asset>
+    ${assets.join("\n    ")}
+  </asset>
+  <worldbody>
+    <geom type="plane" size="5 5 0.1"/>
+    ${bodies.join("\n    ")}
+  </worldbody>
+</mujoco>`;
+
+const ctx = await loadHandleBundle("bench-edit");
+if (!ctx) process.exit(0);
+const { Module, mjver } = ctx;
+const c = (name, ret, args) => Module.cwrap(name, ret, args);
+const make = c("mjwf_make_from_xml", "number", ["string"]);
+const makeEditable = c("mjwf_make_editable", "number", ["string"]);
+const freeH = c("mjwf_free", null, ["number"]);
+const step = c("mjwf_step", "number", ["number", "number"]);
+const forward = c("mjwf_forward", "number", ["number"]);
+const editBody = c("mjwf_edit_body", "number", ["number", "string", "number", "number"]);
+const recompile = c("mjwf_recompile", "number", ["number"]);
+const dim = (name, h) => Module.ccall(`mjwf_${name}`, "number", ["number"], [h]);
+const ptr = (name, h, n) => heapF64(Module, Module.ccall(`mjwf_${name}_ptr`, "number", ["number"], [h]), n);
+Module.FS.writeFile("/meshes.xml", XML);
+const median = (xs) => [...xs].sort((a, b) => a - b)[Math.floor(xs.length / 2)];
+
+let t = performance.now();
+const h = makeEditable("/meshes.xml");
+const loadMs = performance.now() - t;
+if (h <= 0) throw new Error(Module.ccall("mjwf_errmsg_last_global", "string", [], []));
+step(h, 100);
+const pos = Module.ccall("mjwf_mju_malloc", "number", ["number"], [24]);
+const inPlace = [];
+for (let r = 0; r < REPS; r += 1) {
+  heapF64(Module, pos, 3).set([0.05 * r, 0, 0.4]);
+  t = performance.now();
+  editBody(h, "b0", pos, 0);
+  if (!recompile(h)) throw new Error(Module.ccall("mjwf_errmsg_last", "string", ["number"], [h]));
+  inPlace.push(performance.now() - t);
+}
+
+let plain = make("/meshes.xml");
+step(plain, 100);
+const reload = [];
+for (let r = 0; r < REPS; r += 1) {
+  t = performance.now();
+  const qpos = Float64Array.from(ptr("qpos", plain, dim("nq", plain)));
+  const qvel = Float64Array.from(ptr("qvel", plain, dim("nv", plain)));
+  freeH(plain);
+  plain = make("/meshes.xml");
+  ptr("qpos", plain, qpos.length).set(qpos);
+  ptr("qvel", plain, qvel.length).set(qvel);
+  forward(plain);
+  reload.push(performance.now() - t);
+}
+
+console.log(JSON.stringify({
+  bench: "edit",
+  mjver,
+  meshes: MESHES,
+  verts_per_mesh: VERTS,
+  initial_load_ms: Number(loadMs.toFixed(2)),
+  recompile_ms: Number(median(inPlace).toFixed(2)),
+  reload_ms: Number(median(reload).toFixed(2)),
+  speedup: Number((median(reload) / median(inPlace)).toFixed(2)),
+}));
+Module.ccall("mjwf_mju_free", null, ["number"], [pos]);
+freeH(plain);
+freeH(h);
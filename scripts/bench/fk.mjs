@@ -0,0 +1,93 @@
+#!/usr/bin/env node
+// Batched FK configs/sec: set_qpos + mjwf_forward per configuration vs
+// mjwf_fk_batch (poses, poses + Jacobians), for every site of a 3-link arm.
+// Usage: node scripts/bench/fk.mjs [mjver] [configs] [threads]
+// Set MJWF_NATIVE_FK_BENCH to a native mjwf_fk_bench3xx binary (configure a
+// host build with -DMJWF_HANDLE_API=ON) to run the same workload natively and
+// report the WASM/native ratio.
+// Requires a bundle built with -DMJWF_HANDLE_API=ON (threads > 1 needs MJWF_THREADS).
+
+import fs from "node:fs";
+import os from "node:os";
+import path from "node:path";
+import { spawnSync } from "node:child_process";
+import { performance } from "node:perf_hooks";
+import { loadHandleBundle, makeHandle, heapF64, ARM_XML } from "../../tests/handles/_harness.mjs";
+
+const OBJ_SITE = 6;
+const FK_JACOBIAN = 1;
+const K = Number(process.argv[3] || 4096);
+const threads = Number(process.argv[4] || 1);
+const ctx = await loadHandleBundle("bench-fk");
+if (!ctx) process.exit(0);
+const { Module, mjver } = ctx;
+const c = (name, ret, args) => Module.cwrap(name, ret, args);
+const malloc = c("mjwf_mju_malloc", "number", ["number"]);
+const setQpos = c("mjwf_set_qpos", null, ["number", "number", "number"]);
+const forward = c("mjwf_forward", "number", ["number"]);
+const stride = c("mjwf_fk_stride", "number", ["number", "number"]);
+const fk = c("mjwf_fk_batch", "number",
+  ["number", "number", "number", "number", "number", "number", "number"]);
+
+const h = makeHandle(Module, ARM_XML);
+const usedThreads = Module.ccall("mjwf_set_threads", "number", ["number"], [threads]);
+const nq = Module.ccall("mjwf_nq", "number", ["number"], [h]);
+const sites = ["s1", "s2", "ee"].map((name) =>
+  Module.ccall("mjwf_name2id", "number", ["number", "number", "string"], [h, OBJ_SITE, name]));
+const nsite = sites.length;
+
+const objs = malloc(4 * 2 * nsite);
+const O = new Int32Array(Module.HEAP8.buffer, objs, 2 * nsite);
+sites.forEach((id, i) => O.set([OBJ_SITE, id], 2 * i));
+
+// Same generator as native_fk_bench.cpp: qpos0 (zero for the arm) + U(-1, 1).
+const qpos = malloc(8 * nq * K);
+const Q = heapF64(Module, qpos, nq * K);
+let seed = 11;
+for (let i = 0; i < nq * K; i += 1) {
+  seed = (Math.imul(seed, 1103515245) + 12345) >>> 0;
+  Q[i] = 2 * ((seed >>> 8) / 16777216) - 1;
+}
+const out = malloc(8 * K * nsite * stride(h, FK_JACOBIAN));
+
+const time = (fn, reps = 3) => {
+  fn();
+  const t0 = performance.now();
+  for (let r = 0; r < reps; r += 1) fn();
+  return (performance.now() - t0) / reps;
+};
+const viaForward = () => {
+  for (let k = 0; k < K; k += 1) {
+    setQpos(h, qpos + 8 * nq * k, nq);
+    forward(h);
+  }
+};
+const tForward = time(viaForward);
+const tPose = time(() => fk(h, qpos, K, objs, nsite, 0, out));
+const tJac = time(() => fk(h, qpos, K, objs, nsite, FK_JACOBIAN, out));
+const rate = (ms) => Math.round(K / (ms / 1000));
+const result = {
+  bench: "fk",
+  runtime: "wasm",
+  mjver,
+  configs: K,
+  objects: nsite,
+  threads: usedThreads,
+  forward_configs_per_s: rate(tForward),
+  batch_configs_per_s: rate(tPose),
+  batch_jac_configs_per_s: rate(tJac),
+};
+
+const nativeBin = process.env.MJWF_NATIVE_FK_BENCH;
+if (nativeBin) {
+  const xml = path.join(os.tmpdir(), `mjwf_fk_arm_${process.pid}.xml`);
+  fs.writeFileSync(xml, ARM_XML);
+  const run = spawnSync(nativeBin, [xml, String(K), String(threads)], { encoding: "utf8" });
+  fs.rmSync(xml, { force: true });
+  if (run.status !== 0) throw new Error(`native bench failed: ${run.stderr}`);
+  const native = JSON.parse(run.stdout.trim().split("\n").pop());
+  result.native = native;
+  result.wasm_over_native = Number((result.batch_configs_per_s / native.batch_configs_per_s).toFixed(3));
+}
+console.log(JSON.stringify(result));
+Module.ccall("mjwf_free", null, ["number"], [h]);
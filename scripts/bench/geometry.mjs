@@ -0,0 +1,86 @@
+#!/usr/bin/env node
+// Time for a renderer to get at every mesh's vertices/faces on a mesh-heavy
+// scene: one mjwf_geometry_manifest call plus zero-copy subarray views, vs
+// querying the adr/num views per mesh and copying each mesh's arrays out.
+// Usage: node scripts/bench/geometry.mjs [mjver] [meshes] [verts]
+
+import { performance } from "node:perf_hooks";
+import { loadHandleBundle, makeHandle } from "../../tests/handles/_harness.mjs";
+
+const MESHES = Number(process.argv[3] || 200);
+const VERTS = Number(process.argv[4] || 500);
+const REPS = 20;
+
+const sphere = Array.from({ length: VERTS }, (_, i) => {
+  const y = 1 - (2 * (i + 0.5)) / VERTS;
+  const r = Math.sqrt(1 - y * y);
+  const a = i * Math.PI * (3 - Math.sqrt(5));
+  return `${(0.05 * r * Math.cos(a)).toFixed(5)} ${(0.05 * y).toFixed(5)} ${(0.05 * r * Math.sin(a)).toFixed(5)}`;
+}).join(" ");
+const assets = Array.from({ length: MESHES }, (_, i) => `<mesh name="m${i}" vertex="${sphere}" scale="1 1 ${1 + i / MESHES}"/>`);
+const geoms = Array.from({ length: MESHES }, (_, i) =>
+  `<geom type="mesh" mesh="m${i}" pos="${(i % 16) * 0.15} ${Math.floor(i / 16) * 0.15} 0.1"/>`);
+const XML = `<mujoco model="meshes"><asset>${assets.join("")}</asset><worldbody>${geoms.join("")}</worldbody></mujoco>`;
+
+const ctx = await loadHandleBundle("bench-geometry");
+if (!ctx) process.exit(0);
+const { Module, mjver } = ctx;
+const h = makeHandle(Module, XML);
+const call = (name, ...args) => Module.ccall(name, "number", args.map(() => "number"), args);
+const median = (xs) => [...xs].sort((a, b) => a - b)[Math.floor(xs.length / 2)];
+const size = call("mjwf_geometry_manifest_size", h);
+const buf = Module.ccall("mjwf_mju_malloc", "number", ["number"], [size]);
+
+const viaManifest = () => {
+  call("mjwf_geometry_manifest", h, buf, size);
+  const heap = Module.HEAP8.buffer;
+  const dv = new DataView(heap, buf, size);
+  const nmesh = dv.getInt32(4, true);
+  const table = new Int32Array(heap, buf + dv.getInt32(28, true), 6 * nmesh);
+  const vert = new Float32Array(heap, Number(dv.getBigUint64(40, true)), 3 * dv.getInt32(12, true));
+  const face = new Int32Array(heap, Number(dv.getBigUint64(56, true)), 3 * dv.getInt32(20, true));
+  const out = [];
+  for (let i = 0; i < nmesh; i += 1) {
+    const r = 6 * i;
+    out.push([vert.subarray(3 * table[r], 3 * (table[r] + table[r + 1])),
+      face.subarray(3 * table[r + 2], 3 * (table[r + 2] + table[r + 3]))]);
+  }
+  return out;
+};
+
+const perMesh = () => {
+  const nmesh = call("mjwf_nmesh", h);
+  const out = [];
+  for (let i = 0; i < nmesh; i += 1) {
+    const at = (name) => new Int32Array(Module.HEAP8.buffer, call(`mjwf_mesh_${name}_ptr`, h), nmesh)[i];
+    const va = at("vertadr"), vn = at("vertnum"), fa = at("faceadr"), fn = at("facenum");
+    out.push([new Float32Array(Module.HEAP8.buffer, call("mjwf_mesh_vert_ptr", h) + 12 * va, 3 * vn).slice(),
+      new Int32Array(Module.HEAP8.buffer, call("mjwf_mesh_face_ptr", h) + 12 * fa, 3 * fn).slice()]);
+  }
+  return out;
+};
+
+const time = (fn) => {
+  const ts = [];
+  for (let r = 0; r < REPS; r += 1) {
+    const t = performance.now();
+    fn();
+    ts.push(performance.now() - t);
+  }
+  return median(ts);
+};
+const manifestMs = time(viaManifest);
+const perMeshMs = time(perMesh);
+
+console.log(JSON.stringify({
+  bench: "geometry",
+  mjver,
+  meshes: MESHES,
+  verts_per_mesh: VERTS,
+  manifest_ms: Number(manifestMs.toFixed(3)),
+  per_mesh_copy_ms: Number(perMeshMs.toFixed(3)),
+  copied_bytes: perMesh().reduce((s, [v, f]) => s + v.byteLength + f.byteLength, 0),
+  speedup: Number((perMeshMs / manifestMs).toFixed(2)),
+}));
+Module.ccall("mjwf_mju_free", null, ["number"], [buf]);
+Module.ccall("mjwf_free", null, ["number"], [h]);
@@ -0,0 +1,82 @@
+#!/usr/bin/env node
+// Idle-handle hibernation on a viewer-server workload: N humanoid handles
+// sharing one model, of which a few are stepped every frame while one idle
+// handle per frame is visited (read), as a client opening a viewer would. With
+// hibernation the server trims to a budget of the active set after each frame.
+// Reports resident handle memory against the live handle count, frame time
+// and the wake cost, with and without hibernation.
+// Usage: node scripts/bench/hibernate.mjs [mjver] [max handles] [frames]
+// The default bundle holds 63 handles (MJWF_MAXH).
+
+import { performance } from "node:perf_hooks";
+import { loadHandleBundle, makeHandle, heapF64, HUMANOID_XML } from "../../tests/handles/_harness.mjs";
+
+const MAX = Number(process.argv[3] || 63);
+const FRAMES = Number(process.argv[4] || 200);
+const ACTIVE = 4;
+const STEPS = 10;  // per active handle and frame
+const RES_LIVE = 0;
+const RES_DATA = 3;
+const RES_BLOB = 4;
+const RES_SPARE = 5;
+const RES_WAKES = 7;
+const RES_NSTAT = 8;
+const HEAP_MEMORY = 0;
+const HEAP_NSTAT = 5;
+
+const ctx = await loadHandleBundle("bench-hibernate", process.argv[2] || process.env.MJVER || "3.3.7");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const call = (name, ...args) => Module.ccall(name, "number", args.map(() => "number"), args);
+  const out = call("mjwf_mju_malloc", 8 * Math.max(RES_NSTAT, HEAP_NSTAT));
+  const resident = () => {
+    call("mjwf_resident_stats", out);
+    return Array.from(heapF64(Module, out, RES_NSTAT));
+  };
+  const heap = () => {
+    call("mjwf_heap_stats", out);
+    return heapF64(Module, out, HEAP_NSTAT)[HEAP_MEMORY];
+  };
+
+  const runs = [];
+  for (const live of [8, 16, 32, MAX].filter((n, i, a) => n <= MAX && a.indexOf(n) === i)) {
+    for (const hibernate of [false, true]) {
+      const base = makeHandle(Module, HUMANOID_XML, "/humanoid.xml");
+      const handles = [base];
+      while (handles.length < live) handles.push(call("mjwf_make_shared", base));
+      const per = resident()[RES_DATA] / live;
+      if (hibernate) call("mjwf_hibernate_budget", (ACTIVE + 1) * per);
+      const wakes0 = resident()[RES_WAKES];
+
+      let visitUs = 0;
+      const t0 = performance.now();
+      for (let f = 0; f < FRAMES; f += 1) {
+        for (let k = 0; k < ACTIVE; k += 1) call("mjwf_step", handles[k], STEPS);
+        const idle = handles[ACTIVE + (f % (live - ACTIVE))];
+        const tv = performance.now();
+        call("mjwf_qpos_ptr", idle);
+        visitUs += (performance.now() - tv) * 1000;
+        if (hibernate) call("mjwf_hibernate_trim");
+      }
+      const frameUs = (performance.now() - t0) * 1000 / FRAMES;
+
+      const r = resident();
+      runs.push({
+        live,
+        hibernate,
+        resident_bytes: r[RES_DATA] + r[RES_SPARE],
+        blob_bytes: r[RES_BLOB],
+        bytes_per_live_handle: Math.round((r[RES_DATA] + r[RES_SPARE] + r[RES_BLOB]) / r[RES_LIVE]),
+        heap_bytes: heap(),
+        frame_us: +frameUs.toFixed(1),
+        visit_us: +(visitUs / FRAMES).toFixed(2),
+        wakes: r[RES_WAKES] - wakes0,
+      });
+      call("mjwf_hibernate_budget", 0);
+      for (const h of handles.slice(1)) call("mjwf_free", h);
+      call("mjwf_free", base);
+    }
+  }
+  call("mjwf_mju_free", out);
+  console.log(JSON.stringify({ bench: "hibernate", mjver, frames: FRAMES, active: ACTIVE, steps: STEPS, runs }));
+}
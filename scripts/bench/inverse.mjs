@@ -0,0 +1,77 @@
+#!/usr/bin/env node
+// Inverse dynamics frames/sec: per-frame qpos/qvel/qacc writes + mjwf_mj_inverse
+// vs one mjwf_inverse_batch call over the whole trajectory.
+// Usage: node scripts/bench/inverse.mjs [mjver] [frames] [threads]
+// Requires a bundle built with -DMJWF_HANDLE_API=ON (threads > 1 needs MJWF_THREADS).
+
+import { performance } from "node:perf_hooks";
+import { loadHandleBundle, makeHandle, heapF64, PENDULUM_XML } from "../../tests/handles/_harness.mjs";
+
+const T = Number(process.argv[3] || 10000);
+const threads = Number(process.argv[4] || 1);
+const ctx = await loadHandleBundle("bench-inverse");
+if (!ctx) process.exit(0);
+const { Module, mjver } = ctx;
+const c = (name, ret, args) => Module.cwrap(name, ret, args);
+const malloc = c("mjwf_mju_malloc", "number", ["number"]);
+const inverse = c("mjwf_mj_inverse", null, ["number", "number"]);
+const inverseBatch = c("mjwf_inverse_batch", "number",
+  ["number", "number", "number", "number", "number", "number", "number"]);
+const ptr = (name) => Module.ccall(`mjwf_${name}_ptr`, "number", ["number"], [h]);
+
+const h = makeHandle(Module, PENDULUM_XML);
+const usedThreads = Module.ccall("mjwf_set_threads", "number", ["number"], [threads]);
+const nq = Module.ccall("mjwf_nq", "number", ["number"], [h]);
+const nv = Module.ccall("mjwf_nv", "number", ["number"], [h]);
+const m = Module.ccall("mjwf_model_ptr", "number", ["number"], [h]);
+const d = Module.ccall("mjwf_data_ptr", "number", ["number"], [h]);
+
+const qpos = malloc(8 * nq * T);
+const qvel = malloc(8 * nv * T);
+const qacc = malloc(8 * nv * T);
+const tau = malloc(8 * nv * T);
+const Q = heapF64(Module, qpos, nq * T);
+const V = heapF64(Module, qvel, nv * T);
+const A = heapF64(Module, qacc, nv * T);
+const q0 = Array.from(heapF64(Module, ptr("qpos"), nq));
+for (let t = 0; t < T; t += 1) {
+  Q.set(q0, nq * t);
+  Q[nq * t] = Math.sin(0.01 * t);
+  V[nv * t] = Math.cos(0.01 * t);
+  A[nv * t] = -Math.sin(0.01 * t);
+}
+
+const time = (fn, reps = 3) => {
+  fn();
+  const t0 = performance.now();
+  for (let r = 0; r < reps; r += 1) fn();
+  return (performance.now() - t0) / reps;
+};
+const perFrame = () => {
+  const P = heapF64(Module, ptr("qpos"), nq);
+  const Vd = heapF64(Module, ptr("qvel"), nv);
+  const Ad = heapF64(Module, ptr("qacc"), nv);
+  const F = heapF64(Module, tau, nv * T);
+  for (let t = 0; t < T; t += 1) {
+    P.set(Q.subarray(nq * t, nq * (t + 1)));
+    Vd.set(V.subarray(nv * t, nv * (t + 1)));
+    Ad.set(A.subarray(nv * t, nv * (t + 1)));
+    inverse(m, d);
+    F.set(heapF64(Module, ptr("qfrc_inverse"), nv), nv * t);
+  }
+};
+const batched = () => inverseBatch(h, qpos, qvel, qacc, T, tau, 0);
+
+const tFrame = time(perFrame);
+const tBatch = time(batched);
+const rate = (ms) => Math.round(T / (ms / 1000));
+console.log(JSON.stringify({
+  bench: "inverse",
+  mjver,
+  frames: T,
+  threads: usedThreads,
+  per_frame_fps: rate(tFrame),
+  batch_fps: rate(tBatch),
+  speedup: Number((tFrame / tBatch).toFixed(2)),
+}));
+Module.ccall("mjwf_free", null, ["number"], [h]);
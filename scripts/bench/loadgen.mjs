@@ -0,0 +1,87 @@
+#!/usr/bin/env node
+// Single-threaded counterpart of the native mjwf_loadgen337: one pool of
+// handles driven through a weighted create/step/read/free mix for a fixed
+// time, with throughput and latency percentiles per operation in the same
+// JSON keys. Defaults to the pendulum; pass a model path to load another.
+// Usage: node scripts/bench/loadgen.mjs [mjver] [seconds] [handles]
+//                                       [mix=create:1,step:40,read:20,free:1] [model.xml]
+
+import fs from "node:fs";
+import { performance } from "node:perf_hooks";
+import { loadHandleBundle, makeHandle, heapF64, PENDULUM_XML } from "../../tests/handles/_harness.mjs";
+
+const SECONDS = Number(process.argv[3] || 5);
+const HANDLES = Number(process.argv[4] || 256);
+const MIX = process.argv[5] || "create:1,step:40,read:20,free:1";
+const MODEL = process.argv[6];
+const OPS = ["create", "step", "read", "free"];
+
+const weight = Object.fromEntries(OPS.map((op) => [op, 0]));
+for (const item of MIX.split(",")) {
+  const [op, w] = item.split(":");
+  if (!(op in weight)) throw new Error(`unknown op in mix: ${op}`);
+  weight[op] = Number(w);
+}
+const total = OPS.reduce((s, op) => s + weight[op], 0);
+
+const ctx = await loadHandleBundle("bench-loadgen");
+if (!ctx) process.exit(0);
+const { Module, mjver } = ctx;
+const xml = MODEL ? fs.readFileSync(MODEL, "utf8") : PENDULUM_XML;
+const file = "/loadgen.xml";
+const step = Module.cwrap("mjwf_step", "number", ["number", "number"]);
+const free = Module.cwrap("mjwf_free", null, ["number"]);
+const make = Module.cwrap("mjwf_make_from_xml", "number", ["string"]);
+const dim = Object.fromEntries(["nq", "nv", "nu", "nsensordata"].map((n) => [n, Module.cwrap(`mjwf_${n}`, "number", ["number"])]));
+const ptr = Object.fromEntries(["qpos", "qvel", "ctrl", "sensordata"].map((n) => [n, Module.cwrap(`mjwf_${n}_ptr`, "number", ["number"])]));
+
+const live = [makeHandle(Module, xml, file)];
+while (live.length < HANDLES / 2) live.push(make(file));
+const lat = Object.fromEntries(OPS.map((op) => [op, []]));
+let failures = 0;
+
+const end = performance.now() + SECONDS * 1000;
+while (performance.now() < end) {
+  let pick = Math.random() * total;
+  let op = OPS.find((o) => (pick -= weight[o]) < 0) || "step";
+  if (live.length === 0) op = "create";
+  if (op === "create" && live.length >= HANDLES) op = "free";
+  const idx = Math.floor(Math.random() * live.length);
+
+  const t0 = performance.now();
+  let ok = true;
+  if (op === "create") {
+    const h = make(file);
+    ok = h > 0;
+    if (ok) live.push(h);
+  } else if (op === "step") {
+    const h = live[idx];
+    const ctrl = heapF64(Module, ptr.ctrl(h), dim.nu(h));
+    for (let i = 0; i < ctrl.length; i += 1) ctrl[i] = Math.random() * 2 - 1;
+    ok = step(h, 1) === 1;
+  } else if (op === "read") {
+    const h = live[idx];
+    heapF64(Module, ptr.qpos(h), dim.nq(h)).slice();
+    heapF64(Module, ptr.qvel(h), dim.nv(h)).slice();
+    heapF64(Module, ptr.sensordata(h), dim.nsensordata(h)).slice();
+  } else {
+    free(live[idx]);
+    live[idx] = live[live.length - 1];
+    live.pop();
+  }
+  const us = (performance.now() - t0) * 1000;
+  if (ok) lat[op].push(us);
+  else failures += 1;
+}
+
+const out = { bench: "loadgen", runtime: "wasm", mjver, threads: 1, seconds: SECONDS, handles_per_thread: HANDLES, steps_per_op: 1 };
+for (const op of OPS) {
+  const s = lat[op].sort((a, b) => a - b);
+  const q = (p) => (s.length ? Number(s[Math.round(p * (s.length - 1))].toFixed(2)) : 0);
+  out[op] = { ops: s.length, per_s: Math.round(s.length / SECONDS), p50_us: q(0.5), p99_us: q(0.99), p999_us: q(0.999), max_us: q(1) };
+}
+out.steps_per_s = out.step.per_s;
+out.live_handles = live.length;
+out.failures = failures;
+for (const h of live) free(h);
+console.log(JSON.stringify(out));
@@ -0,0 +1,92 @@
+#!/usr/bin/env node
+// wasm32 vs wasm64 (-DMJWF_MEMORY64=ON) bundles on an actuated humanoid:
+// vector-env step cost per env at several env counts, and how many envs fit
+// before allocation fails (or MAX_ENVS is reached), with the heap size then.
+// Usage: node scripts/bench/memory64.mjs [dist dirs, comma separated] [steps] [max envs]
+// e.g.   node scripts/bench/memory64.mjs 3.3.7,3.3.7-wasm64 200 65536
+// wasm64 needs Node 24+ (Node 22: --experimental-wasm-memory64).
+
+import { performance } from "node:perf_hooks";
+import { loadHandleBundle, makeHandle, heapF64, pointerBytes, HUMANOID_XML } from "../../tests/handles/_harness.mjs";
+import { VecEnv } from "../../wrappers/js/mjwf_vecenv.mjs";
+
+const DIRS = (process.argv[2] || "3.3.7,3.3.7-wasm64").split(",");
+const STEPS = Number(process.argv[3] || 200);
+const MAX_ENVS = Number(process.argv[4] || 65536);
+const COUNTS = [16, 128, 1024];
+const CHUNK = 1024;   // envs per vector env while filling memory
+const HEAP_MEMORY = 0;
+const HEAP_NSTAT = 5;
+
+const motors = [...HUMANOID_XML.matchAll(/joint name="(\w+)" type="hinge"/g)].map((m) => `<motor joint="${m[1]}"/>`);
+const XML = HUMANOID_XML.replace("</mujoco>", `<actuator>${motors.join("")}</actuator></mujoco>`);
+
+const runs = [];
+for (const dir of DIRS) {
+  const ctx = await loadHandleBundle(`bench-memory64 ${dir}`, dir);
+  if (!ctx) continue;
+  const { Module } = ctx;
+  const call = (name, ...args) => Module.ccall(name, "number", args.map(() => "number"), args);
+  const heapBytes = () => {
+    const stats = Module.ccall("mjwf_mju_malloc", "pointer", ["pointer"], [8 * HEAP_NSTAT]);
+    call("mjwf_heap_stats", stats);
+    const bytes = heapF64(Module, stats, HEAP_NSTAT)[HEAP_MEMORY];
+    Module.ccall("mjwf_mju_free", null, ["pointer"], [stats]);
+    return bytes;
+  };
+  const h = makeHandle(Module, XML, "/humanoid.xml");
+
+  // Step cost per env: random actions held for the run, fixed seed.
+  const stepNs = {};
+  for (const n of COUNTS) {
+    const env = new VecEnv(Module, h, n, "proprio");
+    env.seed(1);
+    env.setTimeLimit(1);
+    env.reset();
+    const A = env.actions;
+    for (let i = 0; i < A.length; i += 1) A[i] = Math.sin(i);
+    for (let i = 0; i < 10; i += 1) env.step();
+    const t0 = performance.now();
+    for (let i = 0; i < STEPS; i += 1) env.step();
+    stepNs[n] = Math.round((performance.now() - t0) * 1e6 / (STEPS * n));
+    env.dispose();
+  }
+
+  // Capacity: vector envs of CHUNK envs until one fails, then halve the chunk.
+  const envs = [];
+  let total = 0;
+  for (let chunk = CHUNK; chunk >= 16 && total < MAX_ENVS;) {
+    const e = call("mjwf_vecenv_create", h, Math.min(chunk, MAX_ENVS - total), 0);
+    if (e) {
+      envs.push(e);
+      total += call("mjwf_vecenv_size", e);
+    } else {
+      chunk >>= 1;
+    }
+  }
+  const limit = total >= MAX_ENVS ? "max_envs" : call("mjwf_errno_last", h) === 102 ? "vecenv_slots" : "memory";
+  const heap = heapBytes();
+  for (const e of envs) call("mjwf_vecenv_free", e);
+  call("mjwf_free", h);
+
+  runs.push({
+    dist: dir,
+    pointer_bytes: pointerBytes(Module),
+    step_ns_per_env: stepNs,
+    max_envs: total,
+    limit,
+    heap_bytes: heap,
+    bytes_per_env: Math.round(heap / Math.max(1, total)),
+  });
+}
+
+const [a, b] = runs;
+console.log(JSON.stringify({
+  bench: "memory64",
+  steps: STEPS,
+  runs,
+  ...(a && b ? {
+    step_cost_ratio: Object.fromEntries(COUNTS.map((n) => [n, +(b.step_ns_per_env[n] / a.step_ns_per_env[n]).toFixed(3)])),
+    env_count_ratio: +(b.max_envs / Math.max(1, a.max_envs)).toFixed(2),
+  } : {}),
+}));
@@ -0,0 +1,58 @@
+#!/usr/bin/env node
+// Domain randomization memory: N shared handles with friction/mass/damping
+// overlays vs N full model loads, plus steps/sec for both setups.
+// Usage: node scripts/bench/overlay.mjs [mjver] [envs]
+// Requires a bundle built with -DMJWF_HANDLE_API=ON. envs is capped by the
+// handle pool (MJWF_MAXH - 1 handles, counting the base).
+
+import { performance } from "node:perf_hooks";
+import { loadHandleBundle, makeHandle, PENDULUM_XML } from "../../tests/handles/_harness.mjs";
+
+const SAMPLE_SCALE = 0;
+const N = Math.min(Number(process.argv[3] || 32), 31);
+const ctx = await loadHandleBundle("bench-overlay");
+if (!ctx) process.exit(0);
+const { Module, mjver } = ctx;
+const c = (name, ret, args) => Module.cwrap(name, ret, args);
+const malloc = c("mjwf_mju_malloc", "number", ["number"]);
+const step = c("mjwf_step", "number", ["number", "number"]);
+const sample = c("mjwf_overlay_sample", "number",
+  ["number", "number", "number", "number", "number", "number", "number", "number", "number"]);
+const privateBytes = c("mjwf_model_private_bytes", "number", ["number"]);
+const fullBytes = c("mjwf_model_full_bytes", "number", ["number"]);
+const viewId = (name) => Module.ccall("mjwf_view_id", "number", ["string"], [name]);
+
+const base = makeHandle(Module, PENDULUM_XML);
+const shared = Array.from({ length: N }, () => Module.ccall("mjwf_make_shared", "number", ["number"], [base]));
+const hs = malloc(4 * N);
+new Int32Array(Module.HEAP8.buffer, hs, N).set(shared);
+const t0 = performance.now();
+["geom_friction", "body_mass", "dof_damping"].forEach((v, i) => sample(hs, N, viewId(v), 0, -1, SAMPLE_SCALE, 0.8, 1.2, i));
+const tSample = performance.now() - t0;
+const full = Array.from({ length: N }, (_, i) => makeHandle(Module, PENDULUM_XML, `/overlay_full_${i}.xml`));
+
+const time = (hsList, reps = 3) => {
+  const run = () => hsList.forEach((h) => step(h, 100));
+  run();
+  const t = performance.now();
+  for (let r = 0; r < reps; r += 1) run();
+  return (performance.now() - t) / reps;
+};
+const tShared = time(shared);
+const tFull = time(full);
+const sum = (hsList, fn) => hsList.reduce((a, h) => a + fn(h), 0);
+const perEnvShared = sum(shared, privateBytes) / N;
+const perEnvFull = sum(full, fullBytes) / N;
+console.log(JSON.stringify({
+  bench: "overlay",
+  mjver,
+  envs: N,
+  base_model_bytes: fullBytes(base),
+  per_env_model_bytes_shared: Math.round(perEnvShared),
+  per_env_model_bytes_full: Math.round(perEnvFull),
+  memory_ratio: Number((perEnvShared / perEnvFull).toFixed(3)),
+  sample_3_views_ms: Number(tSample.toFixed(3)),
+  shared_steps_per_s: Math.round((N * 100) / (tShared / 1000)),
+  full_steps_per_s: Math.round((N * 100) / (tFull / 1000)),
+}));
+[...shared, ...full, base].forEach((h) => Module.ccall("mjwf_free", null, ["number"], [h]));
@@ -0,0 +1,74 @@
+#!/usr/bin/env node
+// Frame jank with and without wall-clock pacing on a contact-heavy pile of
+// boxes: a 60 Hz frame loop either steps a fixed frame's worth of physics
+// (mjwf_step) or calls mjwf_step_for_budget with an 8 ms budget (Pacer).
+// Reports per-frame physics time percentiles, frames over 16.7 ms, and how
+// fast simulated time advanced relative to wall time.
+// Usage: node scripts/bench/pacing.mjs [mjver] [boxes] [frames]
+
+import { performance } from "node:perf_hooks";
+import { loadHandleBundle, makeHandle } from "../../tests/handles/_harness.mjs";
+import { Pacer } from "../../wrappers/js/mjwf_pacer.mjs";
+
+const BOXES = Number(process.argv[3] || 150);
+const FRAMES = Number(process.argv[4] || 300);
+const FRAME_MS = 1000 / 60;
+
+const boxes = Array.from({ length: BOXES }, (_, i) => {
+  const x = ((i % 5) - 2) * 0.09;
+  const y = ((Math.floor(i / 5) % 5) - 2) * 0.09;
+  const z = 0.05 + 0.1 * Math.floor(i / 25);
+  return `<body pos="${x} ${y} ${z}"><freejoint/><geom type="box" size="0.04 0.04 0.04"/></body>`;
+}).join("\n    ");
+const PILE_XML = `<mujoco model="pile">
+  <option timestep="0.002"/>
+  <worldbody>
+    <geom type="plane" size="5 5 0.1"/>
+    ${boxes}
+  </worldbody>
+</mujoco>`;
+
+const ctx = await loadHandleBundle("bench-pacing");
+if (!ctx) process.exit(0);
+const { Module, mjver } = ctx;
+const step = Module.cwrap("mjwf_step", "number", ["number", "number"]);
+const time = Module.cwrap("mjwf_time", "number", ["number"]);
+
+const summarize = (frameMs, sim, wallMs) => {
+  const s = [...frameMs].sort((a, b) => a - b);
+  const q = (p) => Number(s[Math.min(s.length - 1, Math.floor(p * s.length))].toFixed(3));
+  return {
+    p50_ms: q(0.5),
+    p95_ms: q(0.95),
+    p99_ms: q(0.99),
+    max_ms: q(1),
+    frames_over_16ms: frameMs.filter((t) => t > FRAME_MS).length,
+    sim_over_wall: Number((sim / (wallMs / 1000)).toFixed(3)),
+  };
+};
+
+const run = (frameFn) => {
+  const h = makeHandle(Module, PILE_XML, "/pile.xml");
+  step(h, 50); // let the pile start settling into contact
+  const sim0 = time(h);
+  const frameMs = [];
+  const start = performance.now();
+  for (let f = 0; f < FRAMES; f += 1) {
+    const t = performance.now();
+    frameFn(h, t);
+    frameMs.push(performance.now() - t);
+  }
+  const out = summarize(frameMs, time(h) - sim0, performance.now() - start);
+  Module.ccall("mjwf_free", null, ["number"], [h]);
+  return out;
+};
+
+const perFrame = Math.round(FRAME_MS / 1000 / 0.002);
+const fixed = run((h) => step(h, perFrame));
+let pacer = null;
+const paced = run((h, t) => {
+  if (!pacer || pacer.handle !== h) pacer = new Pacer(Module, h, { budgetMs: 8 });
+  pacer.frame(t);
+});
+pacer.dispose();
+console.log(JSON.stringify({ bench: "pacing", mjver, boxes: BOXES, frames: FRAMES, steps_per_frame: perFrame, fixed, paced }));
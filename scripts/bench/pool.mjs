@@ -0,0 +1,64 @@
+#!/usr/bin/env node
+// MjwfPool startup and aggregate throughput for 1..N workers: time until all
+// workers are ready when the module is compiled once and shared vs compiled
+// in every worker, and steps/sec of stepAll over handles_per_worker actuated
+// humanoids per worker.
+// Usage: node scripts/bench/pool.mjs [mjver] [max workers] [handles per worker] [seconds]
+
+import os from "node:os";
+import path from "node:path";
+import { performance } from "node:perf_hooks";
+import { pathToFileURL } from "node:url";
+import { loadHandleBundle, rootDir, HUMANOID_XML } from "../../tests/handles/_harness.mjs";
+import { MjwfPool } from "../../wrappers/js/mjwf_pool.mjs";
+
+const MAX_WORKERS = Number(process.argv[3] || os.availableParallelism?.() || os.cpus().length);
+const PER_WORKER = Number(process.argv[4] || 8);
+const SECONDS = Number(process.argv[5] || 2);
+const STEPS_PER_CALL = 10;
+
+const ctx = await loadHandleBundle("bench-pool");
+if (!ctx) process.exit(0);
+const { mjver } = ctx;
+const dist = path.join(rootDir, "dist", mjver);
+const urls = {
+  jsURL: pathToFileURL(path.join(dist, "mujoco.js")),
+  wasmURL: pathToFileURL(path.join(dist, "mujoco.wasm")),
+};
+const motors = [...HUMANOID_XML.matchAll(/joint name="(\w+)" type="hinge"/g)].map((m) => `<motor joint="${m[1]}"/>`);
+const XML = HUMANOID_XML.replace("</mujoco>", `<actuator>${motors.join("")}</actuator></mujoco>`);
+
+const counts = [];
+for (let w = 1; w < MAX_WORKERS; w *= 2) counts.push(w);
+counts.push(MAX_WORKERS);
+
+const runs = [];
+for (const workers of counts) {
+  const separate = await MjwfPool.create({ workers, ...urls, shareModule: false });
+  const separateMs = separate.startup.readyMs;
+  await separate.close();
+
+  const pool = await MjwfPool.create({ workers, ...urls });
+  const ids = await Promise.all(Array.from({ length: workers * PER_WORKER }, () => pool.createHandle(XML)));
+  await Promise.all(ids.map((id, i) => pool.write(id, "ctrl", Array.from({ length: motors.length }, (_, j) => Math.sin(i + j)))));
+  await pool.stepAll(STEPS_PER_CALL);
+  let steps = 0;
+  const t0 = performance.now();
+  while (performance.now() - t0 < SECONDS * 1000) steps += await pool.stepAll(STEPS_PER_CALL);
+  const stepsPerS = steps / ((performance.now() - t0) / 1000);
+  runs.push({
+    workers,
+    startup_ms: { shared: Math.round(pool.startup.readyMs), compile: Math.round(pool.startup.compileMs), per_worker_compile: Math.round(separateMs) },
+    handles: ids.length,
+    steps_per_s: Math.round(stepsPerS),
+  });
+  await pool.close();
+}
+
+const base = runs[0].steps_per_s;
+console.log(JSON.stringify({
+  bench: "pool",
+  mjver,
+  handles_per_worker: PER_WORKER,
+  runs: runs.map((r) => ({ ...r, speedup: +(r.steps_per_s / base).toFixed(2) })),
+}));
@@ -0,0 +1,77 @@
+#!/usr/bin/env node
+// Rays/sec: per-beam mjwf_mj_ray calls vs mjwf_ray_batch vs mjwf_ray_scan.
+// Usage: node scripts/bench/rays.mjs [mjver] [beams] [threads]
+// Requires a bundle built with -DMJWF_HANDLE_API=ON (threads > 1 needs MJWF_THREADS).
+
+import { performance } from "node:perf_hooks";
+import { loadHandleBundle, makeHandle, heapF64, PENDULUM_XML } from "../../tests/handles/_harness.mjs";
+
+const OBJ_SITE = 6;
+const beams = Number(process.argv[3] || 32768);
+const threads = Number(process.argv[4] || 1);
+const ctx = await loadHandleBundle("bench-rays");
+if (!ctx) process.exit(0);
+const { Module, mjver } = ctx;
+const c = (name, ret, args) => Module.cwrap(name, ret, args);
+const malloc = c("mjwf_mju_malloc", "number", ["number"]);
+const ray = c("mjwf_mj_ray", "number",
+  ["number", "number", "number", "number", "number", "number", "number", "number"]);
+const rayBatch = c("mjwf_ray_batch", "number",
+  ["number", "number", "number", "number", "number", "number", "number", "number", "number", "number"]);
+const rayScan = c("mjwf_ray_scan", "number",
+  ["number", "number", "number", "number", "number", "number", "number", "number", "number",
+    "number", "number", "number", "number", "number", "number"]);
+
+const h = makeHandle(Module, PENDULUM_XML);
+Module.ccall("mjwf_forward", "number", ["number"], [h]);
+const usedThreads = Module.ccall("mjwf_set_threads", "number", ["number"], [threads]);
+const m = Module.ccall("mjwf_model_ptr", "number", ["number"], [h]);
+const d = Module.ccall("mjwf_data_ptr", "number", ["number"], [h]);
+const tip = Module.ccall("mjwf_name2id", "number", ["number", "number", "string"], [h, OBJ_SITE, "tip"]);
+
+// 64 elevation rows x (beams / 64) azimuth columns around the tip.
+const nel = 64;
+const naz = Math.max(1, Math.floor(beams / nel));
+const n = nel * naz;
+const pnt = malloc(8 * 3 * n);
+const vec = malloc(8 * 3 * n);
+const dist = malloc(8 * n);
+const gid = malloc(4 * n);
+const P = heapF64(Module, pnt, 3 * n);
+const V = heapF64(Module, vec, 3 * n);
+for (let i = 0; i < nel; i += 1) {
+  const el = -Math.PI / 4 + (Math.PI / 2) * (i / (nel - 1));
+  for (let j = 0; j < naz; j += 1) {
+    const az = -Math.PI + (2 * Math.PI) * (j / naz);
+    const k = i * naz + j;
+    P.set([0, 0, 0.8], 3 * k);
+    V.set([Math.cos(el) * Math.cos(az), Math.cos(el) * Math.sin(az), Math.sin(el)], 3 * k);
+  }
+}
+
+const time = (fn, reps = 3) => {
+  fn();
+  const t0 = performance.now();
+  for (let r = 0; r < reps; r += 1) fn();
+  return (performance.now() - t0) / reps;
+};
+const perCall = () => {
+  for (let k = 0; k < n; k += 1) ray(m, d, pnt + 24 * k, vec + 24 * k, 0, 1, -1, gid);
+};
+const batched = () => rayBatch(h, pnt, vec, n, 0, 1, -1, 0, dist, gid);
+const scan = () => rayScan(h, OBJ_SITE, tip, naz, -Math.PI, Math.PI, nel, -Math.PI / 4, Math.PI / 4, 0, 1, -1, 0, dist, gid);
+
+const tCall = time(perCall);
+const tBatch = time(batched);
+const tScan = time(scan);
+const rate = (ms) => Math.round(n / (ms / 1000));
+console.log(JSON.stringify({
+  bench: "rays",
+  mjver,
+  rays: n,
+  threads: usedThreads,
+  per_call_rays_per_s: rate(tCall),
+  batch_rays_per_s: rate(tBatch),
+  scan_rays_per_s: rate(tScan),
+}));
+Module.ccall("mjwf_free", null, ["number"], [h]);
@@ -0,0 +1,49 @@
+#!/usr/bin/env node
+// One replicated model (N copies, one mj_step) vs N separate handles: build
+// time, model bytes and env-steps/sec for growing N.
+// Usage: node scripts/bench/replicate.mjs [mjver] [maxEnvs]
+// Requires a bundle built with -DMJWF_HANDLE_API=ON. The handle side is
+// capped by the handle pool (MJWF_MAXH - 2, leaving room for the replica).
+
+import { performance } from "node:perf_hooks";
+import { loadHandleBundle, makeHandle, PENDULUM_XML } from "../../tests/handles/_harness.mjs";
+
+const MAX = Number(process.argv[3] || 62);
+const STEPS = 200;
+const ctx = await loadHandleBundle("bench-replicate");
+if (!ctx) process.exit(0);
+const { Module, mjver } = ctx;
+const step = Module.cwrap("mjwf_step", "number", ["number", "number"]);
+const freeH = Module.cwrap("mjwf_free", null, ["number"]);
+const bytes = Module.cwrap("mjwf_model_full_bytes", "number", ["number"]);
+Module.FS.writeFile("/replicate_base.xml", PENDULUM_XML);
+
+const envStepsPerSec = (fn, n) => {
+  fn();
+  const t = performance.now();
+  fn();
+  return Math.round((n * STEPS) / ((performance.now() - t) / 1000));
+};
+
+const rows = [];
+for (const n of [1, 2, 4, 8, 16, 32, 62].filter((k) => k <= MAX)) {
+  let t = performance.now();
+  const rep = Module.ccall("mjwf_make_replicated", "number", ["string", "number", "number"],
+    ["/replicate_base.xml", n, 3.0]);
+  const buildRep = performance.now() - t;
+  if (rep <= 0) throw new Error(Module.ccall("mjwf_errmsg_last_global", "string", [], []));
+  t = performance.now();
+  const hs = Array.from({ length: n }, (_, i) => makeHandle(Module, PENDULUM_XML, `/replicate_${i}.xml`));
+  const buildHandles = performance.now() - t;
+  rows.push({
+    envs: n,
+    replicated_build_ms: Number(buildRep.toFixed(2)),
+    handles_build_ms: Number(buildHandles.toFixed(2)),
+    replicated_model_bytes: bytes(rep),
+    handles_model_bytes: hs.reduce((a, h) => a + bytes(h), 0),
+    replicated_env_steps_per_s: envStepsPerSec(() => step(rep, STEPS), n),
+    handles_env_steps_per_s: envStepsPerSec(() => hs.forEach((h) => step(h, STEPS)), n),
+  });
+  [rep, ...hs].forEach(freeH);
+}
+console.log(JSON.stringify({ bench: "replicate", mjver, steps: STEPS, rows }));
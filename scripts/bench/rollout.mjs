@@ -0,0 +1,86 @@
+#!/usr/bin/env node
+// MPPI-style rollouts: JS loop (restore state, write ctrl, mjwf_step, copy
+// qpos/qvel per step) vs one mjwf_rollout call. Defaults to K=256, H=50.
+// Usage: node scripts/bench/rollout.mjs [mjver] [K] [H] [threads]
+// Requires a bundle built with -DMJWF_HANDLE_API=ON (threads > 1 needs MJWF_THREADS).
+
+import { performance } from "node:perf_hooks";
+import { loadHandleBundle, makeHandle, heapF64, ARM_XML } from "../../tests/handles/_harness.mjs";
+
+const STATE_FULLPHYSICS = 4111;
+const K = Number(process.argv[3] || 256);
+const H = Number(process.argv[4] || 50);
+const threads = Number(process.argv[5] || 1);
+const ctx = await loadHandleBundle("bench-rollout");
+if (!ctx) process.exit(0);
+const { Module, mjver } = ctx;
+const c = (name, ret, args) => Module.cwrap(name, ret, args);
+const malloc = c("mjwf_mju_malloc", "number", ["number"]);
+const step = c("mjwf_step", "number", ["number", "number"]);
+const restore = c("mjwf_state_restore", "number", ["number", "number"]);
+const rollout = c("mjwf_rollout", "number",
+  ["number", "number", "number", "number", "number", "number", "number", "number", "number"]);
+
+const h = makeHandle(Module, ARM_XML);
+const usedThreads = Module.ccall("mjwf_set_threads", "number", ["number"], [threads]);
+const nq = Module.ccall("mjwf_nq", "number", ["number"], [h]);
+const nv = Module.ccall("mjwf_nv", "number", ["number"], [h]);
+const nu = Module.ccall("mjwf_nu", "number", ["number"], [h]);
+const m = Module.ccall("mjwf_model_ptr", "number", ["number"], [h]);
+const d = Module.ccall("mjwf_data_ptr", "number", ["number"], [h]);
+const ptr = (name) => Module.ccall(`mjwf_${name}_ptr`, "number", ["number"], [h]);
+
+const nstate = Module.ccall("mjwf_mj_stateSize", "number", ["number", "number"], [m, STATE_FULLPHYSICS]);
+const state0 = malloc(8 * nstate);
+Module.ccall("mjwf_mj_getState", null, ["number", "number", "number", "number"], [m, d, state0, STATE_FULLPHYSICS]);
+Module.ccall("mjwf_state_save", "number", ["number", "number"], [h, 0]);
+
+const ctrls = malloc(8 * K * H * nu);
+const U = heapF64(Module, ctrls, K * H * nu);
+for (let i = 0; i < U.length; i += 1) U[i] = Math.sin(0.37 * i);
+const viewIds = ["qpos", "qvel"].map((n) => Module.ccall("mjwf_view_id", "number", ["string"], [n]));
+const views = malloc(4 * viewIds.length);
+new Int32Array(Module.HEAP8.buffer, views, viewIds.length).set(viewIds);
+const stride = nq + nv;
+const out = malloc(8 * K * H * stride);
+
+const time = (fn, reps = 3) => {
+  fn();
+  const t0 = performance.now();
+  for (let r = 0; r < reps; r += 1) fn();
+  return (performance.now() - t0) / reps;
+};
+const jsLoop = () => {
+  const O = heapF64(Module, out, K * H * stride);
+  const ctrl = heapF64(Module, ptr("ctrl"), nu);
+  const qpos = heapF64(Module, ptr("qpos"), nq);
+  const qvel = heapF64(Module, ptr("qvel"), nv);
+  for (let k = 0; k < K; k += 1) {
+    restore(h, 0);
+    for (let t = 0; t < H; t += 1) {
+      const i = k * H + t;
+      ctrl.set(U.subarray(i * nu, (i + 1) * nu));
+      step(h, 1);
+      O.set(qpos, i * stride);
+      O.set(qvel, i * stride + nq);
+    }
+  }
+};
+const native = () => rollout(h, state0, STATE_FULLPHYSICS, ctrls, K, H, views, viewIds.length, out);
+
+const tJs = time(jsLoop);
+const tRollout = time(native);
+const rate = (ms) => Math.round((K * H) / (ms / 1000));
+console.log(JSON.stringify({
+  bench: "rollout",
+  mjver,
+  K,
+  H,
+  threads: usedThreads,
+  js_loop_ms: Number(tJs.toFixed(3)),
+  rollout_ms: Number(tRollout.toFixed(3)),
+  js_loop_steps_per_s: rate(tJs),
+  rollout_steps_per_s: rate(tRollout),
+  speedup: Number((tJs / tRollout).toFixed(2)),
+}));
+Module.ccall("mjwf_free", null, ["number"], [h]);
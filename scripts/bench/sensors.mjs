@@ -0,0 +1,129 @@
+#!/usr/bin/env node
+// Per-step sensor readback: copying all of sensordata and indexing it in JS
+// vs gathering a named subset (after each step, fused into stepping, and
+// batched across handles). The model has 400 frame sensors on 100 sites of a
+// pendulum, of which 6 are read.
+// Usage: node scripts/bench/sensors.mjs [mjver] [steps] [handles]
+
+import { performance } from "node:perf_hooks";
+import { loadHandleBundle, makeHandle, heapF64 } from "../../tests/handles/_harness.mjs";
+
+const STEPS = Number(process.argv[3] || 5000);
+const HANDLES = Number(process.argv[4] || 32);
+const NSITE = 100;
+const KINDS = ["framepos", "framequat", "framelinvel", "frameangvel"];
+
+const sites = Array.from({ length: NSITE }, (_, i) =>
+  `<site name="s${i}" pos="${(0.01 * i).toFixed(2)} 0 -0.2"/>`).join("");
+const sensors = Array.from({ length: NSITE }, (_, i) =>
+  KINDS.map((k) => `<${k} name="${k}${i}" objtype="site" objname="s${i}"/>`).join("")).join("\n    ");
+const XML = `<mujoco model="sensor_farm">
+  <option timestep="0.002"/>
+  <worldbody>
+    <body name="link" pos="0 0 1">
+      <joint name="hinge" type="hinge" axis="0 1 0"/>
+      <geom type="capsule" fromto="0 0 0 0 0 -0.2" size="0.02"/>
+      ${sites}
+    </body>
+  </worldbody>
+  <actuator><motor joint="hinge"/></actuator>
+  <sensor>
+    ${sensors}
+  </sensor>
+</mujoco>`;
+const SUBSET = ["framepos3", "framequat17", "frameangvel42", "framepos60", "framelinvel61", "framequat99"];
+
+const ctx = await loadHandleBundle("bench-sensors");
+if (!ctx) process.exit(0);
+const { Module, mjver } = ctx;
+const step = Module.cwrap("mjwf_step", "number", ["number", "number"]);
+const sensordataPtr = Module.cwrap("mjwf_sensordata_ptr", "number", ["number"]);
+const nsensordata = Module.cwrap("mjwf_nsensordata", "number", ["number"]);
+const select = Module.cwrap("mjwf_sensor_select", "number", ["number", "string"]);
+const gather = Module.cwrap("mjwf_sensor_gather", "number", ["number", "number"]);
+const stepGather = Module.cwrap("mjwf_step_gather", "number", ["number", "number", "number"]);
+const gatherBatch = Module.cwrap("mjwf_sensor_gather_batch", "number", ["number", "number", "number", "number"]);
+const nameToId = Module.cwrap("mjwf_name2id", "number", ["number", "number", "string"]);
+const malloc = Module.cwrap("mjwf_mju_malloc", "number", ["number"]);
+const MJOBJ_SENSOR = 20;
+
+const h = makeHandle(Module, XML, "/sensor_farm.xml");
+const width = select(h, SUBSET.join(","));
+const nsd = nsensordata(h);
+// The JS indexing a subset replaces: (sensordata address, dim) per sensor,
+// from the sensor order in the XML.
+const DIMS = [3, 4, 3, 3];
+const offsets = SUBSET.map((name) => {
+  const id = nameToId(h, MJOBJ_SENSOR, name);
+  let a = 0;
+  for (let s = 0; s < id; s += 1) a += DIMS[s % KINDS.length];
+  return [a, DIMS[id % KINDS.length]];
+});
+const out = malloc(8 * Math.max(width * 100, width * HANDLES));
+const sink = new Float64Array(width);
+
+const time = (fn, steps) => {
+  fn(Math.min(steps, 100));
+  const t = performance.now();
+  fn(steps);
+  return (performance.now() - t) * 1e6 / steps;
+};
+
+const full = time((n) => {
+  for (let i = 0; i < n; i += 1) {
+    step(h, 1);
+    const sd = heapF64(Module, sensordataPtr(h), nsd).slice();
+    let k = 0;
+    for (const [a, d] of offsets) for (let j = 0; j < d; j += 1) sink[k++] = sd[a + j];
+  }
+}, STEPS);
+const gathered = time((n) => {
+  for (let i = 0; i < n; i += 1) {
+    step(h, 1);
+    gather(h, out);
+    sink.set(heapF64(Module, out, width));
+  }
+}, STEPS);
+const fused = time((n) => {
+  for (let i = 0; i < n; i += 100) {
+    const k = Math.min(100, n - i);
+    stepGather(h, k, out);
+    heapF64(Module, out, k * width).slice();
+  }
+}, STEPS);
+
+// Batched: HANDLES handles stepped and read back per tick.
+const hs = Array.from({ length: HANDLES }, () => {
+  const x = makeHandle(Module, XML, "/sensor_farm.xml");
+  select(x, SUBSET.join(","));
+  return x;
+});
+const hsPtr = malloc(4 * HANDLES);
+new Int32Array(Module.HEAP8.buffer, hsPtr, HANDLES).set(hs);
+const ticks = Math.max(1, Math.floor(STEPS / HANDLES));
+const batchFull = time((n) => {
+  for (let i = 0; i < n; i += 1) {
+    for (const x of hs) {
+      step(x, 1);
+      heapF64(Module, sensordataPtr(x), nsd).slice();
+    }
+  }
+}, ticks);
+const batchGather = time((n) => {
+  for (let i = 0; i < n; i += 1) {
+    gatherBatch(hsPtr, HANDLES, 1, out);
+    heapF64(Module, out, width * HANDLES).slice();
+  }
+}, ticks);
+
+console.log(JSON.stringify({
+  bench: "sensors",
+  mjver,
+  steps: STEPS,
+  nsensor: NSITE * KINDS.length,
+  nsensordata: nsd,
+  subset: SUBSET.length,
+  bytes_per_step: { full: 8 * nsd, subset: 8 * width },
+  ns_per_step: { full: Math.round(full), gather: Math.round(gathered), step_gather: Math.round(fused) },
+  batch: { handles: HANDLES, ns_per_tick_full: Math.round(batchFull), ns_per_tick_gather: Math.round(batchGather) },
+}));
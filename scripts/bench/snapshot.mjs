@@ -0,0 +1,85 @@
+#!/usr/bin/env node
+// Snapshot size and codec cost for a falling, actuated humanoid: bytes per
+// tick for a few field sets against raw f64 arrays, and encode/apply time per
+// packet. Pass a model path to use another model (e.g. MuJoCo's humanoid.xml).
+// Usage: node scripts/bench/snapshot.mjs [mjver] [ticks] [model.xml]
+
+import fs from "node:fs";
+import { performance } from "node:perf_hooks";
+import { loadHandleBundle, makeHandle, heapF64, HUMANOID_XML } from "../../tests/handles/_harness.mjs";
+
+const TICKS = Number(process.argv[3] || 2000);
+const MODEL = process.argv[4];
+const STEPS_PER_TICK = 4;  // 2 ms physics, 125 Hz network tick
+const KEYFRAME_EVERY = 60;
+
+const ctx = await loadHandleBundle("bench-snapshot");
+if (!ctx) process.exit(0);
+const { Module, mjver } = ctx;
+const call = (name, ...args) => Module.ccall(name, "number", args.map(() => "number"), args);
+const viewId = (name) => Module.ccall("mjwf_view_id", "number", ["string"], [name]);
+const malloc = (n) => Module.ccall("mjwf_mju_malloc", "number", ["number"], [n]);
+let xml = MODEL ? fs.readFileSync(MODEL, "utf8") : HUMANOID_XML;
+// Actuate every hinge so the model keeps moving after it lands.
+if (!MODEL) {
+  const motors = [...xml.matchAll(/joint name="(\w+)" type="hinge"/g)].map((m) => `<motor joint="${m[1]}"/>`);
+  xml = xml.replace("</mujoco>", `<actuator>${motors.join("")}</actuator></mujoco>`);
+}
+
+const SETS = {
+  qpos_qvel: [["qpos", 1e-4], ["qvel", 1e-3]],
+  qpos_only: [["qpos", 1e-4]],
+  geom_pose: [["geom_xpos", 1e-4], ["geom_xmat", 1e-4]],
+  qpos_qvel_lossless: [["qpos", 0], ["qvel", 0]],
+};
+
+const results = {};
+for (const [setName, set] of Object.entries(SETS)) {
+  const sim = makeHandle(Module, xml, "/sim.xml");
+  const viewer = makeHandle(Module, xml, "/viewer.xml");
+  const fields = malloc(4 * set.length);
+  const quanta = malloc(8 * set.length);
+  new Int32Array(Module.HEAP8.buffer, fields, set.length).set(set.map(([v]) => viewId(v)));
+  heapF64(Module, quanta, set.length).set(set.map(([, q]) => q));
+  call("mjwf_snapshot_config", sim, fields, quanta, set.length, KEYFRAME_EVERY);
+  call("mjwf_snapshot_config", viewer, fields, quanta, set.length, KEYFRAME_EVERY);
+  const cap = call("mjwf_snapshot_max_bytes", sim);
+  const buf = malloc(cap);
+  const nu = call("mjwf_nu", sim);
+  const raw = set.reduce((s, [v]) => s + 8 * call("mjwf_view_len", sim, viewId(v)), 0);
+
+  let bytes = 0;
+  let encMs = 0;
+  let decMs = 0;
+  for (let t = 0; t < TICKS; t += 1) {
+    const ctrl = heapF64(Module, call("mjwf_ctrl_ptr", sim), nu);
+    for (let i = 0; i < nu; i += 1) ctrl[i] = Math.sin(0.01 * t + i);
+    call("mjwf_step", sim, STEPS_PER_TICK);
+    let t0 = performance.now();
+    const n = call("mjwf_snapshot_encode", sim, 0, buf, cap);
+    encMs += performance.now() - t0;
+    t0 = performance.now();
+    call("mjwf_snapshot_apply", viewer, buf, n, 0);
+    decMs += performance.now() - t0;
+    bytes += n;
+  }
+  results[setName] = {
+    raw_f64_bytes: raw,
+    bytes_per_tick: Number((bytes / TICKS).toFixed(1)),
+    ratio: Number((raw / (bytes / TICKS)).toFixed(2)),
+    encode_ns: Math.round((encMs / TICKS) * 1e6),
+    apply_ns: Math.round((decMs / TICKS) * 1e6),
+  };
+  [fields, quanta, buf].forEach((p) => Module.ccall("mjwf_mju_free", null, ["number"], [p]));
+  call("mjwf_free", sim);
+  call("mjwf_free", viewer);
+}
+
+console.log(JSON.stringify({
+  bench: "snapshot",
+  mjver,
+  model: MODEL || "inline-humanoid",
+  ticks: TICKS,
+  keyframe_every: KEYFRAME_EVERY,
+  sets: results,
+}));
@@ -0,0 +1,69 @@
+#!/usr/bin/env bash
+
+set -euo pipefail
+
+usage() {
+  echo "Usage: scripts/ci/build_wasm_variant.sh --app <dir> --version <mjver> --short <short> --variant <name> [-- <cmake flags>...]" >&2
+  exit 2
+}
+
+APP=""
+MJVER=""
+SHORT=""
+VARIANT=""
+
+while [[ $# -gt 0 ]]; do
+  case "$1" in
+    --app|--version|--short|--variant)
+      [[ $# -ge 2 ]] || usage
+      case "$1" in
+        --app) APP="$2" ;;
+        --version) MJVER="$2" ;;
+        --short) SHORT="$2" ;;
+        --variant) VARIANT="$2" ;;
+      esac
+      shift 2
+      ;;
+    --)
+      shift
+      break
+      ;;
+    *)
+      usage
+      ;;
+  esac
+done
+
+[[ -n "$APP" && -n "$MJVER" && -n "$SHORT" && -n "$VARIANT" ]] || usage
+
+# Builds one extra wasm bundle of a 3.3.x app (handle API plus the given
+# variant flags) into build/<short>_<variant> and copies it to
+# dist/<mjver>-<variant>/mujoco.{js,wasm}.
+BUILD_DIR="build/${SHORT}_${VARIANT}"
+DIST_DIR="dist/${MJVER}-${VARIANT}"
+FLAGS=(
+  -DCMAKE_BUILD_TYPE=Release
+  -DMUJOCO_BUILD_EXAMPLES=OFF -DMUJOCO_BUILD_SIMULATE=OFF -DMUJOCO_BUILD_TESTS=OFF -DMUJOCO_BUILD_SAMPLES=OFF
+  -DCMAKE_SKIP_INSTALL_RULES=ON
+  -DLIBM_LIBRARY:STRING=-lm
+  -DMJVER="${MJVER}"
+  -DMJWF_HANDLE_API=ON
+  "$@"
+)
+
+# Same two-stage configure as the wasm32 build: stage 1 only fetches deps and
+# may fail; qhull is then patched to build static under Emscripten.
+emcmake cmake -S "$APP" -B "$BUILD_DIR" "${FLAGS[@]}" -DMUJOCO_ENABLE_QHULL=OFF -DMUJOCO_BUILD_PLUGINS=OFF || true
+QH="${BUILD_DIR}/_deps/qhull-src/CMakeLists.txt"
+if [[ -f "$QH" ]]; then
+  sed -i 's/\bSHARED\b/STATIC/g' "$QH" || true
+  awk 'BEGIN{print "set(BUILD_SHARED_LIBS OFF CACHE BOOL \"\" FORCE)"} {print}' "$QH" > "$QH.tmp" && mv "$QH.tmp" "$QH"
+fi
+emcmake cmake -S "$APP" -B "$BUILD_DIR" "${FLAGS[@]}"
+cmake --build "$BUILD_DIR" -j 2
+
+mkdir -p "$DIST_DIR"
+cp "${BUILD_DIR}/_wasm/mujoco_wasm${SHORT}.js" "${DIST_DIR}/mujoco.js"
+cp "${BUILD_DIR}/_wasm/mujoco_wasm${SHORT}.wasm" "${DIST_DIR}/mujoco.wasm"
+
+echo "[wasm-variant] ${VARIANT} bundle for ${MJVER} in ${DIST_DIR}"
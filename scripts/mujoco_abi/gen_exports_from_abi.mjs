@@ -39,6 +39,7 @@ function parseArgs(argv) {
     version: 'unknown',
     outDir: 'build',
     abiDir: null,
+    memory64: false,
   };
   for (let i = 2; i < argv.length; ++i) {
     const arg = argv[i];
@@ -49,6 +50,7 @@ function parseArgs(argv) {
     else if (arg === '--version') opts.version = argv[++i];
     else if (arg === '--out') opts.outDir = pathResolve(argv[++i]);
     else if (arg === '--abi') opts.abiDir = pathResolve(argv[++i]);
+    else if (arg === '--memory64') opts.memory64 = true;
     else {
       console.error(`Unknown argument: ${arg}`);
       process.exit(2);
@@ -186,12 +188,45 @@ function generateSource(finalFunctions) {
   return lines.join('\n');
 }
 
-function emitDts(finalFunctions) {
+// TypeScript type of a C parameter/return type at the wasm boundary. Pointers
+// and pointer-sized integers are `Ptr` (number on wasm32, bigint on wasm64);
+// 64-bit integers are always bigint (-sWASM_BIGINT).
+const POINTER_SIZED = /^(const\s+)?(size_t|ssize_t|ptrdiff_t|intptr_t|uintptr_t)$/;
+const INT64 = /^(const\s+)?(int64_t|uint64_t|mjtSize|long long|unsigned long long)$/;
+const TS_RESERVED = new Set(['default', 'delete', 'function', 'new', 'var', 'this', 'in', 'class', 'enum']);
+
+function tsType(ctype) {
+  const t = ctype.replace(/\s+/g, ' ').trim();
+  if (t === 'void') return 'void';
+  if (t.includes('*') || t.includes('[')) return 'Ptr';
+  if (POINTER_SIZED.test(t)) return 'Ptr';
+  if (INT64.test(t)) return 'bigint';
+  return 'number';
+}
+
+function paramType(decl, name) {
+  // Arrays ("mjtNum vec[3]") decay to pointers; otherwise drop the name.
+  if (/\[[^\]]*\]\s*$/.test(decl)) return 'Ptr';
+  const re = new RegExp(`\\b${name}\\s*$`);
+  return tsType(decl.replace(re, ''));
+}
+
+function emitDts(finalFunctions, memory64) {
   const lines = [];
-  lines.push('// AUTO-GENERATED: TypeScript declarations for mjwf exports.');
+  lines.push('// AUTO-GENERATED: TypeScript declarations for mjwf exports (raw wasmExports).');
+  lines.push(`// ${memory64 ? 'wasm64 bundle: pointers are bigint.' : 'wasm32 bundle: pointers are numbers.'}`);
+  lines.push(`export type Ptr = ${memory64 ? 'bigint' : 'number'};`);
   lines.push('export interface MJWFExports {');
   for (const fn of finalFunctions) {
-    lines.push(`  mjwf_${fn.name}(...args: number[]): number;`);
+    const decls = Array.isArray(fn.paramDecls) ? fn.paramDecls : [];
+    const names = Array.isArray(fn.paramNames) ? fn.paramNames : [];
+    const params = decls
+      .filter((decl) => !decl.includes('...'))
+      .map((decl, idx) => {
+        const name = names[idx] || `arg${idx}`;
+        return `${TS_RESERVED.has(name) ? `${name}_` : name}: ${paramType(decl, name)}`;
+      });
+    lines.push(`  mjwf_${fn.name}(${params.join(', ')}): ${tsType(fn.returnType || 'void')};`);
   }
   lines.push('}');
   return lines.join('\n');
@@ -351,7 +386,7 @@ function main() {
   mkdirSync(opts.outDir, { recursive: true });
   writeFileSync(pathJoin(opts.outDir, `exports_${opts.version}.json`), JSON.stringify(exportsJson, null, 2));
   writeFileSync(pathJoin(opts.outDir, `exports_${opts.version}.lst`), emitLst(finalNames));
-  writeFileSync(pathJoin(opts.outDir, `types_${opts.version}.d.ts`), emitDts(finalFunctions));
+  writeFileSync(pathJoin(opts.outDir, `types_${opts.version}.d.ts`), emitDts(finalFunctions, opts.memory64));
 
   mkdirSync(opts.abiDir, { recursive: true });
   writeFileSync(pathJoin(opts.abiDir, 'wrapper_exports.json'), JSON.stringify(exportsJson, null, 2));
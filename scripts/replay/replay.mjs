@@ -0,0 +1,72 @@
+#!/usr/bin/env node
+// WASM side of the replay-log tools; same CLI and JSON as mujoco_compare3xx.
+//   node scripts/replay/replay.mjs [mjver] --record <model.xml> <log> [steps] [checkpoint_every]
+//   node scripts/replay/replay.mjs [mjver] --replay <model.xml> <log>
+// --record drives the model with the same ctrl pattern as the native tool, so
+// a log recorded on one side replays on the other: a mismatch names the first
+// step (and component) where the builds disagree. Exit codes as native: 0
+// identical, 1 diverged, 2 error.
+
+import fs from "node:fs";
+import path from "node:path";
+import { performance } from "node:perf_hooks";
+import { loadHandleBundle, heapF64 } from "../../tests/handles/_harness.mjs";
+
+const args = process.argv.slice(2);
+const mode = args.findIndex((a) => a === "--record" || a === "--replay");
+if (mode < 0 || args.length < mode + 3) {
+  console.error("usage: replay.mjs [mjver] --record|--replay <model.xml> <log> [steps] [checkpoint_every]");
+  process.exit(2);
+}
+const mjver = mode > 0 ? args[0] : "3.3.7";
+const [flag, xmlPath, logPath] = args.slice(mode, mode + 3);
+const steps = Number(args[mode + 3] || 1000);
+const checkpointEvery = Number(args[mode + 4] || 0);
+
+const ctx = await loadHandleBundle("replay", mjver);
+if (!ctx) process.exit(2);
+const { Module } = ctx;
+const call = (name, ...a) => Module.ccall(name, "number", a.map((x) => (typeof x === "string" ? "string" : "number")), a);
+
+// Only the XML file is copied into MEMFS, so models must be self-contained
+// (inline meshes, no includes).
+const modelFile = `/${path.basename(xmlPath)}`;
+Module.FS.writeFile(modelFile, fs.readFileSync(xmlPath));
+const h = call("mjwf_make_from_xml", modelFile);
+if (h <= 0) {
+  console.error(`loadXML failed: ${Module.ccall("mjwf_errmsg_last_global", "string", [], [])}`);
+  process.exit(2);
+}
+
+if (flag === "--record") {
+  const nu = call("mjwf_nu", h);
+  if (!call("mjwf_replay_record_start", h, "/out.rlog", checkpointEvery)) process.exit(2);
+  for (let t = 0; t < steps; t += 1) {
+    const ctrl = heapF64(Module, call("mjwf_ctrl_ptr", h), nu);
+    for (let i = 0; i < nu; i += 1) ctrl[i] = Math.sin(0.1 * Math.floor(t / 10) + i);
+    call("mjwf_step", h, 1);
+  }
+  call("mjwf_replay_record_stop", h);
+  fs.writeFileSync(logPath, Module.FS.readFile("/out.rlog"));
+  console.log(JSON.stringify({ steps, mjversion: mjver }));
+  process.exit(0);
+}
+
+Module.FS.writeFile("/in.rlog", fs.readFileSync(logPath));
+const res = Module.ccall("mjwf_mju_malloc", "number", ["number"], [8 * 6]);
+const t0 = performance.now();
+const status = call("mjwf_replay_check", h, "/in.rlog", 0, res);
+const ms = performance.now() - t0;
+if (status < 0) {
+  console.error(`replay failed: ${Module.ccall("mjwf_errmsg_last", "string", ["number"], [h])}`);
+  process.exit(2);
+}
+const [replayed, step, comp, element, expected, actual] = heapF64(Module, res, 6);
+const out = { match: status === 1, steps: replayed };
+if (!status) {
+  Object.assign(out, { step, field: Module.ccall("mjwf_replay_comp_name", "string", ["number"], [comp]), element });
+  if (element >= 0) Object.assign(out, { expected, actual });
+}
+out.steps_per_s = Math.round(replayed / (ms / 1000));
+console.log(JSON.stringify(out));
+process.exit(status ? 0 : 1);
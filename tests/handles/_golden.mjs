@@ -0,0 +1,127 @@
+// Golden state files (format in wrappers/official_app_3xx/native_compare.cpp):
+// a manifest.json plus one binary file per model holding the value of each
+// recorded field after every step, generated natively by
+//   mujoco_compare3xx --golden <dir> [--steps N] [--threads T] [--fields ...] <model.xml>...
+// compareGolden re-runs a model on a handle with the same ctrl pattern and
+// checks every field at every step against |actual - expected| <= atol + rtol * |expected|.
+
+import fs from "node:fs";
+import path from "node:path";
+import { heapF64 } from "./_harness.mjs";
+
+export const GOLDEN_VERSION = 1;
+// Field ids as stored in the files; same order as k_fields in native_compare.cpp.
+export const GOLDEN_FIELDS = ["time", "qpos", "qvel", "act", "sensordata", "qacc", "ctrl"];
+
+const ctrlAt = (t, i) => Math.sin(0.1 * Math.floor(t / 10) + i);
+
+export function readGolden(dir) {
+  const manifest = JSON.parse(fs.readFileSync(path.join(dir, "manifest.json"), "utf8"));
+  if (manifest.version !== GOLDEN_VERSION) throw new Error(`golden manifest version ${manifest.version}`);
+  const models = manifest.models.filter((e) => !e.error).map((e) => {
+    // Copy into a fresh buffer so the f64 blocks are 8-byte aligned.
+    const buf = new Uint8Array(fs.readFileSync(path.join(dir, e.file))).buffer;
+    const head = new Int32Array(buf, 8, 4);
+    if (new TextDecoder().decode(new Uint8Array(buf, 0, 8)) !== "MJWFGOLD" || head[0] !== GOLDEN_VERSION ||
+        head[1] !== manifest.steps || head[2] !== e.fields.length) {
+      throw new Error(`${e.file}: not a golden file for this manifest`);
+    }
+    const fields = e.fields.map((f) => ({ ...f, data: new Float64Array(buf, f.offset, manifest.steps * f.width) }));
+    return { ...e, steps: manifest.steps, fields };
+  });
+  return { ...manifest, models, failed: manifest.models.filter((e) => e.error) };
+}
+
+// Loads the model XML into MEMFS (models must be self-contained) and returns a handle.
+function openModel(Module, xmlPath) {
+  const file = `/golden_${path.basename(xmlPath)}`;
+  Module.FS.writeFile(file, fs.readFileSync(xmlPath));
+  const h = Module.ccall("mjwf_make_from_xml", "number", ["string"], [file]);
+  if (h <= 0) throw new Error(`${xmlPath}: ${Module.ccall("mjwf_errmsg_last_global", "string", [], [])}`);
+  return h;
+}
+
+function fieldReader(Module, h, name, width) {
+  if (name === "time") return () => [Module.ccall("mjwf_time", "number", ["number"], [h])];
+  const ptr = Module.cwrap(`mjwf_${name}_ptr`, "number", ["number"]);
+  return () => heapF64(Module, ptr(h), width);
+}
+
+function drive(Module, h, t) {
+  const nu = Module.ccall("mjwf_nu", "number", ["number"], [h]);
+  const ctrl = heapF64(Module, Module.ccall("mjwf_ctrl_ptr", "number", ["number"], [h]), nu);
+  for (let i = 0; i < nu; i += 1) ctrl[i] = ctrlAt(t, i);
+}
+
+// Compares one manifest entry. opts.tol overrides {field: {atol, rtol}};
+// opts.prepare(h) may edit the handle before stepping; opts.steps limits the horizon.
+// Returns { model, steps, ok, fields: {name: max abs error}, first } where first
+// is the earliest out-of-tolerance value (1-based step).
+export function compareGolden(Module, entry, opts = {}) {
+  const h = opts.handle ?? openModel(Module, entry.model);
+  const dims = ["nq", "nv", "na", "nu", "nsensordata"];
+  for (const d of dims) {
+    const n = Module.ccall(`mjwf_${d}`, "number", ["number"], [h]);
+    if (n !== entry[d]) throw new Error(`${entry.model}: ${d} ${n} != golden ${entry[d]}`);
+  }
+  opts.prepare?.(h);
+  const steps = Math.min(entry.steps, opts.steps ?? entry.steps);
+  const fields = entry.fields.map((f) => ({ ...f, ...opts.tol?.[f.name], read: fieldReader(Module, h, f.name, f.width) }));
+  const maxErr = Object.fromEntries(fields.map((f) => [f.name, 0]));
+  let first = null;
+  for (let t = 0; t < steps; t += 1) {
+    drive(Module, h, t);
+    Module.ccall("mjwf_step", "number", ["number", "number"], [h, 1]);
+    for (const f of fields) {
+      const actual = f.read();
+      const base = t * f.width;
+      for (let i = 0; i < f.width; i += 1) {
+        const expected = f.data[base + i];
+        const err = Math.abs(actual[i] - expected);
+        if (err > maxErr[f.name]) maxErr[f.name] = err;
+        if (!first && !(err <= f.atol + f.rtol * Math.abs(expected))) {
+          first = { field: f.name, step: t + 1, element: i, expected, actual: actual[i] };
+        }
+      }
+    }
+  }
+  if (!opts.handle) Module.ccall("mjwf_free", null, ["number"], [h]);
+  return { model: entry.model, steps, ok: !first, fields: maxErr, first };
+}
+
+// WASM-side writer of the same format, e.g. to diff two bundles against each other.
+export function recordGolden(Module, dir, models, { steps = 1000, fields = ["qpos", "qvel", "act", "sensordata"], tol = {} } = {}) {
+  fs.mkdirSync(dir, { recursive: true });
+  const entries = models.map((model, index) => {
+    const h = openModel(Module, model);
+    const dim = (d) => Module.ccall(`mjwf_${d}`, "number", ["number"], [h]);
+    const timestep = Module.ccall("mjwf_timestep", "number", ["number"], [h]);
+    const widths = { time: 1, qpos: dim("nq"), qvel: dim("nv"), act: dim("na"), sensordata: dim("nsensordata"), qacc: dim("nv"), ctrl: dim("nu") };
+    const layout = [];
+    let offset = 32 + 8 * fields.length;
+    for (const name of fields) {
+      layout.push({ name, width: widths[name], offset, atol: tol[name]?.atol ?? 0, rtol: tol[name]?.rtol ?? 0 });
+      offset += 8 * steps * widths[name];
+    }
+    const buf = new ArrayBuffer(offset);
+    new Uint8Array(buf).set(new TextEncoder().encode("MJWFGOLD"));
+    new Int32Array(buf, 8, 4).set([GOLDEN_VERSION, steps, fields.length, 0]);
+    new Float64Array(buf, 24, 1)[0] = timestep;
+    new Int32Array(buf, 32, 2 * fields.length).set([...fields.map((f) => GOLDEN_FIELDS.indexOf(f)), ...layout.map((f) => f.width)]);
+    const readers = layout.map((f) => ({ read: fieldReader(Module, h, f.name, f.width), out: new Float64Array(buf, f.offset, steps * f.width), width: f.width }));
+    for (let t = 0; t < steps; t += 1) {
+      drive(Module, h, t);
+      Module.ccall("mjwf_step", "number", ["number", "number"], [h, 1]);
+      for (const r of readers) r.out.set(r.read(), t * r.width);
+    }
+    const file = `${String(index).padStart(3, "0")}_${path.basename(model, path.extname(model))}.golden`;
+    fs.writeFileSync(path.join(dir, file), new Uint8Array(buf));
+    const entry = { model, file, nq: dim("nq"), nv: dim("nv"), na: dim("na"), nu: dim("nu"), nsensordata: dim("nsensordata"), timestep, fields: layout };
+    Module.ccall("mjwf_free", null, ["number"], [h]);
+    return entry;
+  });
+  const mjversion = Module.ccall("mjwf_version_string", "string", [], []);
+  const manifest = { version: GOLDEN_VERSION, mjversion, steps, ctrl: "sin(0.1*floor(t/10)+i)", models: entries };
+  fs.writeFileSync(path.join(dir, "manifest.json"), JSON.stringify(manifest, null, 2));
+  return manifest;
+}
@@ -0,0 +1,138 @@
+// Shared loader for handle-layer tests and benches.
+// Usage: node tests/handles/<name>.mjs [mjver]   (default 3.3.7)
+// Bundles built without -DMJWF_HANDLE_API=ON are reported as skipped, except
+// under CI, where the handle gates must run against a handle-API bundle.
+
+import path from "node:path";
+import { fileURLToPath, pathToFileURL } from "node:url";
+import assert from "node:assert/strict";
+import fs from "node:fs";
+
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = path.dirname(__filename);
+export const rootDir = path.resolve(__dirname, "../..");
+
+export async function loadHandleBundle(name, mjver = process.argv[2] || process.env.MJVER || "3.3.7") {
+  const distDir = path.resolve(rootDir, "dist", mjver);
+  const wasmURL = path.join(distDir, "mujoco.wasm");
+  const jsURL = path.join(distDir, "mujoco.js");
+  assert.ok(fs.existsSync(jsURL), `dist/${mjver}/mujoco.js missing`);
+  assert.ok(fs.existsSync(wasmURL), `dist/${mjver}/mujoco.wasm missing`);
+
+  const modFactory = (await import(pathToFileURL(jsURL).href)).default;
+  const Module = await modFactory({ locateFile: (p) => (p.endsWith(".wasm") ? wasmURL : p) });
+  if (Module.ready) await Module.ready;
+  if (typeof Module._mjwf_valid !== "function") {
+    assert.ok(!process.env.CI, `${name}(${mjver}): dist/${mjver} was built without MJWF_HANDLE_API`);
+    console.log(`${name}(${mjver}): skipped (bundle built without MJWF_HANDLE_API)`);
+    return null;
+  }
+  return { Module, mjver };
+}
+
+export function makeHandle(Module, xml, file = "/mjwf_model.xml") {
+  Module.FS.writeFile(file, xml);
+  const h = Module.ccall("mjwf_make_from_xml", "number", ["string"], [file]);
+  if (h <= 0) {
+    throw new Error(`mjwf_make_from_xml failed: ${Module.ccall("mjwf_errmsg_last_global", "string", [], [])}`);
+  }
+  return h;
+}
+
+export function heapF64(Module, ptr, n) {
+  return new Float64Array(Module.HEAP8.buffer, ptr, n);
+}
+
+// 8 for a -DMJWF_MEMORY64=ON bundle. There, pointer and size_t arguments must
+// be BigInt: declare them as "pointer" in ccall/cwrap, which converts both
+// ways (on wasm32 it passes numbers through).
+export function pointerBytes(Module) {
+  return typeof Module._mjwf_pointer_bytes === "function" ? Module._mjwf_pointer_bytes() : 4;
+}
+
+// Pendulum with a motor, two sensors and a ball resting on a floor (ncon > 0).
+export const PENDULUM_XML = `<?xml version="1.0"?>
+<mujoco model="pendulum">
+  <option timestep="0.002" gravity="0 0 -9.81"/>
+  <worldbody>
+    <geom name="floor" type="plane" size="2 2 0.1"/>
+    <body name="link" pos="0 0 1">
+      <joint name="hinge" type="hinge" axis="0 1 0" damping="0.01"/>
+      <geom type="capsule" fromto="0 0 0 0 0 -0.2" size="0.02" density="1000"/>
+      <site name="tip" pos="0 0 -0.2"/>
+    </body>
+    <body name="ball" pos="0.5 0 0.05">
+      <freejoint/>
+      <geom type="sphere" size="0.05" density="500"/>
+    </body>
+  </worldbody>
+  <actuator>
+    <motor name="m" joint="hinge" gear="1"/>
+  </actuator>
+  <sensor>
+    <jointpos name="hinge_pos" joint="hinge"/>
+    <jointvel name="hinge_vel" joint="hinge"/>
+  </sensor>
+</mujoco>`;
+
+// Planar 3-link arm (hinges about z) with sites "s1", "s2" and "ee" at the link ends.
+export const ARM_XML = `<?xml version="1.0"?>
+<mujoco model="arm3">
+  <worldbody>
+    <body name="l1" pos="0 0 0.1">
+      <joint name="j1" type="hinge" axis="0 0 1"/>
+      <geom type="capsule" fromto="0 0 0 0.3 0 0" size="0.02"/>
+      <site name="s1" pos="0.3 0 0"/>
+      <body name="l2" pos="0.3 0 0">
+        <joint name="j2" type="hinge" axis="0 0 1"/>
+        <geom type="capsule" fromto="0 0 0 0.25 0 0" size="0.02"/>
+        <site name="s2" pos="0.25 0 0"/>
+        <body name="l3" pos="0.25 0 0">
+          <joint name="j3" type="hinge" axis="0 0 1"/>
+          <geom type="capsule" fromto="0 0 0 0.2 0 0" size="0.02"/>
+          <site name="ee" pos="0.2 0 0"/>
+        </body>
+      </body>
+    </body>
+  </worldbody>
+  <actuator>
+    <motor joint="j1"/>
+    <motor joint="j2"/>
+    <motor joint="j3"/>
+  </actuator>
+</mujoco>`;
+
+// 27-dof humanoid without actuators: free root, abdomen, hips, knees, ankles,
+// shoulders, elbows.
+const limb = (name, pos, to, joints, child = "") =>
+  `<body name="${name}" pos="${pos}">${joints}<geom type="capsule" fromto="0 0 0 ${to}" size="0.05"/>${child}</body>`;
+const hinge = (name, axis, range) => `<joint name="${name}" type="hinge" axis="${axis}" range="${range}"/>`;
+const leg = (s) => limb(`thigh_${s}`, `0 ${s === "r" ? -0.1 : 0.1} -0.04`, "0 0 -0.34",
+  hinge(`hip_x_${s}`, "1 0 0", "-25 5") + hinge(`hip_z_${s}`, "0 0 1", "-60 35") + hinge(`hip_y_${s}`, "0 1 0", "-110 20"),
+  limb(`shin_${s}`, "0 0 -0.4", "0 0 -0.3", hinge(`knee_${s}`, "0 -1 0", "-160 2"),
+    limb(`foot_${s}`, "0 0 -0.39", "-0.07 0 0 0.14 0 0", hinge(`ankle_y_${s}`, "0 1 0", "-50 50") +
+      hinge(`ankle_x_${s}`, "1 0 0", "-50 50"))));
+const arm = (s) => limb(`upper_arm_${s}`, `0 ${s === "r" ? -0.17 : 0.17} 0.06`, `0.16 ${s === "r" ? -0.16 : 0.16} -0.16`,
+  hinge(`shoulder1_${s}`, "2 1 1", "-85 60") + hinge(`shoulder2_${s}`, "0 -1 1", "-85 60"),
+  limb(`lower_arm_${s}`, `0.18 ${s === "r" ? -0.18 : 0.18} -0.18`, `0.18 ${s === "r" ? 0.18 : -0.18} 0.18`,
+    hinge(`elbow_${s}`, "0 -1 1", "-90 50")));
+export const HUMANOID_XML = `<mujoco model="humanoid">
+  <option timestep="0.002"/>
+  <default><joint damping="1" armature="0.01"/><motor ctrlrange="-1 1" gear="40"/></default>
+  <worldbody>
+    <geom type="plane" size="10 10 0.1"/>
+    <body name="torso" pos="0 0 1.3"><freejoint/>
+      <geom type="capsule" fromto="0 -0.07 0 0 0.07 0" size="0.07"/>
+      <geom type="sphere" pos="0 0 0.19" size="0.09"/>
+      ${arm("r")}${arm("l")}
+      <body name="waist" pos="-0.01 0 -0.26">
+        <geom type="capsule" fromto="0 -0.06 0 0 0.06 0" size="0.06"/>
+        ${hinge("abdomen_z", "0 0 1", "-45 45")}${hinge("abdomen_y", "0 1 0", "-75 30")}
+        <body name="pelvis" pos="0 0 -0.165">${hinge("abdomen_x", "1 0 0", "-35 35")}
+          <geom type="capsule" fromto="-0.02 -0.07 0 -0.02 0.07 0" size="0.09"/>
+          ${leg("r")}${leg("l")}
+        </body>
+      </body>
+    </body>
+  </worldbody>
+</mujoco>`;
@@ -0,0 +1,64 @@
+import assert from "node:assert/strict";
+import { loadHandleBundle, makeHandle, heapF64, PENDULUM_XML, ARM_XML } from "./_harness.mjs";
+
+const STATE_FULLPHYSICS = 4111; // mjSTATE_FULLPHYSICS
+const HEAP_MEMORY = 0;
+const HEAP_ARENA = 4;
+const HEAP_NSTAT = 5;
+
+const ctx = await loadHandleBundle("arena");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const call = (name, ...args) => Module.ccall(name, "number", args.map(() => "number"), args);
+  const malloc = (n) => call("mjwf_mju_malloc", n);
+  const stats = malloc(8 * HEAP_NSTAT);
+  const heapStats = () => {
+    assert.strictEqual(call("mjwf_heap_stats", stats), 1);
+    return Array.from(heapF64(Module, stats, HEAP_NSTAT));
+  };
+  const name = Module.ccall("mjwf_malloc_name", "string", [], []);
+  assert.ok(["dlmalloc", "emmalloc", "mimalloc"].includes(name), name);
+
+  // Contact views are per handle: a second handle stepping does not move the
+  // first handle's contact_pos.
+  const a = makeHandle(Module, PENDULUM_XML, "/a.xml");
+  const b = makeHandle(Module, PENDULUM_XML, "/b.xml");
+  call("mjwf_step", a, 50);
+  assert.ok(call("mjwf_ncon", a) > 0);
+  const ptrA = call("mjwf_contact_pos_ptr", a);
+  const posA = Array.from(heapF64(Module, ptrA, 3 * call("mjwf_ncon", a)));
+  heapF64(Module, call("mjwf_qpos_ptr", b), 8)[1] = 0.3; // ball x (after the hinge)
+  call("mjwf_step", b, 50);
+  const ptrB = call("mjwf_contact_pos_ptr", b);
+  assert.notStrictEqual(ptrA, ptrB);
+  assert.deepStrictEqual(Array.from(heapF64(Module, ptrA, posA.length)), posA);
+  assert.notDeepStrictEqual(Array.from(heapF64(Module, ptrB, 3)), posA.slice(0, 3));
+
+  // Rollout scratch comes from the handle's arena and is reused across calls.
+  const arm = makeHandle(Module, ARM_XML, "/arm.xml");
+  assert.strictEqual(call("mjwf_arena_bytes", arm), 0);
+  const m = call("mjwf_model_ptr", arm);
+  const d = call("mjwf_data_ptr", arm);
+  const state0 = malloc(8 * call("mjwf_mj_stateSize", m, STATE_FULLPHYSICS));
+  Module.ccall("mjwf_mj_getState", null, ["number", "number", "number", "number"], [m, d, state0, STATE_FULLPHYSICS]);
+  const views = malloc(4);
+  new Int32Array(Module.HEAP8.buffer, views, 1).set([Module.ccall("mjwf_view_id", "number", ["string"], ["qpos"])]);
+  const K = 64;
+  const out = malloc(8 * K * 10 * call("mjwf_rollout_stride", arm, views, 1));
+  assert.strictEqual(call("mjwf_rollout", arm, state0, STATE_FULLPHYSICS, 0, K, 10, views, 1, out), 1);
+  const reserved = call("mjwf_arena_bytes", arm);
+  assert.ok(reserved > 0);
+  for (let i = 0; i < 5; i += 1) call("mjwf_rollout", arm, state0, STATE_FULLPHYSICS, 0, K, 10, views, 1, out);
+  assert.strictEqual(call("mjwf_arena_bytes", arm), reserved, "steady state does not grow");
+
+  const s = heapStats();
+  assert.ok(s[HEAP_MEMORY] > 0);
+  assert.ok(s[HEAP_ARENA] >= reserved + call("mjwf_arena_bytes", a) + call("mjwf_arena_bytes", b));
+  call("mjwf_free", arm);
+  assert.strictEqual(call("mjwf_arena_bytes", arm), 0);
+  assert.strictEqual(heapStats()[HEAP_ARENA], s[HEAP_ARENA] - reserved);
+  assert.strictEqual(call("mjwf_heap_stats", 0), 0);
+
+  for (const x of [a, b]) call("mjwf_free", x);
+  console.log(`arena(${mjver}, ${name}): ok`);
+}
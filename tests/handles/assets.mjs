@@ -0,0 +1,104 @@
+import assert from "node:assert/strict";
+import { loadHandleBundle } from "./_harness.mjs";
+
+const STAT = { ENTRIES: 0, BYTES: 1, HITS: 2, MISSES: 3, EVICTIONS: 4, BYTES_READ: 5, DUPLICATE_BYTES: 6 };
+
+const CUBE_OBJ = `v -0.05 -0.05 -0.05
+v 0.05 -0.05 -0.05
+v 0.05 0.05 -0.05
+v -0.05 0.05 -0.05
+v -0.05 -0.05 0.05
+v 0.05 -0.05 0.05
+v 0.05 0.05 0.05
+v -0.05 0.05 0.05
+f 1 3 2
+f 1 4 3
+f 5 6 7
+f 5 7 8
+f 1 2 6
+f 1 6 5
+f 2 3 7
+f 2 7 6
+f 3 4 8
+f 3 8 7
+f 4 1 5
+f 4 5 8
+`;
+
+const variant = (i) => `<mujoco model="variant${i}">
+  <asset><mesh name="cube" file="/assets/cube.obj" scale="1 1 ${1 + 0.1 * i}"/></asset>
+  <worldbody>
+    <geom type="plane" size="1 1 0.1"/>
+    <body pos="0 0 ${0.2 + 0.01 * i}"><freejoint/><geom type="mesh" mesh="cube"/></body>
+  </worldbody>
+</mujoco>`;
+
+const ctx = await loadHandleBundle("assets");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const c = (name, ret, args) => Module.cwrap(name, ret, args);
+  const addFile = c("mjwf_asset_add_file", "number", ["string"]);
+  const clear = c("mjwf_asset_cache_clear", null, []);
+  const setBudget = c("mjwf_asset_cache_set_budget", null, ["number"]);
+  const statsPtr = Module.ccall("mjwf_mju_malloc", "number", ["number"], [8 * 7]);
+  const stats = () => {
+    Module.ccall("mjwf_asset_cache_stats", "number", ["number"], [statsPtr]);
+    return Array.from(new Float64Array(Module.HEAP8.buffer, statsPtr, 7));
+  };
+
+  clear();
+  Module.FS.mkdirTree("/assets");
+  Module.FS.writeFile("/assets/cube.obj", CUBE_OBJ);
+  const size = CUBE_OBJ.length;
+
+  // First add reads and hashes the file; later adds of the unchanged file are hits.
+  assert.strictEqual(addFile("/assets/cube.obj"), 1);
+  const handles = [];
+  for (let i = 0; i < 5; i += 1) {
+    assert.strictEqual(addFile("/assets/cube.obj"), 1);
+    Module.FS.writeFile(`/variant${i}.xml`, variant(i));
+    const h = Module.ccall("mjwf_make_from_xml", "number", ["string"], [`/variant${i}.xml`]);
+    assert.ok(h > 0, Module.ccall("mjwf_errmsg_last_global", "string", [], []));
+    handles.push(h);
+  }
+  let s = stats();
+  assert.strictEqual(s[STAT.ENTRIES], 1);
+  assert.strictEqual(s[STAT.BYTES], size);
+  assert.strictEqual(s[STAT.MISSES], 1);
+  assert.strictEqual(s[STAT.HITS], 5);
+  assert.strictEqual(s[STAT.BYTES_READ], size, "file read once");
+
+  // Loads come from the cache, not the file system.
+  Module.FS.unlink("/assets/cube.obj");
+  Module.FS.writeFile("/variant9.xml", variant(9));
+  const cached = Module.ccall("mjwf_make_from_xml", "number", ["string"], ["/variant9.xml"]);
+  assert.ok(cached > 0, "mesh served from the cache after the file is gone");
+  handles.push(cached);
+
+  // Identical content under another path is detected; changed content is re-read.
+  Module.FS.writeFile("/assets/cube.obj", CUBE_OBJ);
+  Module.FS.writeFile("/assets/cube_copy.obj", CUBE_OBJ);
+  assert.strictEqual(addFile("/assets/cube_copy.obj"), 1);
+  assert.strictEqual(stats()[STAT.DUPLICATE_BYTES], size);
+  Module.FS.writeFile("/assets/cube.obj", `${CUBE_OBJ}# changed\n`);
+  assert.strictEqual(addFile("/assets/cube.obj"), 1);
+  s = stats();
+  assert.strictEqual(s[STAT.MISSES], 3);
+  assert.strictEqual(s[STAT.BYTES_READ], 3 * size + 10);
+
+  // Budget: least recently added entries go first, the newest always stays.
+  setBudget(size + 20);
+  s = stats();
+  assert.strictEqual(s[STAT.ENTRIES], 1);
+  assert.strictEqual(s[STAT.EVICTIONS], 1);
+  setBudget(0);
+
+  assert.strictEqual(addFile("/assets/missing.obj"), 0);
+  assert.strictEqual(Module.ccall("mjwf_errno_last_global", "number", [], []), 151);
+
+  handles.forEach((h) => Module.ccall("mjwf_free", null, ["number"], [h]));
+  clear();
+  assert.strictEqual(stats()[STAT.ENTRIES], 0);
+  Module.ccall("mjwf_mju_free", null, ["number"], [statsPtr]);
+  console.log(`assets(${mjver}): OK`);
+}
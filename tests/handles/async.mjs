@@ -0,0 +1,112 @@
+import assert from "node:assert/strict";
+import { loadHandleBundle, makeHandle, heapF64, PENDULUM_XML, ARM_XML } from "./_harness.mjs";
+
+const MAKE_FAILED = -1;
+const MAKE_PENDING = 0;
+const MAKE_READY = 1;
+
+// Free-floating convex meshes given by many vertices: compiling computes a
+// hull and inertia per mesh, which takes long enough to step meanwhile.
+function meshPileXML(nmesh, nvert) {
+  let seed = 7;
+  const rnd = () => (seed = (seed * 16807) % 2147483647) / 2147483647 - 0.5;
+  const meshes = [];
+  const bodies = [];
+  for (let i = 0; i < nmesh; i += 1) {
+    const v = [];
+    for (let k = 0; k < nvert; k += 1) v.push((0.1 * rnd()).toFixed(5), (0.1 * rnd()).toFixed(5), (0.1 * rnd()).toFixed(5));
+    meshes.push(`<mesh name="m${i}" vertex="${v.join(" ")}"/>`);
+    bodies.push(`<body pos="${(0.3 * i).toFixed(1)} 0 0.5"><freejoint/><geom type="mesh" mesh="m${i}"/></body>`);
+  }
+  return `<mujoco model="meshpile"><asset>${meshes.join("")}</asset>
+  <worldbody><geom type="plane" size="10 10 0.1"/>${bodies.join("")}</worldbody></mujoco>`;
+}
+
+const ctx = await loadHandleBundle("async");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const call = (name, ...args) => Module.ccall(name, "number", args.map(() => "number"), args);
+  const makeAsync = (file) => Module.ccall("mjwf_make_from_xml_async", "number", ["string"], [file]);
+  const errmsg = (h) => Module.ccall("mjwf_errmsg_last", "string", ["number"], [h]);
+  const qpos = (h, n) => Array.from(heapF64(Module, call("mjwf_qpos_ptr", h), n));
+  const tick = () => new Promise((resolve) => setImmediate(resolve));
+  const settle = async (h) => {
+    let status;
+    while ((status = call("mjwf_make_poll", h)) === MAKE_PENDING) await tick();
+    return status;
+  };
+
+  // A completed async make is an ordinary handle.
+  Module.FS.writeFile("/arm.xml", ARM_XML);
+  const sync = makeHandle(Module, ARM_XML, "/arm_sync.xml");
+  const h = makeAsync("/arm.xml");
+  assert.ok(h > 0);
+  assert.strictEqual(await settle(h), MAKE_READY);
+  assert.strictEqual(call("mjwf_make_poll", h), MAKE_READY);
+  assert.strictEqual(call("mjwf_valid", h), 1);
+  assert.strictEqual(call("mjwf_nq", h), 3);
+  for (const x of [sync, h]) {
+    heapF64(Module, call("mjwf_ctrl_ptr", x), 3).set([0.3, 0.1, -0.2]);
+    call("mjwf_step", x, 100);
+  }
+  assert.deepStrictEqual(qpos(h, 3), qpos(sync, 3));
+
+  // Compile errors land on the handle, which stays claimed until freed.
+  Module.FS.writeFile("/bad.xml", "<mujoco><worldbody><body><joint type=\"nope\"/></body></worldbody></mujoco>");
+  for (const file of ["/bad.xml", "/missing.xml"]) {
+    const bad = makeAsync(file);
+    assert.ok(bad > 0, "the failure is reported by poll, not by the call");
+    assert.strictEqual(await settle(bad), MAKE_FAILED);
+    assert.strictEqual(call("mjwf_make_wait", bad), MAKE_FAILED);
+    assert.strictEqual(call("mjwf_valid", bad), 0);
+    assert.strictEqual(call("mjwf_errno_last", bad), 1);
+    assert.ok(errmsg(bad).length > 0, file);
+    assert.strictEqual(call("mjwf_step", bad, 1), 0);
+    call("mjwf_free", bad);
+    assert.strictEqual(errmsg(bad), "");
+  }
+
+  // Other handles keep stepping while a heavy model compiles, and end up
+  // exactly where a handle stepped without the compile running does.
+  Module.FS.writeFile("/pile.xml", meshPileXML(8, 20000));
+  const busy = makeHandle(Module, PENDULUM_XML, "/busy.xml");
+  const ref = makeHandle(Module, PENDULUM_XML, "/ref.xml");
+  const pile = makeAsync("/pile.xml");
+  let steps = 0;
+  let pendingPolls = 0;
+  // CI sets MJWF_EXPECT_THREADS for the pthread bundle, so the threaded branch cannot skip there.
+  assert.ok(!process.env.MJWF_EXPECT_THREADS || call("mjwf_threads") > 1, "expected a pthread bundle");
+  if (call("mjwf_threads") > 1) {
+    assert.strictEqual(call("mjwf_make_poll", pile), MAKE_PENDING);
+    assert.strictEqual(call("mjwf_make_pending"), 1);
+    const added = Module.ccall("mjwf_asset_add_buffer", "number", ["string", "number", "number"], ["/x.bin", call("mjwf_qpos_ptr", busy), 8]);
+    assert.strictEqual(added, 0, "the asset cache is frozen meanwhile");
+    assert.strictEqual(call("mjwf_errno_last_global"), 153);
+    while (call("mjwf_make_poll", pile) === MAKE_PENDING) {
+      pendingPolls += 1;
+      for (let i = 0; i < 20; i += 1) steps += call("mjwf_step", busy, 1);
+      await tick(); // file reads of the compile are proxied to this thread
+    }
+    assert.ok(pendingPolls > 0 && steps > 0, `${steps} steps while compiling`);
+  } else {
+    // Single-threaded bundle: the make ran inside the call.
+    assert.strictEqual(call("mjwf_make_poll", pile), MAKE_READY);
+    steps = call("mjwf_step", busy, 200) ? 200 : 0;
+  }
+  assert.strictEqual(call("mjwf_make_poll", pile), MAKE_READY);
+  assert.strictEqual(call("mjwf_nmesh", pile), 8);
+  call("mjwf_step", ref, steps);
+  const nq = call("mjwf_nq", busy);
+  assert.deepStrictEqual(qpos(busy, nq), qpos(ref, nq));
+  assert.strictEqual(call("mjwf_make_pending"), 0);
+
+  // Freeing a pending handle abandons its job, which cleans up after itself.
+  const gone = makeAsync("/pile.xml");
+  call("mjwf_free", gone);
+  while (call("mjwf_make_pending") > 0) await tick();
+  assert.strictEqual(call("mjwf_make_poll", gone), MAKE_FAILED);
+
+  assert.strictEqual(makeAsync(0), -1);
+  for (const x of [sync, h, busy, ref, pile]) call("mjwf_free", x);
+  console.log(`async(${mjver}): ok${call("mjwf_threads") > 1 ? "" : " (single-threaded bundle: compiles inline)"}`);
+}
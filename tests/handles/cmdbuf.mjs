@@ -0,0 +1,79 @@
+import assert from "node:assert/strict";
+import { loadHandleBundle, makeHandle, heapF64, PENDULUM_XML } from "./_harness.mjs";
+import { CmdBufRunner, CMD, STATUS, decodeContacts } from "../../wrappers/js/mjwf_cmdbuf.mjs";
+
+const ctx = await loadHandleBundle("cmdbuf");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const viewId = (name) => Module.ccall("mjwf_view_id", "number", ["string"], [name]);
+  const qposPtr = Module.cwrap("mjwf_qpos_ptr", "number", ["number"]);
+  const nq = Module.cwrap("mjwf_nq", "number", ["number"]);
+
+  const a = makeHandle(Module, PENDULUM_XML);
+  const b = makeHandle(Module, PENDULUM_XML);
+  const runner = new CmdBufRunner(Module);
+  const CTRL = viewId("ctrl");
+  const SENS = viewId("sensordata");
+  assert.ok(CTRL >= 0 && SENS >= 0, "view ids missing");
+
+  // One tick for two handles: ctrl -> step -> sensors -> contacts, plus save/restore.
+  const w = runner.begin();
+  w.saveState(a, 0);
+  w.setView(a, CTRL, [0.5]).step(a, 10).forward(a).gatherView(a, SENS).gatherContacts(a);
+  w.setView(b, CTRL, [-0.5]).step(b, 10).gatherView(b, SENS, { offset: 1, count: 1 });
+  const reply = runner.run(w);
+  assert.strictEqual(reply.length, 9, "all commands should run");
+  assert.ok(reply.every((r) => r.status === STATUS.OK), "all commands should succeed");
+
+  const sensA = reply[4].payload;
+  assert.strictEqual(reply[4].op, CMD.GATHER_VIEW);
+  assert.strictEqual(sensA.byteLength, 16, "two sensors as f64");
+  assert.ok(sensA.getFloat64(0, true) > 0, "positive torque should move hinge forward");
+  const contacts = decodeContacts(reply[5].payload);
+  assert.ok(contacts.length > 0, "ball should touch the floor");
+  assert.strictEqual(reply[8].payload.byteLength, 8, "sliced gather returns one f64");
+
+  // Per-call path must see the same state as the buffer reports.
+  const qA = heapF64(Module, qposPtr(a), nq(a))[0];
+  assert.strictEqual(qA, sensA.getFloat64(0, true), "jointpos sensor matches qpos");
+
+  // Restore rewinds handle a to the saved state.
+  const r2 = runner.run(runner.begin().restoreState(a, 0).gatherView(a, viewId("qpos"), { count: 1 }));
+  assert.strictEqual(r2[1].payload.getFloat64(0, true), 0, "restore_state rewinds qpos");
+
+  // Failures stop execution and report status.
+  const r3 = runner.run(runner.begin().step(9999, 1).step(a, 1));
+  assert.strictEqual(r3.length, 1);
+  assert.strictEqual(r3[0].status, STATUS.E_HANDLE);
+  const r4 = runner.run(runner.begin().setView(a, SENS, [1]));
+  assert.strictEqual(r4[0].status, STATUS.E_VIEW, "read-only views reject writes");
+
+  // Malformed ranges are rejected before any copy: offset/count past the
+  // view, counts that would wrap offset + count or count * esz, and payloads
+  // shorter than the count they claim.
+  const QPOS = viewId("qpos");
+  const setRaw = (view, offset, count, values) => {
+    const wr = runner.begin();
+    const p = wr.off + 16;
+    wr.setView(a, view, values);
+    wr.view.setInt32(p, offset, true);
+    wr.view.setInt32(p + 4, count, true);
+    return runner.run(wr)[0].status;
+  };
+  const ctrl0 = Module.ccall("mjwf_ctrl_ptr", "number", ["number"], [a]);
+  const before = heapF64(Module, ctrl0, 1)[0];
+  for (const [offset, count] of [[1, 0x7fffffff], [0x7fffffff, 1], [-1, 1], [0, 2], [1, 1]]) {
+    assert.strictEqual(setRaw(CTRL, offset, count, [7]), STATUS.E_RANGE, `set_view offset=${offset} count=${count}`);
+  }
+  assert.strictEqual(setRaw(QPOS, 0, nq(a), [7]), STATUS.E_RANGE, "payload shorter than count");
+  assert.strictEqual(heapF64(Module, ctrl0, 1)[0], before, "rejected records write nothing");
+  for (const [offset, count] of [[1, 0x7fffffff], [0x7fffffff, 1], [nq(a) + 1, -1]]) {
+    const r = runner.run(runner.begin().gatherView(a, QPOS, { offset, count }));
+    assert.strictEqual(r[0].status, STATUS.E_RANGE, `gather_view offset=${offset} count=${count}`);
+  }
+
+  runner.dispose();
+  Module.ccall("mjwf_free", null, ["number"], [a]);
+  Module.ccall("mjwf_free", null, ["number"], [b]);
+  console.log(`cmdbuf(${mjver}) OK`);
+}
@@ -0,0 +1,83 @@
+import assert from "node:assert/strict";
+import { loadHandleBundle, makeHandle, heapF64, PENDULUM_XML } from "./_harness.mjs";
+
+const ctx = await loadHandleBundle("collide");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const c = (name, ret, args) => Module.cwrap(name, ret, args);
+  const malloc = c("mjwf_mju_malloc", "number", ["number"]);
+  const free = c("mjwf_mju_free", null, ["number"]);
+  const collide = c("mjwf_collision_batch", "number",
+    ["number", "number", "number", "number", "number", "number", "number"]);
+
+  const h = makeHandle(Module, PENDULUM_XML);
+  const nq = Module.ccall("mjwf_nq", "number", ["number"], [h]);
+  assert.strictEqual(nq, 8, "hinge + freejoint");
+
+  // qpos = [hinge, ball x y z, quat]; ball radius 0.05, link capsule spans z 0.8..1 at x 0.
+  const configs = [
+    [0, 0.5, 0, 0.5, 1, 0, 0, 0],   // ball in the air
+    [0, 0.5, 0, 0.02, 1, 0, 0, 0],  // ball sunk 3 cm into the floor
+    [0, 0, 0, 0.9, 1, 0, 0, 0],     // ball through the link
+    [1.2, 0.5, 0, 1.5, 1, 0, 0, 0], // swung link, ball high
+  ];
+  const K = configs.length;
+  const qpos = malloc(8 * nq * K);
+  const flags = malloc(K);
+  const ncon = malloc(4 * K);
+  const mind = malloc(8 * K);
+  heapF64(Module, qpos, nq * K).set(configs.flat());
+
+  assert.strictEqual(collide(h, qpos, K, 0, flags, ncon, mind), 2, "two colliding configurations");
+  const F = Array.from(Module.HEAPU8.subarray(flags, flags + K));
+  const N = Array.from(new Int32Array(Module.HEAP8.buffer, ncon, K));
+  const M = Array.from(heapF64(Module, mind, K));
+  assert.deepStrictEqual(F, [0, 1, 1, 0]);
+  assert.ok(Math.abs(M[1] + 0.03) < 1e-9, `floor penetration ${M[1]}`);
+  assert.ok(M[2] < 0, "ball/link overlap");
+  assert.ok(M[0] > 1e20 && N[0] === 0, "no contact reports mjMAXVAL");
+
+  // Same answers as the full set_qpos + forward path on the handle.
+  const setQpos = c("mjwf_set_qpos", null, ["number", "number", "number"]);
+  for (let k = 0; k < K; k += 1) {
+    setQpos(h, qpos + 8 * nq * k, nq);
+    Module.ccall("mjwf_forward", "number", ["number"], [h]);
+    assert.strictEqual(Module.ccall("mjwf_ncon", "number", ["number"], [h]), N[k], `config ${k} ncon`);
+  }
+
+  // The batch leaves the handle's own state alone; outputs are optional.
+  setQpos(h, qpos, nq);
+  const now = Array.from(heapF64(Module, Module.ccall("mjwf_qpos_ptr", "number", ["number"], [h]), nq));
+  assert.strictEqual(collide(h, qpos, K, 0, 0, 0, 0), 2, "count without outputs");
+  assert.deepStrictEqual(Array.from(heapF64(Module, Module.ccall("mjwf_qpos_ptr", "number", ["number"], [h]), nq)), now);
+  // A positive threshold also flags near misses.
+  assert.ok(collide(h, qpos, K, 1, flags, 0, 0) >= 2);
+  assert.strictEqual(collide(h, qpos, 0, 0, flags, 0, 0), -1, "empty batch is an error");
+
+  // Flex vertices follow each configuration (mj_flex runs before mj_collision).
+  const rope = makeHandle(Module, `<mujoco model="rope">
+    <worldbody>
+      <geom type="plane" size="1 1 0.1"/>
+      <flexcomp name="rope" type="grid" count="3 1 1" spacing="0.1 0.1 0.1" dim="1" radius="0.02" mass="0.1" pos="0 0 0.5"/>
+    </worldbody>
+  </mujoco>`, "/rope.xml");
+  const rnq = Module.ccall("mjwf_nq", "number", ["number"], [rope]);
+  assert.strictEqual(rnq, 9, "three vertex bodies with x/y/z slides");
+  const lowered = Array.from({ length: rnq }, (_, i) => (i % 3 === 2 ? -0.49 : 0)); // vertices at z 0.01
+  const rq = malloc(8 * rnq * 2);
+  heapF64(Module, rq, rnq * 2).set([...new Array(rnq).fill(0), ...lowered]);
+  assert.strictEqual(collide(rope, rq, 2, 0, flags, ncon, 0), 1, "only the lowered rope touches the floor");
+  assert.deepStrictEqual(Array.from(Module.HEAPU8.subarray(flags, flags + 2)), [0, 1]);
+  const RN = Array.from(new Int32Array(Module.HEAP8.buffer, ncon, 2));
+  for (let k = 0; k < 2; k += 1) {
+    setQpos(rope, rq + 8 * rnq * k, rnq);
+    Module.ccall("mjwf_forward", "number", ["number"], [rope]);
+    assert.strictEqual(Module.ccall("mjwf_ncon", "number", ["number"], [rope]), RN[k], `rope config ${k} ncon`);
+  }
+  free(rq);
+  Module.ccall("mjwf_free", null, ["number"], [rope]);
+
+  [qpos, flags, ncon, mind].forEach((p) => free(p));
+  Module.ccall("mjwf_free", null, ["number"], [h]);
+  console.log(`collide(${mjver}) OK`);
+}
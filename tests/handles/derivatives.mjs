@@ -0,0 +1,90 @@
+import assert from "node:assert/strict";
+import { loadHandleBundle, makeHandle, heapF64, PENDULUM_XML } from "./_harness.mjs";
+
+const STATE_INTEGRATION = 8191; // mjSTATE_INTEGRATION
+const DERIV_SENSORS = 2;
+
+const ctx = await loadHandleBundle("derivatives");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const c = (name, ret, args) => Module.cwrap(name, ret, args);
+  const modelPtr = c("mjwf_model_ptr", "number", ["number"]);
+  const dataPtr = c("mjwf_data_ptr", "number", ["number"]);
+  const stateSize = c("mjwf_mj_stateSize", "number", ["number", "number"]);
+  const getState = c("mjwf_mj_getState", null, ["number", "number", "number", "number"]);
+  const setState = c("mjwf_mj_setState", null, ["number", "number", "number", "number"]);
+  const transitionFD = c("mjwf_mjd_transitionFD", null,
+    ["number", "number", "number", "number", "number", "number", "number", "number"]);
+  const stride = c("mjwf_transition_fd_stride", "number", ["number", "number"]);
+  const batch = c("mjwf_transition_fd_batch", "number",
+    ["number", "number", "number", "number", "number", "number", "number", "number"]);
+  const inverseFD = c("mjwf_mjd_inverseFD", null,
+    ["number", "number", "number", "number", "number", "number", "number", "number", "number", "number", "number"]);
+  const inverseBatch = c("mjwf_inverse_fd_batch", "number",
+    ["number", "number", "number", "number", "number", "number", "number", "number"]);
+  const malloc = c("mjwf_mju_malloc", "number", ["number"]);
+  const free = c("mjwf_mju_free", null, ["number"]);
+  const step = c("mjwf_step", "number", ["number", "number"]);
+
+  const h = makeHandle(Module, PENDULUM_XML);
+  const m = modelPtr(h);
+  const d = dataPtr(h);
+  const nv = Module.ccall("mjwf_nv", "number", ["number"], [h]);
+  const nu = Module.ccall("mjwf_nu", "number", ["number"], [h]);
+  const ns = Module.ccall("mjwf_nsensordata", "number", ["number"], [h]);
+  const ndx = 2 * nv;
+  const T = 8;
+  const nstate = stateSize(m, STATE_INTEGRATION);
+  const S = stride(h, DERIV_SENSORS);
+  assert.strictEqual(S, ndx * ndx + ndx * nu + ns * (ndx + nu), "stride layout");
+
+  // Record a short trajectory.
+  const states = malloc(8 * T * nstate);
+  for (let t = 0; t < T; t += 1) {
+    getState(m, d, states + 8 * t * nstate, STATE_INTEGRATION);
+    step(h, 5);
+  }
+  const out = malloc(8 * T * S);
+  assert.strictEqual(batch(h, states, STATE_INTEGRATION, 0, T, 1e-6, DERIV_SENSORS, out), 1, "batch failed");
+
+  // Per-call reference on the handle's own data, sensor Jacobians C, D included.
+  const near = (got, ref, what) =>
+    ref.forEach((v, i) => assert.ok(Math.abs(v - got[i]) <= 1e-9 * (1 + Math.abs(v)), `${what} entry ${i}: ${got[i]} vs ${v}`));
+  const A = malloc(8 * ndx * ndx);
+  const B = malloc(8 * ndx * nu);
+  const C = malloc(8 * ns * ndx);
+  const D = malloc(8 * ns * nu);
+  for (let t = 0; t < T; t += 1) {
+    setState(m, d, states + 8 * t * nstate, STATE_INTEGRATION);
+    transitionFD(m, d, 1e-6, 0, A, B, C, D);
+    const got = heapF64(Module, out + 8 * t * S, S);
+    near(got, [...heapF64(Module, A, ndx * ndx), ...heapF64(Module, B, ndx * nu),
+      ...heapF64(Module, C, ns * ndx), ...heapF64(Module, D, ns * nu)], `transition t=${t}`);
+  }
+
+  // Inverse dynamics: DfDq | DfDv | DfDa per step against mjd_inverseFD.
+  const nv2 = nv * nv;
+  assert.strictEqual(Module.ccall("mjwf_inverse_fd_stride", "number", ["number"], [h]), 3 * nv2);
+  const qaccs = malloc(8 * T * nv);
+  heapF64(Module, qaccs, T * nv).forEach((_, i, a) => { a[i] = 0.5 - 0.1 * i; });
+  const inv = malloc(8 * T * 3 * nv2);
+  assert.strictEqual(inverseBatch(h, states, STATE_INTEGRATION, qaccs, T, 1e-6, 0, inv), 1, "inverse batch failed");
+  const F = malloc(8 * 3 * nv2);
+  for (let t = 0; t < T; t += 1) {
+    setState(m, d, states + 8 * t * nstate, STATE_INTEGRATION);
+    heapF64(Module, Module.ccall("mjwf_qacc_ptr", "number", ["number"], [h]), nv).set(heapF64(Module, qaccs + 8 * t * nv, nv));
+    inverseFD(m, d, 1e-6, 0, F, F + 8 * nv2, F + 16 * nv2, 0, 0, 0, 0);
+    near(heapF64(Module, inv + 8 * t * 3 * nv2, 3 * nv2), [...heapF64(Module, F, 3 * nv2)], `inverse t=${t}`);
+  }
+
+  // State signatures outside mjtState are rejected before any work.
+  for (const sig of [0, -1, 1 << 13]) {
+    assert.strictEqual(batch(h, states, sig, 0, T, 1e-6, 0, out), 0, `sig ${sig}`);
+    assert.strictEqual(Module.ccall("mjwf_errno_last", "number", ["number"], [h]), 42);
+    assert.strictEqual(inverseBatch(h, states, sig, qaccs, T, 1e-6, 0, inv), 0, `inverse sig ${sig}`);
+  }
+
+  [states, out, A, B, C, D, qaccs, inv, F].forEach((p) => free(p));
+  Module.ccall("mjwf_free", null, ["number"], [h]);
+  console.log(`derivatives(${mjver}) OK`);
+}
@@ -0,0 +1,76 @@
+import assert from "node:assert/strict";
+import { loadHandleBundle, makeHandle, heapF64, PENDULUM_XML } from "./_harness.mjs";
+
+const BOX_XML = `<mujoco model="box">
+  <worldbody>
+    <body name="box"><freejoint/><geom type="box" size="0.05 0.05 0.05"/></body>
+  </worldbody>
+</mujoco>`;
+
+const ctx = await loadHandleBundle("edit");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const c = (name, ret, args) => Module.cwrap(name, ret, args);
+  const malloc = c("mjwf_mju_malloc", "number", ["number"]);
+  const free = c("mjwf_mju_free", null, ["number"]);
+  const dim = (name, h) => Module.ccall(`mjwf_${name}`, "number", ["number"], [h]);
+  const ptr = (name, h, n) => heapF64(Module, Module.ccall(`mjwf_${name}_ptr`, "number", ["number"], [h]), n);
+  const generation = c("mjwf_model_generation", "number", ["number"]);
+  const recompile = c("mjwf_recompile", "number", ["number"]);
+  const errno = c("mjwf_errno_last", "number", ["number"]);
+  const editBody = c("mjwf_edit_body", "number", ["number", "string", "number", "number"]);
+  const editAttach = c("mjwf_edit_attach", "number", ["number", "string", "string", "string", "number"]);
+  const editDelete = c("mjwf_edit_delete", "number", ["number", "number", "string"]);
+  const vec = malloc(8 * 3);
+  const setVec = (...v) => { heapF64(Module, vec, 3).set(v); return vec; };
+
+  Module.FS.writeFile("/edit_base.xml", PENDULUM_XML);
+  Module.FS.writeFile("/edit_box.xml", BOX_XML);
+  const h = Module.ccall("mjwf_make_editable", "number", ["string"], ["/edit_base.xml"]);
+  assert.ok(h > 0, "make_editable");
+  assert.ok(Module.ccall("mjwf_spec_ptr", "number", ["number"], [h]) !== 0);
+  ptr("ctrl", h, 1)[0] = 0.3;
+  Module.ccall("mjwf_step", "number", ["number", "number"], [h, 100]);
+  const nq = dim("nq", h);
+  const qpos = Array.from(ptr("qpos", h, nq));
+  const qvel = Array.from(ptr("qvel", h, dim("nv", h)));
+  const capsuleZ = ptr("geom_xpos", h, 3 * dim("ngeom", h))[5];
+  assert.strictEqual(Module.ccall("mjwf_state_save", "number", ["number", "number"], [h, 0]), 1);
+
+  // Move a body: state carries over, the new geometry shows up without stepping.
+  const gen0 = generation(h);
+  assert.strictEqual(editBody(h, "link", setVec(0, 0, 1.5), 0), 1);
+  assert.strictEqual(recompile(h), 1, Module.ccall("mjwf_errmsg_last", "string", ["number"], [h]));
+  assert.notStrictEqual(generation(h), gen0);
+  assert.deepStrictEqual(Array.from(ptr("qpos", h, nq)), qpos, "qpos preserved");
+  assert.deepStrictEqual(Array.from(ptr("qvel", h, qvel.length)), qvel, "qvel preserved");
+  assert.ok(Math.abs(ptr("geom_xpos", h, 3 * dim("ngeom", h))[5] - (capsuleZ + 0.5)) < 1e-9, "moved");
+  assert.strictEqual(Module.ccall("mjwf_state_restore", "number", ["number", "number"], [h, 0]), 0,
+    "state slots are dropped with the old model");
+
+  // Add a body from another file, then delete it again.
+  assert.strictEqual(editAttach(h, "", "/edit_box.xml", "extra/", setVec(1, 0, 0.5)), 1);
+  assert.strictEqual(recompile(h), 1);
+  assert.strictEqual(dim("nq", h), nq + 7);
+  assert.deepStrictEqual(Array.from(ptr("qpos", h, nq)), qpos, "existing joints keep their qpos");
+  assert.strictEqual(editDelete(h, 1 /* mjOBJ_BODY */, "extra/box"), 1);
+  assert.strictEqual(recompile(h), 1);
+  assert.strictEqual(dim("nq", h), nq);
+  Module.ccall("mjwf_step", "number", ["number", "number"], [h, 10]);
+
+  // Errors: unknown element, non-editable handle, shared model.
+  assert.strictEqual(editBody(h, "nope", vec, 0), 0);
+  assert.strictEqual(errno(h), 141);
+  const plain = makeHandle(Module, PENDULUM_XML);
+  assert.strictEqual(editBody(plain, "link", vec, 0), 0);
+  assert.strictEqual(errno(plain), 140);
+  const share = Module.ccall("mjwf_make_shared", "number", ["number"], [h]);
+  assert.strictEqual(recompile(h), 0);
+  assert.strictEqual(errno(h), 144);
+  Module.ccall("mjwf_free", null, ["number"], [share]);
+
+  free(vec);
+  Module.ccall("mjwf_free", null, ["number"], [plain]);
+  Module.ccall("mjwf_free", null, ["number"], [h]);
+  console.log(`edit(${mjver}): OK`);
+}
@@ -0,0 +1,87 @@
+import assert from "node:assert/strict";
+import { loadHandleBundle, makeHandle, heapF64, ARM_XML } from "./_harness.mjs";
+
+const OBJ_BODY = 1; // mjOBJ_BODY
+const OBJ_SITE = 6; // mjOBJ_SITE
+const FK_JACOBIAN = 1;
+const FK_QUAT = 2;
+
+const ctx = await loadHandleBundle("fk");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const c = (name, ret, args) => Module.cwrap(name, ret, args);
+  const malloc = c("mjwf_mju_malloc", "number", ["number"]);
+  const free = c("mjwf_mju_free", null, ["number"]);
+  const stride = c("mjwf_fk_stride", "number", ["number", "number"]);
+  const fk = c("mjwf_fk_batch", "number",
+    ["number", "number", "number", "number", "number", "number", "number"]);
+  const near = (a, b, what) => assert.ok(Math.abs(a - b) < 1e-9, `${what}: ${a} vs ${b}`);
+
+  const h = makeHandle(Module, ARM_XML);
+  const name2id = (type, name) => Module.ccall("mjwf_name2id", "number", ["number", "number", "string"], [h, type, name]);
+  const nv = Module.ccall("mjwf_nv", "number", ["number"], [h]);
+  assert.strictEqual(stride(h, 0), 12);
+  assert.strictEqual(stride(h, FK_QUAT), 7);
+  assert.strictEqual(stride(h, FK_JACOBIAN), 12 + 6 * nv);
+
+  // Planar arm: link lengths 0.3, 0.25, 0.2 at z = 0.1.
+  const L = [0.3, 0.25, 0.2];
+  const planar = (q) => {
+    const pts = [[0, 0]];
+    let a = 0;
+    for (let i = 0; i < 3; i += 1) {
+      a += q[i];
+      const [x, y] = pts[i];
+      pts.push([x + L[i] * Math.cos(a), y + L[i] * Math.sin(a)]);
+    }
+    return pts; // joint origins 0..2, end effector 3
+  };
+  const configs = [[0, 0, 0], [Math.PI / 2, 0, 0], [0.3, -0.6, 0.9]];
+  const K = configs.length;
+  const qpos = malloc(8 * 3 * K);
+  heapF64(Module, qpos, 3 * K).set(configs.flat());
+  const objs = malloc(4 * 4);
+  new Int32Array(Module.HEAP8.buffer, objs, 4).set([
+    OBJ_SITE, name2id(OBJ_SITE, "ee"), OBJ_BODY, name2id(OBJ_BODY, "l1"),
+  ]);
+
+  // Poses and Jacobians.
+  const sj = stride(h, FK_JACOBIAN);
+  const out = malloc(8 * K * 2 * sj);
+  assert.strictEqual(fk(h, qpos, K, objs, 2, FK_JACOBIAN, out), 1, "fk_batch failed");
+  const O = heapF64(Module, out, K * 2 * sj);
+  configs.forEach((q, k) => {
+    const pts = planar(q);
+    const ee = O.subarray(k * 2 * sj, k * 2 * sj + sj);
+    near(ee[0], pts[3][0], `config ${k} ee x`);
+    near(ee[1], pts[3][1], `config ${k} ee y`);
+    near(ee[2], 0.1, `config ${k} ee z`);
+    const a = q[0] + q[1] + q[2];
+    near(ee[3], Math.cos(a), `config ${k} ee xmat[0]`);
+    near(ee[4], -Math.sin(a), `config ${k} ee xmat[1]`);
+    for (let j = 0; j < 3; j += 1) {
+      near(ee[12 + j], -(pts[3][1] - pts[j][1]), `config ${k} jacp x/${j}`);
+      near(ee[12 + nv + j], pts[3][0] - pts[j][0], `config ${k} jacp y/${j}`);
+      near(ee[12 + 3 * nv + 2 * nv + j], 1, `config ${k} jacr z/${j}`);
+    }
+    const body = O.subarray(k * 2 * sj + sj, (k + 1) * 2 * sj);
+    near(body[0], 0, `config ${k} l1 x`);
+    near(body[2], 0.1, `config ${k} l1 z`);
+  });
+
+  // Quaternion layout.
+  const sq = stride(h, FK_QUAT);
+  assert.strictEqual(fk(h, qpos, K, objs, 2, FK_QUAT, out), 1);
+  // config 1 (j1 = pi/2), object 1 (body l1)
+  const l1 = heapF64(Module, out, K * 2 * sq).subarray(3 * sq, 4 * sq);
+  [Math.SQRT1_2, 0, 0, Math.SQRT1_2].forEach((v, i) => near(Math.abs(l1[3 + i]), v, `l1 quat ${i}`));
+
+  // Invalid object ids are rejected up front.
+  new Int32Array(Module.HEAP8.buffer, objs, 2).set([OBJ_SITE, 99]);
+  assert.strictEqual(fk(h, qpos, K, objs, 1, 0, out), 0, "bad site id");
+  assert.ok(Module.ccall("mjwf_errno_last", "number", ["number"], [h]) !== 0);
+
+  [qpos, objs, out].forEach((p) => free(p));
+  Module.ccall("mjwf_free", null, ["number"], [h]);
+  console.log(`fk(${mjver}) OK`);
+}
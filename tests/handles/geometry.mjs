@@ -0,0 +1,80 @@
+import assert from "node:assert/strict";
+import { loadHandleBundle, makeHandle } from "./_harness.mjs";
+
+// Two inline meshes and one heightfield, so the tables have more than one row.
+const XML = `<mujoco model="geometry">
+  <asset>
+    <mesh name="tet" vertex="0 0 0  1 0 0  0 1 0  0 0 1" face="0 2 1  0 1 3  0 3 2  1 2 3"/>
+    <mesh name="tet2" vertex="0 0 0  2 0 0  0 2 0  0 0 2" face="0 2 1  0 1 3  0 3 2  1 2 3"/>
+    <hfield name="terrain" nrow="3" ncol="4" size="1 1 0.2 0.1"
+            elevation="0 1 2 3  1 2 3 4  2 3 4 5"/>
+  </asset>
+  <worldbody>
+    <geom type="hfield" hfield="terrain"/>
+    <body pos="0 0 1"><freejoint/><geom type="mesh" mesh="tet"/></body>
+    <body pos="1 0 1"><freejoint/><geom type="mesh" mesh="tet2"/></body>
+  </worldbody>
+</mujoco>`;
+
+const ctx = await loadHandleBundle("geometry");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const h = makeHandle(Module, XML);
+  const call = (name, ...args) => Module.ccall(name, "number", args.map(() => "number"), args);
+
+  const size = call("mjwf_geometry_manifest_size", h);
+  const buf = Module.ccall("mjwf_mju_malloc", "number", ["number"], [size]);
+  assert.strictEqual(call("mjwf_geometry_manifest", h, buf, size - 1), 0, "short buffer rejected");
+  assert.strictEqual(Module.ccall("mjwf_errno_last", "number", ["number"], [h]), 160);
+  assert.strictEqual(call("mjwf_geometry_manifest", h, buf, size), size);
+
+  const dv = new DataView(Module.HEAP8.buffer, buf, size);
+  const i32 = (off) => dv.getInt32(off, true);
+  const addr = (off) => Number(dv.getBigUint64(off, true));
+  const [version, nmesh, nhfield, nmeshvert, nmeshnormal, nmeshface, nhfielddata, meshTable, hfieldTable] =
+    Array.from({ length: 9 }, (_, i) => i32(4 * i));
+  assert.strictEqual(version, 1);
+  assert.strictEqual(nmesh, 2);
+  assert.strictEqual(nmesh, call("mjwf_nmesh", h));
+  assert.strictEqual(nhfield, 1);
+  assert.strictEqual(nhfield, call("mjwf_nhfield", h));
+  assert.strictEqual(nhfielddata, 12);
+  assert.strictEqual(nmeshface, 8);
+
+  // Addresses are the same memory as the generated views.
+  assert.strictEqual(addr(40), call("mjwf_mesh_vert_ptr", h));
+  assert.strictEqual(addr(48), call("mjwf_mesh_normal_ptr", h));
+  assert.strictEqual(addr(56), call("mjwf_mesh_face_ptr", h));
+  assert.strictEqual(addr(64), call("mjwf_mesh_facenormal_ptr", h));
+  assert.strictEqual(addr(72), call("mjwf_hfield_data_ptr", h));
+  assert.strictEqual(addr(80), call("mjwf_hfield_size_ptr", h));
+
+  // Mesh rows match the adr/num views and tile the pooled arrays.
+  const view = (name, n) => new Int32Array(Module.HEAP8.buffer, call(`mjwf_${name}_ptr`, h), n);
+  const cols = { vertadr: 0, vertnum: 1, faceadr: 2, facenum: 3, normaladr: 4, normalnum: 5 };
+  let verts = 0;
+  let faces = 0;
+  for (let i = 0; i < nmesh; i += 1) {
+    for (const [name, c] of Object.entries(cols)) {
+      assert.strictEqual(i32(meshTable + 4 * (6 * i + c)), view(`mesh_${name}`, nmesh)[i], `mesh ${i} ${name}`);
+    }
+    verts += i32(meshTable + 4 * (6 * i + 1));
+    faces += i32(meshTable + 4 * (6 * i + 3));
+  }
+  assert.strictEqual(verts, nmeshvert);
+  assert.strictEqual(faces, nmeshface);
+  assert.ok(nmeshnormal > 0);
+
+  // Face indices are local to the mesh.
+  const face = view("mesh_face", 3 * nmeshface);
+  const second = i32(meshTable + 4 * (6 + 2));
+  for (let k = 3 * second; k < 3 * nmeshface; k += 1) assert.ok(face[k] >= 0 && face[k] < 4);
+
+  assert.deepStrictEqual([i32(hfieldTable), i32(hfieldTable + 4), i32(hfieldTable + 8)], [0, 3, 4]);
+  const elev = new Float32Array(Module.HEAP8.buffer, addr(72), nhfielddata);
+  assert.ok(Math.abs(Math.min(...elev)) < 1e-6 && Math.abs(Math.max(...elev) - 1) < 1e-6, "elevation normalized");
+
+  Module.ccall("mjwf_mju_free", null, ["number"], [buf]);
+  Module.ccall("mjwf_free", null, ["number"], [h]);
+  console.log(`geometry(${mjver}): OK`);
+}
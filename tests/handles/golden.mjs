@@ -0,0 +1,77 @@
+import assert from "node:assert/strict";
+import { spawnSync } from "node:child_process";
+import fs from "node:fs";
+import os from "node:os";
+import path from "node:path";
+import { loadHandleBundle, heapF64, PENDULUM_XML, ARM_XML } from "./_harness.mjs";
+import { readGolden, compareGolden, recordGolden } from "./_golden.mjs";
+
+// MJ_NATIVE_BIN (mujoco_compare3xx) regenerates goldens for the built-in
+// models and compares full state against them; MJWF_GOLDEN_DIR compares a
+// pre-generated set (e.g. the model zoo) instead. CI must compare against
+// native: there a missing MJ_NATIVE_BIN fails rather than skips.
+const ctx = await loadHandleBundle("golden");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const call = (name, ...args) => Module.ccall(name, "number", args.map(() => "number"), args);
+  const tmp = fs.mkdtempSync(path.join(os.tmpdir(), "mjwf-golden-"));
+  const models = [["pendulum.xml", PENDULUM_XML], ["arm.xml", ARM_XML]].map(([name, xml]) => {
+    fs.writeFileSync(path.join(tmp, name), xml);
+    return path.join(tmp, name);
+  });
+
+  // Format round trip on the WASM writer: the bundle reproduces itself exactly,
+  // and a changed model is caught at the first step and field it affects.
+  const self = path.join(tmp, "self");
+  const fields = ["time", "qpos", "qvel", "act", "sensordata", "qacc", "ctrl"];
+  recordGolden(Module, self, models, { steps: 200, fields });
+  const golden = readGolden(self);
+  assert.strictEqual(golden.models.length, 2);
+  for (const entry of golden.models) {
+    const r = compareGolden(Module, entry);
+    assert.ok(r.ok, `${entry.model}: ${JSON.stringify(r.first)}`);
+    assert.strictEqual(r.steps, 200);
+    assert.ok(Object.values(r.fields).every((e) => e === 0));
+  }
+  const pend = golden.models[0];
+  assert.strictEqual(pend.fields.find((f) => f.name === "ctrl").data[0], Math.sin(0), "ctrl pattern recorded");
+  const kicked = compareGolden(Module, pend, {
+    prepare: (h) => { heapF64(Module, call("mjwf_qvel_ptr", h), 1)[0] = 1; },
+  });
+  assert.ok(!kicked.ok);
+  assert.deepStrictEqual([kicked.first.step, kicked.first.field, kicked.first.element], [1, "qpos", 0]);
+  const loose = compareGolden(Module, pend, {
+    steps: 5,
+    prepare: (h) => { heapF64(Module, call("mjwf_qvel_ptr", h), 1)[0] = 1e-6; },
+    tol: Object.fromEntries(fields.map((f) => [f, { atol: 1e-3, rtol: 0 }])),
+  });
+  assert.ok(loose.ok, "tolerance absorbs a tiny change");
+  assert.throws(() => compareGolden(Module, { ...pend, nq: pend.nq + 1 }), /nq/);
+
+  // Native goldens: generated on a thread pool, compared with the manifest's tolerances.
+  const sets = [];
+  assert.ok(process.env.MJ_NATIVE_BIN || !process.env.CI, "MJ_NATIVE_BIN is required under CI");
+  if (process.env.MJ_NATIVE_BIN) {
+    assert.ok(fs.existsSync(process.env.MJ_NATIVE_BIN), `MJ_NATIVE_BIN: ${process.env.MJ_NATIVE_BIN} missing`);
+    const out = path.join(tmp, "native");
+    const run = spawnSync(process.env.MJ_NATIVE_BIN,
+      ["--golden", out, "--steps", "500", "--threads", "2", "--fields", fields.join(","), ...models], { encoding: "utf8" });
+    assert.strictEqual(run.status, 0, run.stderr);
+    sets.push(out);
+  }
+  if (process.env.MJWF_GOLDEN_DIR) sets.push(process.env.MJWF_GOLDEN_DIR);
+  for (const dir of sets) {
+    const set = readGolden(dir);
+    assert.deepStrictEqual(set.failed, [], `${dir}: models the native side could not run`);
+    const failed = [];
+    for (const entry of set.models) {
+      const r = compareGolden(Module, entry);
+      if (!r.ok) failed.push(`${entry.model}: ${JSON.stringify(r.first)}`);
+    }
+    assert.deepStrictEqual(failed, [], `native ${set.mjversion} vs wasm ${mjver}`);
+    console.log(`golden(${mjver}): ${set.models.length} models x ${set.steps} steps match ${dir}`);
+  }
+
+  fs.rmSync(tmp, { recursive: true, force: true });
+  console.log(`golden(${mjver}): ok`);
+}
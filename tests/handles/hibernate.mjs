@@ -0,0 +1,107 @@
+import assert from "node:assert/strict";
+import { loadHandleBundle, makeHandle, heapF64, PENDULUM_XML, ARM_XML } from "./_harness.mjs";
+
+const RES_LIVE = 0;
+const RES_AWAKE = 1;
+const RES_HIBERNATED = 2;
+const RES_DATA = 3;
+const RES_BLOB = 4;
+const RES_SPARE = 5;
+const RES_WAKES = 7;
+const RES_NSTAT = 8;
+
+const ctx = await loadHandleBundle("hibernate");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const call = (name, ...args) => Module.ccall(name, "number", args.map(() => "number"), args);
+  const stats = call("mjwf_mju_malloc", 8 * RES_NSTAT);
+  const resident = () => {
+    assert.strictEqual(call("mjwf_resident_stats", stats), 1);
+    return Array.from(heapF64(Module, stats, RES_NSTAT));
+  };
+  const qpos = (h) => Array.from(heapF64(Module, call("mjwf_qpos_ptr", h), 3));
+  const asleep = (hs) => hs.map((h) => call("mjwf_is_hibernated", h));
+
+  // A hibernated twin continues exactly like one that stayed awake: the blob
+  // carries controls and warmstart, not just qpos/qvel.
+  const a = makeHandle(Module, ARM_XML, "/a.xml");
+  const b = makeHandle(Module, ARM_XML, "/b.xml");
+  for (const h of [a, b]) {
+    heapF64(Module, call("mjwf_ctrl_ptr", h), 3).set([0.4, -0.2, 0.1]);
+    call("mjwf_step", h, 100);
+  }
+  const before = resident();
+  assert.strictEqual(before[RES_LIVE], 2);
+  assert.strictEqual(call("mjwf_hibernate", a), 1);
+  assert.strictEqual(call("mjwf_hibernate", a), 1, "hibernating twice is a no-op");
+  const slept = resident();
+  assert.deepStrictEqual(asleep([a, b]), [1, 0], "stats and is_hibernated do not wake");
+  assert.strictEqual(slept[RES_LIVE], 2);
+  assert.strictEqual(slept[RES_AWAKE], 1);
+  assert.strictEqual(slept[RES_HIBERNATED], 1);
+  const released = before[RES_DATA] - slept[RES_DATA];
+  assert.ok(released > 0 && slept[RES_BLOB] > 0 && slept[RES_BLOB] < released / 10,
+    `blob ${slept[RES_BLOB]} B vs mjData ${released} B`);
+
+  for (const h of [a, b]) call("mjwf_step", h, 100);
+  assert.deepStrictEqual(asleep([a, b]), [0, 0]);
+  assert.deepStrictEqual(qpos(a), qpos(b));
+  assert.deepStrictEqual(Array.from(heapF64(Module, call("mjwf_ctrl_ptr", a), 3)), [0.4, -0.2, 0.1]);
+  assert.strictEqual(resident()[RES_WAKES], slept[RES_WAKES] + 1);
+
+  // View access wakes too, with derived quantities recomputed.
+  call("mjwf_hibernate", b);
+  assert.deepStrictEqual(qpos(b), qpos(a));
+  assert.strictEqual(call("mjwf_is_hibernated", b), 0);
+  call("mjwf_forward", a);
+  const xpos = (h) => Array.from(heapF64(Module, call("mjwf_geom_xpos_ptr", h), 9));
+  assert.deepStrictEqual(xpos(b), xpos(a));
+
+  // Freeing a hibernated handle drops its blob.
+  const c = makeHandle(Module, PENDULUM_XML, "/c.xml");
+  call("mjwf_hibernate", c);
+  const withC = resident();
+  call("mjwf_free", c);
+  const withoutC = resident();
+  assert.strictEqual(withoutC[RES_LIVE], withC[RES_LIVE] - 1);
+  assert.strictEqual(withoutC[RES_HIBERNATED], withC[RES_HIBERNATED] - 1);
+  assert.ok(withoutC[RES_BLOB] < withC[RES_BLOB]);
+  assert.strictEqual(call("mjwf_valid", c), 0);
+
+  // LRU under a budget: trimming hibernates the least recently used handles
+  // until the awake ones fit; wakes go over budget until the next trim.
+  for (const h of [a, b]) call("mjwf_hibernate", h);
+  assert.strictEqual(resident()[RES_DATA], 0);
+  const arms = Array.from({ length: 6 }, (_, i) => makeHandle(Module, ARM_XML, `/arm${i}.xml`));
+  const per = resident()[RES_DATA] / arms.length;
+  for (const h of arms) call("mjwf_step", h, 1);
+  call("mjwf_step", arms[0], 1);
+  assert.strictEqual(call("mjwf_hibernate_budget", 3.5 * per), 3);
+  assert.deepStrictEqual(asleep(arms), [0, 1, 1, 1, 0, 0]);
+  let r = resident();
+  assert.ok(r[RES_DATA] + r[RES_SPARE] <= 3.5 * per);
+  call("mjwf_step", arms[1], 1);
+  assert.strictEqual(resident()[RES_AWAKE], 4);
+  assert.strictEqual(call("mjwf_hibernate_trim"), 1);
+  assert.deepStrictEqual(asleep(arms), [0, 0, 1, 1, 1, 0]);
+
+  // Under the budget a hibernated mjData is parked and reused by the wake.
+  assert.strictEqual(call("mjwf_hibernate_budget", 10 * per), 0);
+  call("mjwf_hibernate", arms[5]);
+  r = resident();
+  assert.ok(r[RES_SPARE] > 0);
+  assert.strictEqual(r[RES_DATA] + r[RES_SPARE], 3 * per);
+  call("mjwf_step", arms[5], 1);
+  assert.strictEqual(resident()[RES_SPARE], 0);
+
+  assert.strictEqual(call("mjwf_hibernate_budget", -1), -1);
+  assert.strictEqual(call("mjwf_errno_last_global"), 202);
+  assert.strictEqual(call("mjwf_hibernate_budget", 0), 0);
+  assert.strictEqual(call("mjwf_hibernate_trim"), 0);
+
+  for (const h of [a, b, ...arms]) call("mjwf_free", h);
+  r = resident();
+  assert.deepStrictEqual([r[RES_LIVE], r[RES_DATA], r[RES_BLOB], r[RES_SPARE]], [0, 0, 0, 0]);
+  call("mjwf_mju_free", stats);
+  console.log(`hibernate(${mjver}): ok`);
+}
@@ -0,0 +1,64 @@
+import assert from "node:assert/strict";
+import { loadHandleBundle, makeHandle, heapF64, PENDULUM_XML } from "./_harness.mjs";
+
+const ctx = await loadHandleBundle("inverse");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const c = (name, ret, args) => Module.cwrap(name, ret, args);
+  const malloc = c("mjwf_mju_malloc", "number", ["number"]);
+  const free = c("mjwf_mju_free", null, ["number"]);
+  const inverseBatch = c("mjwf_inverse_batch", "number",
+    ["number", "number", "number", "number", "number", "number", "number"]);
+  const ptr = (name, h) => Module.ccall(`mjwf_${name}_ptr`, "number", ["number"], [h]);
+
+  // Pendulum swinging while the ball rests on the floor, so constraint forces are non-zero.
+  const h = makeHandle(Module, PENDULUM_XML);
+  const nq = Module.ccall("mjwf_nq", "number", ["number"], [h]);
+  const nv = Module.ccall("mjwf_nv", "number", ["number"], [h]);
+  const T = 40;
+  const qpos = malloc(8 * nq * T);
+  const qvel = malloc(8 * nv * T);
+  const qacc = malloc(8 * nv * T);
+  const Q = heapF64(Module, qpos, nq * T);
+  const V = heapF64(Module, qvel, nv * T);
+  const A = heapF64(Module, qacc, nv * T);
+  const q0 = Array.from(heapF64(Module, ptr("qpos", h), nq));
+  for (let t = 0; t < T; t += 1) {
+    const s = 0.05 * t;
+    Q.set(q0, nq * t);
+    Q[nq * t] = 0.5 * Math.sin(s);
+    Q[nq * t + 3] = 0.045; // ball sunk 5 mm into the floor
+    V[nv * t] = 0.5 * Math.cos(s);
+    A[nv * t] = -0.5 * Math.sin(s);
+  }
+
+  const tau = malloc(8 * nv * T);
+  const con = malloc(8 * nv * T);
+  assert.strictEqual(inverseBatch(h, qpos, qvel, qacc, T, tau, con), 1, "inverse_batch failed");
+  const TAU = Array.from(heapF64(Module, tau, nv * T));
+  const CON = Array.from(heapF64(Module, con, nv * T));
+
+  // Per-frame reference through the mj_inverse alias on the handle.
+  const m = Module.ccall("mjwf_model_ptr", "number", ["number"], [h]);
+  const d = Module.ccall("mjwf_data_ptr", "number", ["number"], [h]);
+  for (let t = 0; t < T; t += 1) {
+    heapF64(Module, ptr("qpos", h), nq).set(Q.subarray(nq * t, nq * (t + 1)));
+    heapF64(Module, ptr("qvel", h), nv).set(V.subarray(nv * t, nv * (t + 1)));
+    heapF64(Module, ptr("qacc", h), nv).set(A.subarray(nv * t, nv * (t + 1)));
+    Module.ccall("mjwf_mj_inverse", null, ["number", "number"], [m, d]);
+    assert.deepStrictEqual(TAU.slice(nv * t, nv * (t + 1)), Array.from(heapF64(Module, ptr("qfrc_inverse", h), nv)), `frame ${t} qfrc_inverse`);
+    assert.deepStrictEqual(CON.slice(nv * t, nv * (t + 1)), Array.from(heapF64(Module, ptr("qfrc_constraint", h), nv)), `frame ${t} qfrc_constraint`);
+  }
+  assert.ok(CON.some((v) => v !== 0), "ball contact shows up in qfrc_constraint");
+
+  // Frames are independent, so the parallel path gives identical results.
+  const threads = Module.ccall("mjwf_set_threads", "number", ["number"], [4]);
+  assert.strictEqual(inverseBatch(h, qpos, qvel, qacc, T, tau, 0), 1);
+  assert.deepStrictEqual(Array.from(heapF64(Module, tau, nv * T)), TAU, `threads=${threads}`);
+  Module.ccall("mjwf_set_threads", "number", ["number"], [1]);
+  assert.strictEqual(inverseBatch(h, qpos, 0, qacc, T, tau, 0), 0, "qvel required");
+
+  [qpos, qvel, qacc, tau, con].forEach((p) => free(p));
+  Module.ccall("mjwf_free", null, ["number"], [h]);
+  console.log(`inverse(${mjver}) OK`);
+}
@@ -0,0 +1,73 @@
+import assert from "node:assert/strict";
+import fs from "node:fs";
+import path from "node:path";
+import { loadHandleBundle, makeHandle, heapF64, pointerBytes, rootDir, ARM_XML } from "./_harness.mjs";
+import { VecEnv } from "../../wrappers/js/mjwf_vecenv.mjs";
+
+// Runs against a -DMJWF_MEMORY64=ON bundle on Node 24+ (Node 22 needs
+// --experimental-wasm-memory64), e.g.
+//   node tests/handles/memory64.mjs 3.3.7-wasm64
+// wasm32 bundles are skipped.
+const HEAP_MEMORY = 0;
+const HEAP_NSTAT = 5;
+const FOUR_GB = 2 ** 32;
+
+const ctx = await loadHandleBundle("memory64");
+if (ctx && pointerBytes(ctx.Module) !== 8) {
+  console.log(`memory64(${ctx.mjver}): skipped (wasm32 bundle)`);
+} else if (ctx) {
+  const { Module, mjver } = ctx;
+  const call = (name, ...args) => Module.ccall(name, "number", args.map(() => "number"), args);
+  const ptr = (name, h) => Module.ccall(name, "pointer", ["number"], [h]);
+  const malloc = (n) => Module.ccall("mjwf_mju_malloc", "pointer", ["pointer"], [n]);
+  const free = (p) => Module.ccall("mjwf_mju_free", null, ["pointer"], [p]);
+
+  // Raw exports take and return BigInt pointers; "pointer" wrappers convert.
+  const low = makeHandle(Module, ARM_XML, "/low.xml");
+  const raw = Module.wasmExports.mjwf_qpos_ptr(low);
+  assert.strictEqual(typeof raw, "bigint");
+  assert.strictEqual(ptr("mjwf_qpos_ptr", low), Number(raw));
+  assert.strictEqual(Module.wasmExports.mjwf_nq(low), 3, "int results stay numbers");
+  assert.throws(() => Module.wasmExports.mjwf_mju_free(1), TypeError, "numbers are not pointers");
+
+  // Push the heap past 4 GB, then make handles until one lives above it and
+  // check that it steps exactly like the handle below.
+  const fill = Number(process.env.MJWF_M64_FILL || 4.25 * 2 ** 30);
+  const filler = malloc(fill);
+  assert.ok(filler > 0, `could not allocate ${fill} bytes`);
+  const stats = malloc(8 * HEAP_NSTAT);
+  call("mjwf_heap_stats", stats);
+  assert.ok(heapF64(Module, stats, HEAP_NSTAT)[HEAP_MEMORY] > FOUR_GB);
+  const handles = [];
+  let high = 0;
+  while (!high && handles.length < 64) {
+    const h = makeHandle(Module, ARM_XML, "/high.xml");
+    handles.push(h);
+    if (ptr("mjwf_qpos_ptr", h) > FOUR_GB) high = h;
+  }
+  assert.ok(high, "no handle was placed above 4 GB");
+  for (const h of [low, high]) {
+    heapF64(Module, ptr("mjwf_ctrl_ptr", h), 3).set([0.4, -0.2, 0.1]);
+    call("mjwf_step", h, 200);
+  }
+  assert.deepStrictEqual(Array.from(heapF64(Module, ptr("mjwf_qpos_ptr", high), 3)),
+    Array.from(heapF64(Module, ptr("mjwf_qpos_ptr", low), 3)));
+
+  // The JS wrappers pass their buffers as "pointer".
+  const env = new VecEnv(Module, high, 64, "proprio");
+  env.actions.fill(0.3);
+  for (let i = 0; i < 10; i += 1) env.step();
+  assert.ok(env.obs.every(Number.isFinite));
+  env.dispose();
+
+  // Generated declarations shipped next to the bundle type pointers as bigint.
+  const dist = path.join(rootDir, "dist", mjver);
+  for (const f of fs.readdirSync(dist).filter((name) => name.endsWith(".d.ts"))) {
+    assert.match(fs.readFileSync(path.join(dist, f), "utf8"), /export type Ptr = bigint;/, f);
+  }
+
+  for (const h of [low, ...handles]) call("mjwf_free", h);
+  free(stats);
+  free(filler);
+  console.log(`memory64(${mjver}): ok`);
+}
@@ -0,0 +1,81 @@
+import assert from "node:assert/strict";
+import { loadHandleBundle, makeHandle, heapF64, PENDULUM_XML } from "./_harness.mjs";
+
+const SAMPLE_SCALE = 0; // MJWF_SAMPLE_SCALE
+
+const ctx = await loadHandleBundle("overlay");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const c = (name, ret, args) => Module.cwrap(name, ret, args);
+  const malloc = c("mjwf_mju_malloc", "number", ["number"]);
+  const free = c("mjwf_mju_free", null, ["number"]);
+  const share = c("mjwf_make_shared", "number", ["number"]);
+  const valid = c("mjwf_valid", "number", ["number"]);
+  const overlayCount = c("mjwf_overlay_count", "number", ["number"]);
+  const overlayReset = c("mjwf_overlay_reset", "number", ["number", "number"]);
+  const sample = c("mjwf_overlay_sample", "number",
+    ["number", "number", "number", "number", "number", "number", "number", "number", "number"]);
+  const viewId = (name) => Module.ccall("mjwf_view_id", "number", ["string"], [name]);
+  const ptr = (name, h, n) => heapF64(Module, Module.ccall(`mjwf_${name}_ptr`, "number", ["number"], [h]), n);
+  const bytes = (name, h) => Module.ccall(`mjwf_model_${name}_bytes`, "number", ["number"], [h]);
+
+  const base = makeHandle(Module, PENDULUM_XML);
+  const s1 = share(base);
+  const s2 = share(base);
+  assert.ok(s1 > 0 && s2 > 0, "make_shared");
+  assert.strictEqual(overlayCount(s1), 0);
+  assert.ok(bytes("private", s1) < bytes("full", s1) / 2, "shares cost a model struct, not a model");
+  assert.strictEqual(bytes("private", base), bytes("full", base));
+
+  // Copy-on-write: damping written through s1 stays on s1.
+  const nv = Module.ccall("mjwf_nv", "number", ["number"], [base]);
+  ptr("dof_damping", s1, nv)[0] = 5;
+  assert.strictEqual(overlayCount(s1), 1);
+  assert.ok(bytes("private", s1) > bytes("private", s2), "overlay adds one array");
+  assert.strictEqual(ptr("dof_damping", s2, nv)[0], 0.01, "s2 keeps nominal damping");
+  assert.strictEqual(ptr("dof_damping", base, nv)[0], 0.01, "base keeps nominal damping");
+
+  // mjwf_view_addr reads the shared arrays without acquiring (pool reads use it).
+  const addr = (name, h, n) => heapF64(Module,
+    Module.ccall("mjwf_view_addr", "number", ["number", "number"], [h, viewId(name)]), n);
+  const nbody = Module.ccall("mjwf_view_len", "number", ["number", "number"], [s2, viewId("body_mass")]);
+  const held = [overlayCount(s2), bytes("private", s2)];
+  assert.deepStrictEqual(Array.from(addr("body_mass", s2, nbody)), Array.from(addr("body_mass", base, nbody)));
+  assert.strictEqual(addr("dof_damping", s1, nv)[0], 5, "view_addr sees an existing overlay");
+  assert.deepStrictEqual([overlayCount(s2), bytes("private", s2)], held, "view_addr does not acquire");
+
+  // The overlay is what stepping sees.
+  for (const h of [s1, s2]) {
+    ptr("qvel", h, nv)[0] = 2;
+    Module.ccall("mjwf_step", "number", ["number", "number"], [h, 1]);
+  }
+  assert.ok(Math.abs(ptr("qvel", s1, nv)[0]) < Math.abs(ptr("qvel", s2, nv)[0]) * 0.9, "s1 is damped harder");
+
+  // Bulk re-sampling of friction around nominal, deterministic per seed.
+  const ngeom = Module.ccall("mjwf_ngeom", "number", ["number"], [base]);
+  const nominal = Array.from(ptr("geom_friction", base, 3 * ngeom));
+  const hs = malloc(8);
+  new Int32Array(Module.HEAP8.buffer, hs, 2).set([s1, s2]);
+  const fr = viewId("geom_friction");
+  assert.strictEqual(sample(hs, 2, fr, 0, -1, SAMPLE_SCALE, 0.5, 1.5, 9), 1, "sample failed");
+  const f1 = Array.from(ptr("geom_friction", s1, 3 * ngeom));
+  const f2 = Array.from(ptr("geom_friction", s2, 3 * ngeom));
+  assert.notDeepStrictEqual(f1, f2, "handles get different draws");
+  f1.forEach((v, i) => assert.ok(v >= 0.5 * nominal[i] && v <= 1.5 * nominal[i], `friction ${i} in range`));
+  sample(hs, 2, fr, 0, -1, SAMPLE_SCALE, 0.5, 1.5, 9);
+  assert.deepStrictEqual(Array.from(ptr("geom_friction", s1, 3 * ngeom)), f1, "same seed, same draw (scaled from nominal)");
+  assert.strictEqual(sample(hs, 2, viewId("qpos"), 0, -1, SAMPLE_SCALE, 0.5, 1.5, 9), 0, "qpos is not an overlay view");
+
+  // Reset restores nominal values.
+  assert.strictEqual(overlayReset(s1, -1), 1);
+  assert.strictEqual(overlayCount(s1), 0);
+  assert.deepStrictEqual(Array.from(ptr("geom_friction", s1, 3 * ngeom)), nominal);
+
+  // The base outlives its shares.
+  Module.ccall("mjwf_free", null, ["number"], [base]);
+  assert.strictEqual(valid(base), 1, "base with live shares is kept");
+  [s1, s2, base].forEach((h) => Module.ccall("mjwf_free", null, ["number"], [h]));
+  assert.strictEqual(valid(base), 0);
+  free(hs);
+  console.log(`overlay(${mjver}) OK`);
+}
@@ -0,0 +1,67 @@
+import assert from "node:assert/strict";
+import { loadHandleBundle, makeHandle, heapF64, PENDULUM_XML } from "./_harness.mjs";
+
+const ADAPTIVE = 1; // MJWF_PACE_ADAPTIVE
+
+const ctx = await loadHandleBundle("pacing");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const c = (name, ret, args) => Module.cwrap(name, ret, args);
+  const malloc = c("mjwf_mju_malloc", "number", ["number"]);
+  const free = c("mjwf_mju_free", null, ["number"]);
+  const pace = c("mjwf_step_for_budget", "number", ["number", "number", "number", "number", "number"]);
+  const time = c("mjwf_time", "number", ["number"]);
+  const cost = c("mjwf_step_cost_us", "number", ["number"]);
+  const reset = c("mjwf_reset", "number", ["number"]);
+  const statsPtr = malloc(8 * 4);
+  const stats = () => Array.from(heapF64(Module, statsPtr, 4));
+
+  const h = makeHandle(Module, PENDULUM_XML);
+  const dt = Module.ccall("mjwf_timestep", "number", ["number"], [h]);
+  assert.strictEqual(cost(h), 0, "no estimate before the first step");
+
+  // Unlimited budget: lands exactly on the target step.
+  for (const flags of [0, ADAPTIVE]) {
+    reset(h);
+    const n = pace(h, 100 * dt, 1e9, flags, statsPtr);
+    assert.strictEqual(n, 100, `flags=${flags}`);
+    const [steps, lag, avg, used] = stats();
+    assert.strictEqual(steps, 100);
+    assert.ok(Math.abs(lag) < 0.5 * dt, "lag is below half a step");
+    assert.ok(avg > 0 && used > 0, "cost estimate and wall time are reported");
+    assert.ok(Math.abs(time(h) - 100 * dt) < 1e-9);
+    assert.strictEqual(pace(h, 100 * dt, 1e9, flags, statsPtr), 0, "already at the target");
+  }
+
+  // A budget smaller than one step still advances by one step and reports the lag.
+  reset(h);
+  assert.strictEqual(pace(h, 10.0, 1e-3, 0, statsPtr), 1);
+  assert.ok(stats()[1] > 9.9);
+  for (const flags of [0, ADAPTIVE]) {
+    assert.strictEqual(pace(h, 10.0, 0, flags, statsPtr), 1, "zero budget takes exactly one step");
+  }
+  assert.strictEqual(pace(h, 0, 0, 0, statsPtr), 0, "nothing to do when not behind");
+
+  // A bounded budget stops early instead of overshooting by much.
+  reset(h);
+  const budget = 200 * cost(h);
+  const n = pace(h, 1e3, budget, ADAPTIVE, statsPtr);
+  assert.ok(n > 0 && n < 1e3 / dt, "stopped by the budget");
+  assert.ok(stats()[3] < budget * 3 + 1000, "wall time stays near the budget");
+
+  // Far targets and unlimited budgets are clamped before any int conversion;
+  // non-finite targets are rejected.
+  assert.ok(pace(h, 1e300, budget, ADAPTIVE, statsPtr) > 0, "far target");
+  reset(h);
+  assert.strictEqual(pace(h, 20 * dt, Infinity, ADAPTIVE, statsPtr), 20, "unlimited budget");
+  for (const target of [Infinity, -Infinity, NaN]) {
+    assert.strictEqual(pace(h, target, budget, ADAPTIVE, statsPtr), -1, `target ${target}`);
+    assert.strictEqual(Module.ccall("mjwf_errno_last", "number", ["number"], [h]), 130);
+  }
+  assert.strictEqual(pace(h, 1, -1, 0, 0), -1, "negative budget is an error");
+  assert.strictEqual(pace(0, 1, 1, 0, 0), -1, "invalid handle");
+
+  free(statsPtr);
+  Module.ccall("mjwf_free", null, ["number"], [h]);
+  console.log(`pacing(${mjver}): OK`);
+}
@@ -0,0 +1,53 @@
+import assert from "node:assert/strict";
+import path from "node:path";
+import { pathToFileURL } from "node:url";
+import { loadHandleBundle, makeHandle, heapF64, rootDir, ARM_XML, PENDULUM_XML } from "./_harness.mjs";
+import { MjwfPool } from "../../wrappers/js/mjwf_pool.mjs";
+
+const ctx = await loadHandleBundle("pool");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const dist = path.join(rootDir, "dist", mjver);
+  const pool = await MjwfPool.create({
+    workers: 2,
+    jsURL: pathToFileURL(path.join(dist, "mujoco.js")),
+    wasmURL: pathToFileURL(path.join(dist, "mujoco.wasm")),
+  });
+  assert.strictEqual(pool.startup.instantiateMs.length, 2);
+
+  // Handles are spread over the workers; each steps like a local handle.
+  const ids = [];
+  for (let i = 0; i < 4; i += 1) ids.push(await pool.createHandle(ARM_XML));
+  assert.deepStrictEqual(pool.stats().map((s) => s.handles), [2, 2]);
+  const ref = makeHandle(Module, ARM_XML, "/ref.xml");
+  heapF64(Module, Module.ccall("mjwf_ctrl_ptr", "number", ["number"], [ref]), 3).set([0.5, -0.3, 0.2]);
+  Module.ccall("mjwf_step", "number", ["number", "number"], [ref, 100]);
+  const refQpos = Array.from(heapF64(Module, Module.ccall("mjwf_qpos_ptr", "number", ["number"], [ref]), 3));
+  await Promise.all(ids.map((id) => pool.write(id, "ctrl", [0.5, -0.3, 0.2])));
+  const times = await Promise.all(ids.map((id) => pool.step(id, 100)));
+  assert.ok(times.every((t) => Math.abs(t - 0.2) < 1e-9), `${times}`);
+  for (const id of ids) {
+    const { qpos, qvel } = await pool.read(id, ["qpos", "qvel"]);
+    assert.ok(qpos instanceof Float64Array && qvel.length === 3);
+    assert.deepStrictEqual(Array.from(qpos), refQpos);
+  }
+
+  // stepAll covers every handle; new handles go to the emptier worker.
+  assert.strictEqual(await pool.stepAll(5), 4 * 5);
+  await pool.free(ids[0]);
+  const p = await pool.createHandle(PENDULUM_XML);
+  assert.deepStrictEqual(pool.stats().map((s) => s.handles), [2, 2]);
+  assert.strictEqual((await pool.read(p, ["qpos"])).qpos.length, 8);
+  const { body_mass: mass } = await pool.read(p, ["body_mass"]);
+  assert.ok(mass instanceof Float64Array && mass.length > 1 && mass[1] > 0, "model-side views read too");
+
+  // Errors come back as rejections with the layer's messages.
+  await assert.rejects(pool.createHandle("<mujoco><worldbody><bogus/></worldbody></mujoco>"), /worker \d+: .+/);
+  await assert.rejects(pool.step(ids[0]), /unknown pool handle/);
+  await assert.rejects(pool.write(p, "nope", [1]), /unknown view nope/);
+  assert.deepStrictEqual(pool.stats().map((s) => s.handles), [2, 2]);
+
+  await pool.close();
+  Module.ccall("mjwf_free", null, ["number"], [ref]);
+  console.log(`pool(${mjver}): ok`);
+}
@@ -0,0 +1,74 @@
+import assert from "node:assert/strict";
+import { loadHandleBundle, makeHandle, heapF64, PENDULUM_XML } from "./_harness.mjs";
+
+const OBJ_BODY = 1; // mjOBJ_BODY
+const OBJ_SITE = 6; // mjOBJ_SITE
+
+const ctx = await loadHandleBundle("rays");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const c = (name, ret, args) => Module.cwrap(name, ret, args);
+  const malloc = c("mjwf_mju_malloc", "number", ["number"]);
+  const free = c("mjwf_mju_free", null, ["number"]);
+  const ray = c("mjwf_mj_ray", "number",
+    ["number", "number", "number", "number", "number", "number", "number", "number"]);
+  const rayBatch = c("mjwf_ray_batch", "number",
+    ["number", "number", "number", "number", "number", "number", "number", "number", "number", "number"]);
+  const rayScan = c("mjwf_ray_scan", "number",
+    ["number", "number", "number", "number", "number", "number", "number", "number", "number",
+      "number", "number", "number", "number", "number", "number"]);
+
+  const h = makeHandle(Module, PENDULUM_XML);
+  Module.ccall("mjwf_forward", "number", ["number"], [h]);
+  const m = Module.ccall("mjwf_model_ptr", "number", ["number"], [h]);
+  const d = Module.ccall("mjwf_data_ptr", "number", ["number"], [h]);
+
+  // Random downward-ish rays from above the scene, checked against per-call mj_ray.
+  const N = 64;
+  const pnt = malloc(8 * 3 * N);
+  const vec = malloc(8 * 3 * N);
+  const dist = malloc(8 * N);
+  const gid = malloc(4 * N);
+  const one = malloc(4);
+  let seed = 7;
+  const rnd = () => ((seed = (seed * 1103515245 + 12345) % 2147483648) / 2147483648);
+  const P = heapF64(Module, pnt, 3 * N);
+  const V = heapF64(Module, vec, 3 * N);
+  for (let i = 0; i < N; i += 1) {
+    P.set([rnd() - 0.5, rnd() - 0.5, 2], 3 * i);
+    V.set([0.3 * (rnd() - 0.5), 0.3 * (rnd() - 0.5), -1], 3 * i);
+  }
+  assert.strictEqual(rayBatch(h, pnt, vec, N, 0, 1, -1, 0, dist, gid), 1, "ray_batch failed");
+  const D = heapF64(Module, dist, N);
+  const G = new Int32Array(Module.HEAP8.buffer, gid, N);
+  for (let i = 0; i < N; i += 1) {
+    const ref = ray(m, d, pnt + 24 * i, vec + 24 * i, 0, 1, -1, one);
+    const refGid = new Int32Array(Module.HEAP8.buffer, one, 1)[0];
+    assert.strictEqual(G[i], refGid, `ray ${i} geom`);
+    assert.strictEqual(D[i], refGid < 0 ? -1 : ref, `ray ${i} dist`);
+    assert.ok(G[i] >= 0, "every downward ray hits floor or scene");
+  }
+
+  // Cutoff drops far hits.
+  rayBatch(h, pnt, vec, N, 0, 1, -1, 0.5, dist, gid);
+  assert.ok(heapF64(Module, dist, N).every((v) => v === -1), "cutoff below floor distance");
+
+  // Scan straight down from the pendulum tip: 3 x 5 fan, all rays reach the floor (id 0).
+  // The tip sits inside the link capsule, so the link body is excluded.
+  const name2id = (type, name) => Module.ccall("mjwf_name2id", "number", ["number", "number", "string"], [h, type, name]);
+  const tip = name2id(OBJ_SITE, "tip");
+  const link = name2id(OBJ_BODY, "link");
+  const sd = malloc(8 * 15);
+  const sg = malloc(4 * 15);
+  assert.strictEqual(rayScan(h, OBJ_SITE, tip, 5, -0.2, 0.2, 3, -1.5, -1.3, 0, 1, link, 0, sd, sg), 1, "ray_scan failed");
+  const SD = heapF64(Module, sd, 15);
+  const SG = new Int32Array(Module.HEAP8.buffer, sg, 15);
+  for (let i = 0; i < 15; i += 1) {
+    assert.strictEqual(SG[i], 0, `scan ray ${i} should hit the floor`);
+    assert.ok(SD[i] > 0.79 && SD[i] < 0.9, `scan ray ${i} dist ${SD[i]}`);
+  }
+
+  [pnt, vec, dist, gid, one, sd, sg].forEach((p) => free(p));
+  Module.ccall("mjwf_free", null, ["number"], [h]);
+  console.log(`rays(${mjver}) OK`);
+}
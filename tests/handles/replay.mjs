@@ -0,0 +1,86 @@
+import assert from "node:assert/strict";
+import { loadHandleBundle, makeHandle, heapF64, PENDULUM_XML } from "./_harness.mjs";
+
+const R = { STEPS: 0, STEP: 1, COMP: 2, ELEMENT: 3, EXPECTED: 4, ACTUAL: 5 };
+const QPOS = 2;
+
+const ctx = await loadHandleBundle("replay");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const call = (name, ...args) => Module.ccall(name, "number", args.map((a) => (typeof a === "string" ? "string" : "number")), args);
+  const compName = (c) => Module.ccall("mjwf_replay_comp_name", "string", ["number"], [c]);
+  const resPtr = Module.ccall("mjwf_mju_malloc", "number", ["number"], [8 * 6]);
+  const res = () => Array.from(heapF64(Module, resPtr, 6));
+
+  // Record 300 steps with a ctrl that changes every 25 steps.
+  const rec = makeHandle(Module, PENDULUM_XML, "/rec.xml");
+  assert.strictEqual(call("mjwf_replay_record_start", rec, "/run.rlog", 0), 1);
+  assert.strictEqual(call("mjwf_replay_record_start", rec, "/run.rlog", 0), 0, "already recording");
+  for (let t = 0; t < 300; t += 25) {
+    heapF64(Module, call("mjwf_ctrl_ptr", rec), 1)[0] = Math.sin(t);
+    call("mjwf_step", rec, 25);
+  }
+  assert.strictEqual(call("mjwf_replay_record_stop", rec), 300);
+  assert.strictEqual(call("mjwf_replay_record_stop", rec), -1);
+
+  // A fresh handle reproduces every step bit for bit.
+  const rep = makeHandle(Module, PENDULUM_XML, "/rep.xml");
+  assert.strictEqual(call("mjwf_replay_check", rep, "/run.rlog", 0, resPtr), 1);
+  assert.strictEqual(res()[R.STEPS], 300);
+  assert.deepStrictEqual(heapF64(Module, call("mjwf_qpos_ptr", rep), call("mjwf_nq", rep)),
+    heapF64(Module, call("mjwf_qpos_ptr", rec), call("mjwf_nq", rec)));
+
+  // A corrupted hash in the last record is reported at step 300.
+  const log = Module.FS.readFile("/run.rlog");
+  log[log.length - 1] ^= 1;
+  Module.FS.writeFile("/bad.rlog", log);
+  assert.strictEqual(call("mjwf_replay_check", rep, "/bad.rlog", 0, resPtr), 0);
+  assert.strictEqual(res()[R.STEP], 300);
+  assert.strictEqual(res()[R.ELEMENT], -1, "no checkpoint, no element");
+
+  // Changed physics (more damping) diverges at step 1; with a checkpoint at
+  // every step the replay also names the element.
+  const ck = makeHandle(Module, PENDULUM_XML, "/ck.xml");
+  heapF64(Module, call("mjwf_ctrl_ptr", ck), 1)[0] = 0.5;
+  call("mjwf_replay_record_start", ck, "/ck.rlog", 1);
+  call("mjwf_step", ck, 50);
+  call("mjwf_replay_record_stop", ck);
+  const damped = makeHandle(Module, PENDULUM_XML, "/damped.xml");
+  heapF64(Module, call("mjwf_dof_damping_ptr", damped), 1)[0] = 5;
+  assert.strictEqual(call("mjwf_replay_check", damped, "/ck.rlog", 0, resPtr), 0);
+  const r = res();
+  assert.strictEqual(r[R.STEP], 1);
+  assert.strictEqual(r[R.COMP], QPOS);
+  assert.strictEqual(compName(r[R.COMP]), "qpos");
+  assert.strictEqual(r[R.ELEMENT], 0, "hinge qpos moves first");
+  assert.notStrictEqual(r[R.EXPECTED], r[R.ACTUAL]);
+
+  // Logs of another model are rejected.
+  const arm = makeHandle(Module, `<mujoco><worldbody><body><joint/><geom size="0.1"/></body></worldbody></mujoco>`, "/other.xml");
+  assert.strictEqual(call("mjwf_replay_check", arm, "/run.rlog", 0, resPtr), -1);
+  assert.strictEqual(Module.ccall("mjwf_errno_last", "number", ["number"], [arm]), 181);
+
+  // An in-place recompile that adds a free body ends the recording: the log
+  // holds the steps before the edit and still replays on the old model.
+  Module.FS.writeFile("/edit.xml", PENDULUM_XML);
+  Module.FS.writeFile("/box.xml", `<mujoco><worldbody><body name="box"><freejoint/><geom type="box" size="0.05 0.05 0.05"/></body></worldbody></mujoco>`);
+  const ed = call("mjwf_make_editable", "/edit.xml");
+  assert.ok(ed > 0);
+  assert.strictEqual(call("mjwf_replay_record_start", ed, "/edit.rlog", 1), 1);
+  call("mjwf_step", ed, 20);
+  const pos = Module.ccall("mjwf_mju_malloc", "number", ["number"], [24]);
+  heapF64(Module, pos, 3).set([1, 0, 0.5]);
+  assert.strictEqual(call("mjwf_edit_attach", ed, "", "/box.xml", "extra/", pos), 1);
+  assert.strictEqual(call("mjwf_recompile", ed), 1);
+  call("mjwf_step", ed, 5);
+  assert.strictEqual(Module.ccall("mjwf_errno_last", "number", ["number"], [ed]), 183);
+  assert.strictEqual(call("mjwf_replay_record_stop", ed), -1, "recording already ended");
+  const fresh = makeHandle(Module, PENDULUM_XML, "/fresh.xml");
+  assert.strictEqual(call("mjwf_replay_check", fresh, "/edit.rlog", 0, resPtr), 1);
+  assert.strictEqual(res()[R.STEPS], 20);
+  Module.ccall("mjwf_mju_free", null, ["number"], [pos]);
+
+  [rec, rep, ck, damped, arm, ed, fresh].forEach((h) => call("mjwf_free", h));
+  Module.ccall("mjwf_mju_free", null, ["number"], [resPtr]);
+  console.log(`replay(${mjver}): OK`);
+}
@@ -0,0 +1,91 @@
+import assert from "node:assert/strict";
+import { loadHandleBundle, makeHandle, heapF64, PENDULUM_XML } from "./_harness.mjs";
+
+const N = 4;
+
+const ctx = await loadHandleBundle("replicate");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const c = (name, ret, args) => Module.cwrap(name, ret, args);
+  const malloc = c("mjwf_mju_malloc", "number", ["number"]);
+  const free = c("mjwf_mju_free", null, ["number"]);
+  const dim = (name, h) => Module.ccall(`mjwf_${name}`, "number", ["number"], [h]);
+  const step = c("mjwf_step", "number", ["number", "number"]);
+  const count = c("mjwf_replica_count", "number", ["number"]);
+  const envOf = c("mjwf_replica_env_of", "number", ["number", "number", "number"]);
+  const viewId = (name) => Module.ccall("mjwf_view_id", "number", ["string"], [name]);
+  const ptr = (name, h, n) => heapF64(Module, Module.ccall(`mjwf_${name}_ptr`, "number", ["number"], [h]), n);
+  const io = malloc(8);
+  const slice = (h, view) => {
+    const ok = Module.ccall("mjwf_replica_slice", "number", ["number", "number", "number", "number"],
+      [h, viewId(view), io, io + 4]);
+    return ok ? Array.from(new Int32Array(Module.HEAP8.buffer, io, 2)) : null;
+  };
+
+  Module.FS.writeFile("/replicate_base.xml", PENDULUM_XML);
+  const single = makeHandle(Module, PENDULUM_XML);
+  const rep = Module.ccall("mjwf_make_replicated", "number", ["string", "number", "number"],
+    ["/replicate_base.xml", N, 3.0]);
+  assert.ok(rep > 0, `make_replicated: ${Module.ccall("mjwf_errmsg_last_global", "string", [], [])}`);
+  assert.strictEqual(count(rep), N);
+  assert.strictEqual(count(single), 0);
+  const nq = dim("nq", single);
+  assert.strictEqual(dim("nq", rep), N * nq);
+  assert.strictEqual(dim("nu", rep), N * dim("nu", single));
+
+  // Index maps: dof/actuator/sensor blocks from 0, bodies after the world body;
+  // geoms are not strided because the floor lives in the world body.
+  assert.deepStrictEqual(slice(rep, "qpos"), [0, nq]);
+  assert.deepStrictEqual(slice(rep, "ctrl"), [0, 1]);
+  assert.deepStrictEqual(slice(rep, "sensordata"), [0, 2]);
+  assert.deepStrictEqual(slice(rep, "body_mass"), [1, 2]);
+  assert.strictEqual(slice(rep, "geom_xpos"), null, "world geoms interleave copies");
+  assert.strictEqual(slice(single, "qpos"), null);
+  assert.strictEqual(envOf(rep, 1, 1 + 2 * 2), 2, "body -> env");
+  assert.strictEqual(envOf(rep, 1, 0), -1, "world body is shared");
+
+  // Every env matches a separate handle driven with the same control, and
+  // balls only touch their own floor (N contacts, not N * N).
+  const T = 100;
+  const [qoff, qstride] = slice(rep, "qpos");
+  for (let i = 0; i < N; i += 1) ptr("ctrl", rep, N)[i] = 0.1 * (i + 1);
+  step(rep, T);
+  for (let i = 0; i < N; i += 1) {
+    Module.ccall("mjwf_reset", "number", ["number"], [single]);
+    ptr("ctrl", single, 1)[0] = 0.1 * (i + 1);
+    step(single, T);
+    const q1 = ptr("qpos", single, nq);
+    const qi = ptr("qpos", rep, N * nq).subarray(qoff + i * qstride, qoff + (i + 1) * qstride);
+    assert.ok(Math.abs(qi[0] - q1[0]) < 1e-6, `env ${i} hinge`);
+    assert.ok(Math.abs(qi[3] - q1[3]) < 1e-6, `env ${i} ball height`);
+    assert.ok(Math.abs(ptr("sensordata", rep, 2 * N)[2 * i] - q1[0]) < 1e-6, `env ${i} sensor slice`);
+  }
+  assert.strictEqual(dim("ncon", rep), N * dim("ncon", single), "no cross-env contacts");
+  const ngeom = dim("ngeom", rep);
+  assert.strictEqual(envOf(rep, 5, 0), 0, "first floor belongs to env 0");
+  assert.strictEqual(envOf(rep, 5, ngeom - 1), N - 1);
+
+  // Replicated handles are ordinary handles for everything else.
+  const shared = Module.ccall("mjwf_make_shared", "number", ["number"], [rep]);
+  assert.strictEqual(count(shared), N, "shares keep the index maps");
+  Module.ccall("mjwf_free", null, ["number"], [shared]);
+
+  const bad = Module.ccall("mjwf_make_replicated", "number", ["string", "number", "number"], ["/nope.xml", N, 1]);
+  assert.strictEqual(bad, -1);
+  assert.ok(Module.ccall("mjwf_errno_last_global", "number", [], []) >= 120);
+
+  // Freeing one replicated handle keeps the filter working for the others.
+  const rep2 = Module.ccall("mjwf_make_replicated", "number", ["string", "number", "number"],
+    ["/replicate_base.xml", 2, 3.0]);
+  assert.strictEqual(count(rep2), 2);
+  Module.ccall("mjwf_free", null, ["number"], [rep]);
+  Module.ccall("mjwf_reset", "number", ["number"], [single]);
+  step(single, T);
+  step(rep2, T);
+  assert.strictEqual(dim("ncon", rep2), 2 * dim("ncon", single), "no cross-env contacts after a free");
+
+  free(io);
+  Module.ccall("mjwf_free", null, ["number"], [rep2]);
+  Module.ccall("mjwf_free", null, ["number"], [single]);
+  console.log(`replicate(${mjver}): OK`);
+}
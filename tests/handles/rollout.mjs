@@ -0,0 +1,76 @@
+import assert from "node:assert/strict";
+import { loadHandleBundle, makeHandle, heapF64, ARM_XML } from "./_harness.mjs";
+
+const STATE_FULLPHYSICS = 4111; // mjSTATE_FULLPHYSICS
+
+const ctx = await loadHandleBundle("rollout");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const c = (name, ret, args) => Module.cwrap(name, ret, args);
+  const malloc = c("mjwf_mju_malloc", "number", ["number"]);
+  const free = c("mjwf_mju_free", null, ["number"]);
+  const rollout = c("mjwf_rollout", "number",
+    ["number", "number", "number", "number", "number", "number", "number", "number", "number"]);
+  const rolloutStride = c("mjwf_rollout_stride", "number", ["number", "number", "number"]);
+  const ptr = (name, h) => Module.ccall(`mjwf_${name}_ptr`, "number", ["number"], [h]);
+
+  const h = makeHandle(Module, ARM_XML);
+  const nq = Module.ccall("mjwf_nq", "number", ["number"], [h]);
+  const nv = Module.ccall("mjwf_nv", "number", ["number"], [h]);
+  const nu = Module.ccall("mjwf_nu", "number", ["number"], [h]);
+  heapF64(Module, ptr("qvel", h), nv).set([0.5, -0.2, 0.1]);
+
+  // Initial state straight from the handle.
+  const m = Module.ccall("mjwf_model_ptr", "number", ["number"], [h]);
+  const d = Module.ccall("mjwf_data_ptr", "number", ["number"], [h]);
+  const nstate = Module.ccall("mjwf_mj_stateSize", "number", ["number", "number"], [m, STATE_FULLPHYSICS]);
+  const state0 = malloc(8 * nstate);
+  Module.ccall("mjwf_mj_getState", null, ["number", "number", "number", "number"], [m, d, state0, STATE_FULLPHYSICS]);
+
+  const K = 8;
+  const H = 20;
+  const ctrls = malloc(8 * K * H * nu);
+  const U = heapF64(Module, ctrls, K * H * nu);
+  let seed = 3;
+  for (let i = 0; i < U.length; i += 1) {
+    seed = (Math.imul(seed, 1103515245) + 12345) >>> 0;
+    U[i] = 2 * (seed / 4294967296) - 1;
+  }
+  const viewIds = ["qpos", "qvel"].map((n) => Module.ccall("mjwf_view_id", "number", ["string"], [n]));
+  const views = malloc(4 * viewIds.length);
+  new Int32Array(Module.HEAP8.buffer, views, viewIds.length).set(viewIds);
+  const stride = rolloutStride(h, views, viewIds.length);
+  assert.strictEqual(stride, nq + nv);
+  const out = malloc(8 * K * H * stride);
+  assert.strictEqual(rollout(h, state0, STATE_FULLPHYSICS, ctrls, K, H, views, viewIds.length, out), 1, "rollout failed");
+  const R = Array.from(heapF64(Module, out, K * H * stride));
+
+  // Reference: the same rollouts stepped one by one on the handle.
+  assert.strictEqual(Module.ccall("mjwf_state_save", "number", ["number", "number"], [h, 0]), 1);
+  for (let k = 0; k < K; k += 1) {
+    Module.ccall("mjwf_state_restore", "number", ["number", "number"], [h, 0]);
+    for (let t = 0; t < H; t += 1) {
+      heapF64(Module, ptr("ctrl", h), nu).set(U.subarray((k * H + t) * nu, (k * H + t + 1) * nu));
+      Module.ccall("mjwf_step", "number", ["number", "number"], [h, 1]);
+      const row = [...heapF64(Module, ptr("qpos", h), nq), ...heapF64(Module, ptr("qvel", h), nv)];
+      assert.deepStrictEqual(R.slice((k * H + t) * stride, (k * H + t + 1) * stride), row, `rollout ${k} step ${t}`);
+    }
+  }
+
+  // Split across workers: identical tensor.
+  const threads = Module.ccall("mjwf_set_threads", "number", ["number"], [3]);
+  assert.strictEqual(rollout(h, state0, STATE_FULLPHYSICS, ctrls, K, H, views, viewIds.length, out), 1);
+  assert.deepStrictEqual(Array.from(heapF64(Module, out, K * H * stride)), R, `threads=${threads}`);
+  Module.ccall("mjwf_set_threads", "number", ["number"], [1]);
+
+  for (const sig of [0, -1, 1 << 13]) {
+    assert.strictEqual(rollout(h, state0, sig, ctrls, K, H, views, viewIds.length, out), 0, `sig ${sig} rejected`);
+    assert.strictEqual(Module.ccall("mjwf_errno_last", "number", ["number"], [h]), 93);
+  }
+  new Int32Array(Module.HEAP8.buffer, views, 1)[0] = 9999;
+  assert.strictEqual(rollout(h, state0, STATE_FULLPHYSICS, ctrls, K, H, views, 1, out), 0, "unknown view rejected");
+
+  [state0, ctrls, views, out].forEach((p) => free(p));
+  Module.ccall("mjwf_free", null, ["number"], [h]);
+  console.log(`rollout(${mjver}) OK`);
+}
@@ -0,0 +1,109 @@
+import assert from "node:assert/strict";
+import { loadHandleBundle, makeHandle, heapF64 } from "./_harness.mjs";
+
+const MJOBJ_SENSOR = 20;
+
+// Pendulum with sensors laid out as: hinge_pos 0, hinge_vel 1, tip_pos 2..4,
+// ball_pos 5..7, ball_quat 8..11.
+const SENSOR_XML = `<mujoco model="sensors">
+  <option timestep="0.002"/>
+  <worldbody>
+    <geom type="plane" size="2 2 0.1"/>
+    <body name="link" pos="0 0 1">
+      <joint name="hinge" type="hinge" axis="0 1 0"/>
+      <geom type="capsule" fromto="0 0 0 0 0 -0.2" size="0.02"/>
+      <site name="tip" pos="0 0 -0.2"/>
+    </body>
+    <body name="ball" pos="0.5 0 0.3"><freejoint/><geom type="sphere" size="0.05"/></body>
+  </worldbody>
+  <actuator><motor joint="hinge"/></actuator>
+  <sensor>
+    <jointpos name="hinge_pos" joint="hinge"/>
+    <jointvel name="hinge_vel" joint="hinge"/>
+    <framepos name="tip_pos" objtype="site" objname="tip"/>
+    <framepos name="ball_pos" objtype="body" objname="ball"/>
+    <framequat name="ball_quat" objtype="body" objname="ball"/>
+  </sensor>
+</mujoco>`;
+
+const ctx = await loadHandleBundle("sensors");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const call = (name, ...args) => Module.ccall(name, "number", args.map(() => "number"), args);
+  const select = (h, names) => Module.ccall("mjwf_sensor_select", "number", ["number", "string"], [h, names]);
+  const errno = (h) => call("mjwf_errno_last", h);
+  const malloc = (n) => call("mjwf_mju_malloc", n);
+  const sensordata = (h) => Array.from(heapF64(Module, call("mjwf_sensordata_ptr", h), call("mjwf_nsensordata", h)));
+  const kick = (h) => {
+    heapF64(Module, call("mjwf_ctrl_ptr", h), 1)[0] = 0.7;
+    call("mjwf_step", h, 20);
+  };
+  const out = malloc(8 * 64);
+  const packed = (n) => Array.from(heapF64(Module, out, n));
+
+  const h = makeHandle(Module, SENSOR_XML, "/sensors.xml");
+  assert.strictEqual(call("mjwf_sensor_gather", h, out), -1);
+  assert.strictEqual(errno(h), 191, "no subset yet");
+  assert.strictEqual(select(h, "tip_pos, hinge_pos,hinge_vel"), 5);
+  assert.deepStrictEqual([0, 1, 2, 3].map((k) => call("mjwf_sensor_offset", h, k)), [0, 3, 4, 5]);
+  assert.strictEqual(call("mjwf_sensor_offset", h, 4), -1);
+
+  // Gather packs in list order and matches sensordata indexing.
+  kick(h);
+  const full = sensordata(h);
+  assert.strictEqual(call("mjwf_sensor_gather", h, out), 5);
+  assert.deepStrictEqual(packed(5), [...full.slice(2, 5), full[0], full[1]]);
+
+  // Unknown names fail and keep the previous subset.
+  assert.strictEqual(select(h, "hinge_pos,nope"), -1);
+  assert.strictEqual(errno(h), 190);
+  assert.match(Module.ccall("mjwf_errmsg_last", "string", ["number"], [h]), /nope/);
+  assert.strictEqual(select(h, " , "), -1);
+  assert.strictEqual(call("mjwf_sensor_gather", h, out), 5);
+
+  // Fused stepping: one packed row per step, same trajectory as plain steps.
+  const twin = makeHandle(Module, SENSOR_XML, "/twin.xml");
+  kick(twin);
+  select(h, "ball_quat,hinge_vel");
+  assert.strictEqual(call("mjwf_step_gather", h, 4, out), 4 * 5);
+  const rows = packed(20);
+  for (let i = 0; i < 4; i += 1) {
+    call("mjwf_step", twin, 1);
+    const s = sensordata(twin);
+    assert.deepStrictEqual(rows.slice(5 * i, 5 * i + 5), [...s.slice(8, 12), s[1]], `row ${i}`);
+  }
+
+  // Batched readout across handles with different subsets, stepping them first.
+  select(twin, "ball_pos");
+  const hs = malloc(8);
+  new Int32Array(Module.HEAP8.buffer, hs, 2).set([twin, h]);
+  const before = [sensordata(twin), sensordata(h)];
+  assert.strictEqual(call("mjwf_sensor_gather_batch", hs, 2, 0, out), 3 + 5);
+  assert.deepStrictEqual(packed(8), [...before[0].slice(5, 8), ...before[1].slice(8, 12), before[1][1]]);
+  assert.strictEqual(call("mjwf_sensor_gather_batch", hs, 2, 3, out), 8);
+  assert.strictEqual(call("mjwf_time", h), call("mjwf_time", twin), "both stepped");
+  assert.deepStrictEqual(packed(3), sensordata(twin).slice(5, 8));
+  new Int32Array(Module.HEAP8.buffer, hs, 2).set([h, h]);
+  assert.strictEqual(call("mjwf_sensor_gather_batch", hs, 2, 1, out), -1, "duplicate handle");
+  const bare = makeHandle(Module, SENSOR_XML, "/bare.xml");
+  new Int32Array(Module.HEAP8.buffer, hs, 2).set([h, bare]);
+  assert.strictEqual(call("mjwf_sensor_gather_batch", hs, 2, 0, out), -1, "handle without subset");
+
+  // Recompiling re-resolves the names against the new sensor_adr.
+  Module.FS.writeFile("/sensors_edit.xml", SENSOR_XML);
+  const e = Module.ccall("mjwf_make_editable", "number", ["string"], ["/sensors_edit.xml"]);
+  assert.strictEqual(select(e, "ball_quat"), 4);
+  assert.strictEqual(Module.ccall("mjwf_edit_delete", "number", ["number", "number", "string"], [e, MJOBJ_SENSOR, "tip_pos"]), 1);
+  assert.strictEqual(call("mjwf_recompile", e), 1);
+  assert.strictEqual(call("mjwf_nsensordata", e), 9);
+  call("mjwf_forward", e);
+  assert.strictEqual(call("mjwf_sensor_gather", e, out), 4);
+  assert.deepStrictEqual(packed(4), sensordata(e).slice(5, 9));
+  assert.strictEqual(Module.ccall("mjwf_edit_delete", "number", ["number", "number", "string"], [e, MJOBJ_SENSOR, "ball_quat"]), 1);
+  assert.strictEqual(call("mjwf_recompile", e), 1);
+  assert.strictEqual(call("mjwf_sensor_gather", e, out), -1);
+  assert.strictEqual(errno(e), 190, "selected sensor was deleted");
+
+  for (const x of [h, twin, bare, e]) call("mjwf_free", x);
+  console.log(`sensors(${mjver}): ok`);
+}
@@ -0,0 +1,97 @@
+import assert from "node:assert/strict";
+import { loadHandleBundle, makeHandle, heapF64, PENDULUM_XML } from "./_harness.mjs";
+
+const KEYFRAME = 1;
+const KINEMATICS = 2;
+const QUANTUM = 1e-4;
+
+const ctx = await loadHandleBundle("snapshot");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const call = (name, ...args) => Module.ccall(name, "number", args.map(() => "number"), args);
+  const viewId = (name) => Module.ccall("mjwf_view_id", "number", ["string"], [name]);
+  const errno = (h) => Module.ccall("mjwf_errno_last", "number", ["number"], [h]);
+  const malloc = (n) => Module.ccall("mjwf_mju_malloc", "number", ["number"], [n]);
+
+  const sim = makeHandle(Module, PENDULUM_XML, "/sim.xml");
+  const viewer = makeHandle(Module, PENDULUM_XML, "/viewer.xml");
+  const nq = call("mjwf_nq", sim);
+  const nv = call("mjwf_nv", sim);
+  const ngeom = call("mjwf_ngeom", sim);
+
+  // qpos quantized, qvel lossless; same field set on both ends.
+  const fields = malloc(8);
+  const quanta = malloc(16);
+  new Int32Array(Module.HEAP8.buffer, fields, 2).set([viewId("qpos"), viewId("qvel")]);
+  heapF64(Module, quanta, 2).set([QUANTUM, 0]);
+  assert.strictEqual(call("mjwf_snapshot_config", sim, fields, quanta, 2, 8), 1);
+  assert.strictEqual(call("mjwf_snapshot_config", viewer, fields, quanta, 2, 8), 1);
+  const cap = call("mjwf_snapshot_max_bytes", sim);
+  const buf = malloc(cap);
+
+  heapF64(Module, call("mjwf_ctrl_ptr", sim), 1)[0] = 0.3;
+  const sizes = [];
+  for (let t = 0; t < 40; t += 1) {
+    call("mjwf_step", sim, 5);
+    const n = call("mjwf_snapshot_encode", sim, 0, buf, cap);
+    assert.ok(n > 0);
+    sizes.push(n);
+    const key = Module.HEAPU8[buf + 3] & KEYFRAME;
+    assert.strictEqual(key !== 0, t % 8 === 0, `keyframe every 8 packets (t=${t})`);
+    assert.strictEqual(call("mjwf_snapshot_apply", viewer, buf, n, KINEMATICS), 1);
+
+    const qs = heapF64(Module, call("mjwf_qpos_ptr", sim), nq);
+    const qv = heapF64(Module, call("mjwf_qpos_ptr", viewer), nq);
+    for (let i = 0; i < nq; i += 1) assert.ok(Math.abs(qs[i] - qv[i]) <= QUANTUM / 2 + 1e-12, `qpos[${i}]`);
+    assert.deepStrictEqual(heapF64(Module, call("mjwf_qvel_ptr", viewer), nv),
+      heapF64(Module, call("mjwf_qvel_ptr", sim), nv), "lossless field is exact");
+  }
+  // Deltas are much smaller than keyframes, and kinematics ran on the viewer.
+  assert.ok(sizes[1] < sizes[0], `delta ${sizes[1]} < keyframe ${sizes[0]}`);
+  const xs = heapF64(Module, call("mjwf_geom_xpos_ptr", sim), 3 * ngeom);
+  const xv = heapF64(Module, call("mjwf_geom_xpos_ptr", viewer), 3 * ngeom);
+  for (let i = 0; i < 3 * ngeom; i += 1) assert.ok(Math.abs(xs[i] - xv[i]) < 1e-3);
+
+  // A viewer that joins late cannot use deltas until it sees a keyframe.
+  const late = makeHandle(Module, PENDULUM_XML, "/late.xml");
+  call("mjwf_snapshot_config", late, fields, quanta, 2, 8);
+  let n = call("mjwf_snapshot_encode", sim, 0, buf, cap);
+  assert.strictEqual(call("mjwf_snapshot_apply", late, buf, n, 0), 0);
+  assert.strictEqual(errno(late), 173);
+  n = call("mjwf_snapshot_encode", sim, KEYFRAME, buf, cap);
+  assert.strictEqual(call("mjwf_snapshot_apply", late, buf, n, 0), 1);
+
+  // Truncated packets and mismatched field sets are rejected.
+  assert.strictEqual(call("mjwf_snapshot_apply", late, buf, n - 1, 0), 0);
+  assert.strictEqual(errno(late), 172);
+  call("mjwf_snapshot_config", late, fields, quanta, 1, 0);
+  assert.strictEqual(call("mjwf_snapshot_apply", late, buf, n, 0), 0);
+  assert.strictEqual(errno(late), 172);
+
+  // Model views are applied through the viewer's overlay only: plain model
+  // arrays are rejected, and a shared viewer leaves its base model untouched.
+  const fields1 = (name) => {
+    new Int32Array(Module.HEAP8.buffer, fields, 1)[0] = viewId(name);
+    return fields;
+  };
+  assert.strictEqual(call("mjwf_snapshot_config", late, fields1("geom_size"), 0, 1, 0), 0);
+  assert.strictEqual(errno(late), 170);
+  const twin = call("mjwf_make_shared", late);
+  const nbody = call("mjwf_view_len", sim, viewId("body_mass"));
+  const mass = (h) => Array.from(heapF64(Module, call("mjwf_body_mass_ptr", h), nbody));
+  const nominal = mass(sim);
+  heapF64(Module, call("mjwf_body_mass_ptr", sim), nbody)[1] *= 2;
+  for (const h of [sim, twin]) assert.strictEqual(call("mjwf_snapshot_config", h, fields1("body_mass"), 0, 1, 0), 1);
+  const mbuf = malloc(call("mjwf_snapshot_max_bytes", sim));
+  n = call("mjwf_snapshot_encode", sim, KEYFRAME, mbuf, call("mjwf_snapshot_max_bytes", sim));
+  assert.strictEqual(call("mjwf_snapshot_apply", twin, mbuf, n, 0), 1);
+  assert.deepStrictEqual(mass(twin), mass(sim));
+  // First access to the base's array copies the shared model as it is now.
+  assert.deepStrictEqual(mass(late), nominal, "base model unchanged");
+  call("mjwf_free", twin);
+  Module.ccall("mjwf_mju_free", null, ["number"], [mbuf]);
+
+  [sim, viewer, late].forEach((h) => call("mjwf_free", h));
+  [fields, quanta, buf].forEach((p) => Module.ccall("mjwf_mju_free", null, ["number"], [p]));
+  console.log(`snapshot(${mjver}): OK`);
+}
@@ -0,0 +1,79 @@
+import assert from "node:assert/strict";
+import { loadHandleBundle, makeHandle, ARM_XML } from "./_harness.mjs";
+import { VecEnv, DONE, DONE_OP, NSTAT } from "../../wrappers/js/mjwf_vecenv.mjs";
+
+const ctx = await loadHandleBundle("vecenv");
+if (ctx) {
+  const { Module, mjver } = ctx;
+  const h = makeHandle(Module, ARM_XML);
+  const nq = Module.ccall("mjwf_nq", "number", ["number"], [h]);
+  const nv = Module.ccall("mjwf_nv", "number", ["number"], [h]);
+  const N = 4;
+
+  const env = new VecEnv(Module, h, N, "proprio");
+  assert.strictEqual(env.obsDim, nq + nv, "proprio = qpos | qvel");
+  assert.strictEqual(Module.ccall("mjwf_obs_layout_dim", "number", ["number", "number"],
+    [h, Module.ccall("mjwf_obs_layout_id", "number", ["string"], ["proprio"])]), nq + nv);
+
+  // Deterministic per-env noise: distinct across envs, repeatable per seed.
+  env.setNoise(0.1, 0.0);
+  env.seed(42);
+  const a = Array.from(env.reset());
+  assert.notDeepStrictEqual(a.slice(0, nq), a.slice(env.obsDim, env.obsDim + nq), "envs get different noise");
+  assert.deepStrictEqual(Array.from(env.reset()), a, "same seed, same initial states");
+  env.seed(43);
+  assert.notDeepStrictEqual(Array.from(env.reset()), a, "new seed, new initial states");
+
+  // Time limit: 5 steps of 2 ms, then every env is truncated and reset.
+  env.setNoise(0, 0);
+  env.setTimeLimit(0.01);
+  env.reset();
+  env.actions.fill(0.5);
+  for (let t = 1; t <= 5; t += 1) {
+    const { done, stats } = env.step();
+    const expect = t === 5 ? DONE.TRUNCATED : DONE.RUNNING;
+    assert.deepStrictEqual(Array.from(done), Array(N).fill(expect), `step ${t} done`);
+    if (t < 5) assert.strictEqual(stats[1], t, "steps in episode");
+  }
+  const st = Array.from(env.stats);
+  for (let i = 0; i < N; i += 1) {
+    assert.deepStrictEqual(st.slice(NSTAT * i, NSTAT * (i + 1)), [1, 0, 5], `env ${i} stats after truncation`);
+  }
+  assert.ok(env.finalObs[nq] > 0, "final obs keeps the pre-reset qvel");
+  assert.strictEqual(env.obs[nq], 0, "obs is the reset state");
+
+  // Predicate: |qvel[0]| > 0.2 terminates; only env 0 is pushed hard.
+  env.setTimeLimit(0);
+  env.doneIf("qvel", 0, DONE_OP.ABS_GT, 0.2);
+  env.reset();
+  let terminated = -1;
+  for (let t = 1; t <= 200 && terminated < 0; t += 1) {
+    const acts = env.actions;
+    acts.fill(0);
+    acts[0] = 5;
+    const { done } = env.step();
+    assert.deepStrictEqual(Array.from(done).slice(1), Array(N - 1).fill(0), "idle envs keep running");
+    if (done[0] === DONE.TERMINATED) terminated = t;
+  }
+  assert.ok(terminated > 0, "env 0 terminated");
+  assert.ok(Math.abs(env.finalObs[nq]) > 0.2, "final obs tripped the predicate");
+  assert.strictEqual(env.stats[2], terminated, "last episode length");
+
+  // Worker split does not change results.
+  const run = (threads) => {
+    Module.ccall("mjwf_set_threads", "number", ["number"], [threads]);
+    env.setNoise(0.05, 0.05);
+    env.seed(7);
+    env.reset();
+    for (let t = 0; t < 20; t += 1) {
+      env.actions.forEach((_, i, arr) => { arr[i] = Math.sin(i + t); });
+      env.step();
+    }
+    return Array.from(env.obs);
+  };
+  assert.deepStrictEqual(run(3), run(1), "threaded vecenv matches serial");
+
+  env.dispose();
+  Module.ccall("mjwf_free", null, ["number"], [h]);
+  console.log(`vecenv(${mjver}) OK`);
+}
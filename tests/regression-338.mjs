@@ -61,9 +61,13 @@ for (const name of exportsList) {
 const missingRequired = [...required].filter((name) => !actual.has(name));
 const missingOptional = [...optional].filter((name) => !actual.has(name));
 
+// Bundles built with -DMJWF_HANDLE_API=ON additionally export the mjwf handle layer.
+const handleApi = exportsList.includes("mjwf_abi_version");
+
 const unexpected = exportsList.filter((name) => {
   const normalized = name.startsWith("_") ? name : `_${name}`;
   if (required.has(normalized) || optional.has(normalized)) return false;
+  if (handleApi && normalized.startsWith("_mjwf_")) return false;
   if (runtimeKeep.has(name) || runtimeKeep.has(normalized)) return false;
   if (allowedRuntime.has(name)) return false;
   return true;
@@ -0,0 +1,175 @@
+// Command-buffer encoder/decoder for mjwf_cmdbuf_exec.
+// Layout is documented in wrappers/official_app_*/src/mjwf_cmdbuf.c; records are
+// written straight into WASM memory so one exec call replaces a chain of cwraps.
+
+export const CMD = Object.freeze({
+  SET_VIEW: 1,
+  STEP: 2,
+  FORWARD: 3,
+  RESET: 4,
+  SAVE_STATE: 5,
+  RESTORE_STATE: 6,
+  GATHER_VIEW: 7,
+  GATHER_CONTACTS: 8,
+});
+
+export const STATUS = Object.freeze({
+  OK: 0,
+  E_HANDLE: 1,
+  E_OP: 2,
+  E_ARG: 3,
+  E_VIEW: 4,
+  E_RANGE: 5,
+  E_STATE: 6,
+  E_REPLY: 7,
+});
+
+export const DTYPE = Object.freeze({ F64: 0, F32: 1, I32: 2 });
+
+const CMDBUF_MAGIC = 0x42434a4d; // "MJCB"
+const REPLY_MAGIC = 0x42524a4d; // "MJRB"
+const VERSION = 1;
+const HEADER_BYTES = 16;
+const RECORD_BYTES = 16;
+const CONTACT_BYTES = 40;
+
+const align8 = (n) => (n + 7) & ~7;
+
+export class CmdBufWriter {
+  constructor(buffer, byteOffset, capacity) {
+    this.view = new DataView(buffer, byteOffset, capacity);
+    this.capacity = capacity;
+    this.off = HEADER_BYTES;
+    this.count = 0;
+  }
+
+  #record(op, handle, arg, payloadBytes) {
+    const size = align8(payloadBytes);
+    if (this.off + RECORD_BYTES + size > this.capacity) {
+      throw new RangeError('command buffer full');
+    }
+    const v = this.view;
+    v.setUint16(this.off, op, true);
+    v.setUint16(this.off + 2, 0, true);
+    v.setInt32(this.off + 4, handle, true);
+    v.setUint32(this.off + 8, size, true);
+    v.setInt32(this.off + 12, arg, true);
+    const payload = this.off + RECORD_BYTES;
+    this.off = payload + size;
+    this.count += 1;
+    return payload;
+  }
+
+  setView(handle, viewId, values, { offset = 0, dtype = DTYPE.F64 } = {}) {
+    const esz = dtype === DTYPE.F64 ? 8 : 4;
+    const p = this.#record(CMD.SET_VIEW, handle, viewId, 8 + values.length * esz);
+    const v = this.view;
+    v.setInt32(p, offset, true);
+    v.setInt32(p + 4, values.length, true);
+    for (let i = 0; i < values.length; i += 1) {
+      const at = p + 8 + i * esz;
+      if (dtype === DTYPE.F64) v.setFloat64(at, values[i], true);
+      else if (dtype === DTYPE.F32) v.setFloat32(at, values[i], true);
+      else v.setInt32(at, values[i], true);
+    }
+    return this;
+  }
+
+  step(handle, n = 1) { this.#record(CMD.STEP, handle, n, 0); return this; }
+  forward(handle) { this.#record(CMD.FORWARD, handle, 0, 0); return this; }
+  reset(handle, key = -1) { this.#record(CMD.RESET, handle, key, 0); return this; }
+  saveState(handle, slot = 0) { this.#record(CMD.SAVE_STATE, handle, slot, 0); return this; }
+  restoreState(handle, slot = 0) { this.#record(CMD.RESTORE_STATE, handle, slot, 0); return this; }
+  gatherContacts(handle) { this.#record(CMD.GATHER_CONTACTS, handle, 0, 0); return this; }
+
+  gatherView(handle, viewId, { offset = 0, count = -1 } = {}) {
+    const p = this.#record(CMD.GATHER_VIEW, handle, viewId, 8);
+    this.view.setInt32(p, offset, true);
+    this.view.setInt32(p + 4, count, true);
+    return this;
+  }
+
+  // Writes the header and returns the encoded byte length.
+  finish() {
+    const v = this.view;
+    v.setUint32(0, CMDBUF_MAGIC, true);
+    v.setUint16(4, VERSION, true);
+    v.setUint16(6, 0, true);
+    v.setUint32(8, this.count, true);
+    v.setUint32(12, this.off, true);
+    return this.off;
+  }
+}
+
+// Decodes a reply into records; payload is a DataView into the reply memory,
+// so copy out anything needed after the next exec call.
+export function readReply(buffer, byteOffset, nbytes) {
+  const v = new DataView(buffer, byteOffset, nbytes);
+  if (v.getUint32(0, true) !== REPLY_MAGIC) throw new Error('bad reply magic');
+  const count = v.getUint32(8, true);
+  const records = [];
+  let off = HEADER_BYTES;
+  for (let i = 0; i < count; i += 1) {
+    const size = v.getUint32(off + 8, true);
+    records.push({
+      op: v.getUint16(off, true),
+      status: v.getUint16(off + 2, true),
+      handle: v.getInt32(off + 4, true),
+      arg: v.getInt32(off + 12, true),
+      payload: new DataView(buffer, byteOffset + off + RECORD_BYTES, size),
+    });
+    off += RECORD_BYTES + size;
+  }
+  return records;
+}
+
+export function decodeContacts(payload) {
+  const ncon = payload.getInt32(0, true);
+  const out = [];
+  for (let i = 0; i < ncon; i += 1) {
+    const at = 8 + i * CONTACT_BYTES;
+    out.push({
+      pos: [payload.getFloat64(at, true), payload.getFloat64(at + 8, true), payload.getFloat64(at + 16, true)],
+      dist: payload.getFloat64(at + 24, true),
+      geom: [payload.getInt32(at + 32, true), payload.getInt32(at + 36, true)],
+    });
+  }
+  return out;
+}
+
+// Owns a command and reply region in WASM memory (allocated via mju_malloc).
+export class CmdBufRunner {
+  constructor(Module, { cmdBytes = 1 << 16, replyBytes = 1 << 16 } = {}) {
+    this.Module = Module;
+    this.malloc = Module.cwrap('mjwf_mju_malloc', 'pointer', ['pointer']);
+    this.free = Module.cwrap('mjwf_mju_free', null, ['pointer']);
+    this.exec = Module.cwrap('mjwf_cmdbuf_exec', 'number', ['pointer', 'number', 'pointer', 'number']);
+    this.cmdBytes = cmdBytes;
+    this.replyBytes = replyBytes;
+    this.cmdPtr = this.malloc(cmdBytes);
+    this.replyPtr = this.malloc(replyBytes);
+    if (!this.cmdPtr || !this.replyPtr) throw new Error('cmdbuf allocation failed');
+  }
+
+  // Heap views must be re-derived after any call that may grow memory.
+  begin() {
+    return new CmdBufWriter(this.Module.HEAP8.buffer, this.cmdPtr, this.cmdBytes);
+  }
+
+  run(writer) {
+    const n = writer.finish();
+    const written = this.exec(this.cmdPtr, n, this.replyPtr, this.replyBytes);
+    if (written < 0) {
+      const msg = this.Module.ccall('mjwf_errmsg_last_global', 'string', [], []);
+      throw new Error(`mjwf_cmdbuf_exec failed: ${msg}`);
+    }
+    return readReply(this.Module.HEAP8.buffer, this.replyPtr, written);
+  }
+
+  dispose() {
+    this.free(this.cmdPtr);
+    this.free(this.replyPtr);
+    this.cmdPtr = 0;
+    this.replyPtr = 0;
+  }
+}
@@ -0,0 +1,43 @@
+// Frame pacing for interactive viewers over mjwf_step_for_budget.
+// Simulated time follows wall time; each frame spends at most budgetMs on
+// physics. When the simulation falls more than maxLag seconds behind, the
+// wall-clock anchor is moved so it continues in slow motion instead of
+// trying to catch up forever. Semantics of the underlying call are in
+// wrappers/official_app_*/src/mjwf_pacing.c.
+
+export const PACE = Object.freeze({ ADAPTIVE: 1 });
+export const NSTAT = 4; // steps, lag (s), avg step cost (us), wall time used (us)
+
+export class Pacer {
+  constructor(Module, handle, { budgetMs = 8, adaptive = true, maxLag = 0.25 } = {}) {
+    this.Module = Module;
+    this.handle = handle;
+    this.budgetUs = budgetMs * 1000;
+    this.flags = adaptive ? PACE.ADAPTIVE : 0;
+    this.maxLag = maxLag;
+    this._step = Module.cwrap('mjwf_step_for_budget', 'number', ['number', 'number', 'number', 'number', 'pointer']);
+    this._time = Module.cwrap('mjwf_time', 'number', ['number']);
+    this.statsPtr = Module.ccall('mjwf_mju_malloc', 'pointer', ['pointer'], [8 * NSTAT]);
+    this.anchor = null;
+  }
+
+  // Re-anchor after the sim time was changed externally (reset, state restore).
+  resync() { this.anchor = null; }
+
+  // Call once per animation frame with its timestamp in milliseconds.
+  frame(nowMs) {
+    if (!this.anchor) this.anchor = { wallMs: nowMs, sim: this._time(this.handle) };
+    const target = this.anchor.sim + (nowMs - this.anchor.wallMs) / 1000;
+    if (this._step(this.handle, target, this.budgetUs, this.flags, this.statsPtr) < 0) {
+      throw new Error(`mjwf_step_for_budget failed: ${this.Module.ccall('mjwf_errmsg_last', 'string', ['number'], [this.handle])}`);
+    }
+    const [steps, lag, stepUs, usedUs] = new Float64Array(this.Module.HEAP8.buffer, this.statsPtr, NSTAT);
+    if (lag > this.maxLag) this.anchor.wallMs += (lag - this.maxLag) * 1000;
+    return { steps, lag, stepUs, usedUs };
+  }
+
+  dispose() {
+    this.Module.ccall('mjwf_mju_free', null, ['pointer'], [this.statsPtr]);
+    this.statsPtr = 0;
+  }
+}
@@ -0,0 +1,182 @@
+// Worker pool over one compiled mujoco.wasm.
+// The module is compiled once on the calling thread and posted to every
+// worker, which only instantiates it: no per-worker fetch or compile. Handles
+// live inside the workers; MjwfPool places each new handle on the worker with
+// the fewest handles (ties: fewest requests in flight) and exposes
+// create/step/read/write/free over the whole pool as one async API. Requests
+// to one worker run in order; different workers step in parallel.
+//
+// Needs a bundle built with -DMJWF_HANDLE_API=ON. Runs on Node
+// (worker_threads) and in browsers (module workers). CI ships this file and
+// mjwf_pool_worker.mjs in dist/<ver>/ next to mujoco.js/mujoco.wasm, which is
+// where the bundle is looked up by default.
+
+const IS_NODE = typeof process !== 'undefined' && !!process.versions?.node;
+
+// Node accepts file paths and file: URLs, but not file: URL strings.
+const nodeLocation = (u) => (String(u).startsWith('file:') ? new URL(String(u)) : String(u));
+
+async function readBytes(url) {
+  if (IS_NODE) {
+    const fs = await import('node:fs/promises');
+    return fs.readFile(nodeLocation(url));
+  }
+  const res = await fetch(url);
+  if (!res.ok) throw new Error(`fetch ${url}: ${res.status}`);
+  return res.arrayBuffer();
+}
+
+async function spawnWorker(url) {
+  if (IS_NODE) {
+    const { Worker } = await import('node:worker_threads');
+    const w = new Worker(nodeLocation(url));
+    return {
+      post: (msg, transfer) => w.postMessage(msg, transfer),
+      listen: (onMessage, onError) => { w.on('message', onMessage); w.on('error', onError); },
+      terminate: () => w.terminate(),
+    };
+  }
+  const w = new Worker(url, { type: 'module' });
+  return {
+    post: (msg, transfer) => w.postMessage(msg, transfer),
+    listen: (onMessage, onError) => {
+      w.onmessage = (e) => onMessage(e.data);
+      w.onerror = (e) => onError(new Error(e.message));
+    },
+    terminate: () => w.terminate(),
+  };
+}
+
+class PoolWorker {
+  constructor(index, port) {
+    this.index = index;
+    this.port = port;
+    this.handles = 0;
+    this.pending = new Map();
+    this.nextReq = 1;
+    port.listen((msg) => this.settle(msg), (err) => {
+      for (const { reject } of this.pending.values()) reject(err);
+      this.pending.clear();
+    });
+  }
+
+  request(op, args = {}, transfer = []) {
+    const req = this.nextReq++;
+    return new Promise((resolve, reject) => {
+      this.pending.set(req, { resolve, reject });
+      this.port.post({ req, op, args }, transfer);
+    });
+  }
+
+  settle({ req, ok, result, error }) {
+    const p = this.pending.get(req);
+    if (!p) return;
+    this.pending.delete(req);
+    if (ok) p.resolve(result);
+    else p.reject(new Error(`worker ${this.index}: ${error}`));
+  }
+}
+
+export class MjwfPool {
+  // shareModule: false makes every worker fetch and compile mujoco.wasm itself
+  // (the pre-pool behaviour, kept for benchmarks).
+  static async create({
+    workers = 4,
+    jsURL = new URL('./mujoco.js', import.meta.url),
+    wasmURL = new URL('./mujoco.wasm', import.meta.url),
+    workerURL = new URL('./mjwf_pool_worker.mjs', import.meta.url),
+    shareModule = true,
+  } = {}) {
+    const t0 = performance.now();
+    const module = shareModule ? await WebAssembly.compile(await readBytes(wasmURL)) : null;
+    const compileMs = performance.now() - t0;
+    const pool = new MjwfPool();
+    pool.workers = await Promise.all(Array.from({ length: workers }, async (_, i) => {
+      const w = new PoolWorker(i, await spawnWorker(String(workerURL)));
+      const { instantiateMs } = await w.request('init', { module, jsURL: String(jsURL), wasmURL: String(wasmURL) });
+      w.instantiateMs = instantiateMs;
+      return w;
+    }));
+    pool.startup = {
+      compileMs,
+      instantiateMs: pool.workers.map((w) => w.instantiateMs),
+      readyMs: performance.now() - t0,
+    };
+    return pool;
+  }
+
+  constructor() {
+    this.workers = [];
+    this.handles = new Map(); // pool id -> { worker, h }
+    this.nextId = 1;
+  }
+
+  pick() {
+    let best = this.workers[0];
+    for (const w of this.workers) {
+      if (w.handles < best.handles || (w.handles === best.handles && w.pending.size < best.pending.size)) best = w;
+    }
+    return best;
+  }
+
+  entry(id) {
+    const e = this.handles.get(id);
+    if (!e) throw new Error(`unknown pool handle ${id}`);
+    return e;
+  }
+
+  // Resolves to a pool handle id; rejects with the compiler's message.
+  async createHandle(xml) {
+    const worker = this.pick();
+    worker.handles += 1;
+    try {
+      const h = await worker.request('create', { xml });
+      const id = this.nextId++;
+      this.handles.set(id, { worker, h });
+      return id;
+    } catch (err) {
+      worker.handles -= 1;
+      throw err;
+    }
+  }
+
+  // Resolves to the handle's simulation time after n steps.
+  async step(id, n = 1) {
+    const { worker, h } = this.entry(id);
+    return worker.request('step', { h, n });
+  }
+
+  // Steps every handle in the pool n times; resolves to the total step count.
+  async stepAll(n = 1) {
+    const done = await Promise.all(this.workers.map((w) => w.request('stepAll', { n })));
+    return done.reduce((a, b) => a + b, 0);
+  }
+
+  // Copies of spec views by name, e.g. read(id, ['qpos', 'sensordata']).
+  async read(id, views = ['qpos']) {
+    const { worker, h } = this.entry(id);
+    return worker.request('read', { h, views });
+  }
+
+  async write(id, view, values) {
+    const { worker, h } = this.entry(id);
+    return worker.request('write', { h, view, values: Float64Array.from(values) });
+  }
+
+  async free(id) {
+    const { worker, h } = this.entry(id);
+    this.handles.delete(id);
+    worker.handles -= 1;
+    await worker.request('free', { h });
+  }
+
+  stats() {
+    return this.workers.map((w) => ({ worker: w.index, handles: w.handles, pending: w.pending.size }));
+  }
+
+  async close() {
+    await Promise.all(this.workers.map((w) => w.port.terminate()));
+    this.workers = [];
+    this.handles.clear();
+  }
+}
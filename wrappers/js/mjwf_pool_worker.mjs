@@ -0,0 +1,122 @@
+// Worker side of MjwfPool (mjwf_pool.mjs). Instantiates the WebAssembly.Module
+// posted with 'init' (or, without one, loads mujoco.wasm itself) and serves
+// handle requests one at a time: { req, op, args } -> { req, ok, result | error }.
+
+const IS_NODE = typeof process !== 'undefined' && !!process.versions?.node;
+const DTYPE_ARRAY = [Float64Array, Float32Array, Int32Array]; // MJWF_DTYPE_*
+
+let port;
+if (IS_NODE) {
+  const { parentPort } = await import('node:worker_threads');
+  port = { post: (msg, transfer) => parentPort.postMessage(msg, transfer), listen: (fn) => parentPort.on('message', fn) };
+} else {
+  port = { post: (msg, transfer) => self.postMessage(msg, transfer), listen: (fn) => { self.onmessage = (e) => fn(e.data); } };
+}
+
+let Module = null;
+let nextFile = 1;
+const handles = new Set();
+
+const call = (name, ...args) => Module.ccall(name, 'number', args.map(() => 'number'), args);
+const globalError = () => Module.ccall('mjwf_errmsg_last_global', 'string', [], []);
+const handleError = (h) => Module.ccall('mjwf_errmsg_last', 'string', ['number'], [h]);
+
+function owned(h) {
+  if (!handles.has(h)) throw new Error(`handle ${h} is not owned by this worker`);
+  return h;
+}
+
+// (typed-array constructor, pointer, length) of a spec view on h. Reads use
+// mjwf_view_addr so a shared handle's overlay views stay shared; only writes
+// go through mjwf_<name>_ptr, which acquires a private copy first.
+function view(h, name, { write = false } = {}) {
+  const id = Module.ccall('mjwf_view_id', 'number', ['string'], [name]);
+  if (id < 0) throw new Error(`unknown view ${name}`);
+  const ptr = write
+    ? Module.ccall(`mjwf_${name}_ptr`, 'pointer', ['number'], [h])
+    : Module.ccall('mjwf_view_addr', 'pointer', ['number', 'number'], [h, id]);
+  return { id, Array: DTYPE_ARRAY[call('mjwf_view_dtype', id)], ptr, len: call('mjwf_view_len', h, id) };
+}
+
+const ops = {
+  async init({ module, jsURL, wasmURL }) {
+    const t0 = performance.now();
+    const factory = (await import(jsURL)).default;
+    const wasmPath = IS_NODE && wasmURL.startsWith('file:')
+      ? (await import('node:url')).fileURLToPath(wasmURL)
+      : wasmURL;
+    Module = await factory(module
+      ? {
+        instantiateWasm: (imports, receive) => {
+          WebAssembly.instantiate(module, imports).then((instance) => receive(instance, module));
+          return {};
+        },
+      }
+      : { locateFile: (p) => (p.endsWith('.wasm') ? wasmPath : p) });
+    if (Module.ready) await Module.ready;
+    if (typeof Module._mjwf_valid !== 'function') throw new Error('bundle built without MJWF_HANDLE_API');
+    return { instantiateMs: performance.now() - t0 };
+  },
+
+  create({ xml }) {
+    const file = `/mjwf_pool_${nextFile++}.xml`;
+    Module.FS.writeFile(file, xml);
+    const h = Module.ccall('mjwf_make_from_xml', 'number', ['string'], [file]);
+    Module.FS.unlink(file);
+    if (h <= 0) throw new Error(globalError());
+    handles.add(h);
+    return h;
+  },
+
+  step({ h, n }) {
+    if (!call('mjwf_step', owned(h), n)) throw new Error(handleError(h));
+    return Module.ccall('mjwf_time', 'number', ['number'], [h]);
+  },
+
+  stepAll({ n }) {
+    for (const h of handles) {
+      if (!call('mjwf_step', h, n)) throw new Error(`handle ${h}: ${handleError(h)}`);
+    }
+    return handles.size * n;
+  },
+
+  read({ h, views }) {
+    owned(h);
+    const out = {};
+    for (const name of views) {
+      const v = view(h, name);
+      out[name] = new v.Array(Module.HEAP8.buffer, v.ptr, v.len).slice();
+    }
+    return out;
+  },
+
+  write({ h, view: name, values }) {
+    const v = view(owned(h), name, { write: true });
+    if (!call('mjwf_view_writable', v.id)) throw new Error(`view ${name} is read-only`);
+    if (values.length > v.len) throw new Error(`view ${name} holds ${v.len} values, got ${values.length}`);
+    new v.Array(Module.HEAP8.buffer, v.ptr, v.len).set(values);
+    return values.length;
+  },
+
+  free({ h }) {
+    call('mjwf_free', owned(h));
+    handles.delete(h);
+    return 0;
+  },
+};
+
+// Requests run strictly in arrival order, so init finishes before the rest.
+let queue = Promise.resolve();
+port.listen(({ req, op, args }) => {
+  queue = queue.then(async () => {
+    try {
+      if (!ops[op]) throw new Error(`unknown op ${op}`);
+      if (op !== 'init' && !Module) throw new Error('worker not initialized');
+      const result = await ops[op](args);
+      const transfer = op === 'read' ? Object.values(result).map((a) => a.buffer) : [];
+      port.post({ req, ok: true, result }, transfer);
+    } catch (err) {
+      port.post({ req, ok: false, error: err.message || String(err) });
+    }
+  });
+});
@@ -0,0 +1,72 @@
+// Vector-env wrapper for mjwf_vecenv_*.
+// Owns the packed action/obs/done/stats buffers in WASM memory and hands out
+// typed-array views over them; semantics are documented in
+// wrappers/official_app_*/src/mjwf_vecenv.c.
+
+export const DONE = Object.freeze({ RUNNING: 0, TERMINATED: 1, TRUNCATED: 2 });
+export const DONE_OP = Object.freeze({ LT: 0, GT: 1, ABS_GT: 2 });
+export const NSTAT = 3; // episodes, steps, last length
+
+export class VecEnv {
+  constructor(Module, handle, n, layout = 'proprio') {
+    const c = (name, ret, args) => Module.cwrap(name, ret, args);
+    this.Module = Module;
+    this.malloc = c('mjwf_mju_malloc', 'pointer', ['pointer']);
+    this.free = c('mjwf_mju_free', null, ['pointer']);
+    this._step = c('mjwf_vecenv_step', 'number', ['number', 'pointer', 'pointer', 'pointer', 'pointer', 'pointer']);
+    this._reset = c('mjwf_vecenv_reset', 'number', ['number', 'pointer']);
+    const layoutId = Module.ccall('mjwf_obs_layout_id', 'number', ['string'], [layout]);
+    if (layoutId < 0) throw new Error(`unknown observation layout ${layout}`);
+    this.id = Module.ccall('mjwf_vecenv_create', 'number', ['number', 'number', 'number'], [handle, n, layoutId]);
+    if (!this.id) {
+      throw new Error(`mjwf_vecenv_create failed: ${Module.ccall('mjwf_errmsg_last', 'string', ['number'], [handle])}`);
+    }
+    this.handle = handle;
+    this.n = n;
+    this.nu = Module.ccall('mjwf_nu', 'number', ['number'], [handle]);
+    this.obsDim = Module.ccall('mjwf_vecenv_obs_dim', 'number', ['number'], [this.id]);
+    this.actPtr = this.malloc(8 * Math.max(1, n * this.nu));
+    this.obsPtr = this.malloc(8 * n * this.obsDim);
+    this.finalPtr = this.malloc(8 * n * this.obsDim);
+    this.donePtr = this.malloc(n);
+    this.statsPtr = this.malloc(4 * n * NSTAT);
+  }
+
+  call(name, ...args) {
+    const types = args.map(() => 'number');
+    return this.Module.ccall(`mjwf_vecenv_${name}`, 'number', ['number', ...types], [this.id, ...args]);
+  }
+
+  setTimeLimit(seconds) { return this.call('set_time_limit', seconds); }
+  setFrameSkip(n) { return this.call('set_frame_skip', n); }
+  setNoise(qposScale, qvelScale) { return this.call('set_noise', qposScale, qvelScale); }
+  seed(seed) { return this.call('seed', seed >>> 0); }
+  doneIf(view, index, op, value) {
+    const id = this.Module.ccall('mjwf_view_id', 'number', ['string'], [view]);
+    if (!this.call('add_done_if', id, index, op, value)) throw new Error(`bad done predicate on ${view}[${index}]`);
+  }
+
+  // Heap views must be re-derived after any call that may grow memory.
+  get actions() { return new Float64Array(this.Module.HEAP8.buffer, this.actPtr, this.n * this.nu); }
+  get obs() { return new Float64Array(this.Module.HEAP8.buffer, this.obsPtr, this.n * this.obsDim); }
+  get finalObs() { return new Float64Array(this.Module.HEAP8.buffer, this.finalPtr, this.n * this.obsDim); }
+  get done() { return new Uint8Array(this.Module.HEAP8.buffer, this.donePtr, this.n); }
+  get stats() { return new Int32Array(this.Module.HEAP8.buffer, this.statsPtr, this.n * NSTAT); }
+
+  reset() {
+    this._reset(this.id, this.obsPtr);
+    return this.obs;
+  }
+
+  // Reads actions from this.actions; returns views over obs/done/stats.
+  step() {
+    this._step(this.id, this.actPtr, this.obsPtr, this.donePtr, this.statsPtr, this.finalPtr);
+    return { obs: this.obs, done: this.done, stats: this.stats, finalObs: this.finalObs };
+  }
+
+  dispose() {
+    this.Module.ccall('mjwf_vecenv_free', null, ['number'], [this.id]);
+    [this.actPtr, this.obsPtr, this.finalPtr, this.donePtr, this.statsPtr].forEach((p) => this.free(p));
+    this.id = 0;
+  }
+}
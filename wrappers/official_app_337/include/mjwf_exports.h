@@ -28,12 +28,29 @@ EMSCRIPTEN_KEEPALIVE const char* mjwf_errmsg_last_global(void);
 
 // ----- Handle and lifecycle -----
 EMSCRIPTEN_KEEPALIVE int  mjwf_make_from_xml(const char* path);
+// New handle sharing h's model arrays (own mjData, copy-on-write overlays).
+EMSCRIPTEN_KEEPALIVE int  mjwf_make_shared(int h);
 EMSCRIPTEN_KEEPALIVE void mjwf_free(int h);
 EMSCRIPTEN_KEEPALIVE int  mjwf_valid(int h);
 EMSCRIPTEN_KEEPALIVE int  mjwf_step(int h, int n);
 EMSCRIPTEN_KEEPALIVE int  mjwf_forward(int h);
 EMSCRIPTEN_KEEPALIVE int  mjwf_reset(int h);
 
+// ----- State slots (mjSTATE_FULLPHYSICS, MJWF_STATE_SLOTS per handle) -----
+EMSCRIPTEN_KEEPALIVE int  mjwf_state_size(int h);
+EMSCRIPTEN_KEEPALIVE int  mjwf_state_save(int h, int slot);
+EMSCRIPTEN_KEEPALIVE int  mjwf_state_restore(int h, int slot);
+
+// ----- Raw pointers (for the mjwf_mj_* aliases) -----
+struct mjModel_;
+struct mjData_;
+EMSCRIPTEN_KEEPALIVE struct mjModel_* mjwf_model_ptr(int h);
+EMSCRIPTEN_KEEPALIVE struct mjData_*  mjwf_data_ptr(int h);
+
+// ----- Worker threads for batched services (1 unless built with MJWF_THREADS) -----
+EMSCRIPTEN_KEEPALIVE int mjwf_set_threads(int n);
+EMSCRIPTEN_KEEPALIVE int mjwf_threads(void);
+
 // ----- Per-handle error -----
 EMSCRIPTEN_KEEPALIVE int         mjwf_errno_last(int h);
 EMSCRIPTEN_KEEPALIVE const char* mjwf_errmsg_last(int h);
@@ -78,6 +95,15 @@ EMSCRIPTEN_KEEPALIVE double*   mjwf_actuator_ctrlrange_ptr(int h);
 EMSCRIPTEN_KEEPALIVE double*   mjwf_contact_pos_ptr(int h);
 EMSCRIPTEN_KEEPALIVE double*   mjwf_contact_frame_ptr(int h);
 
+// ----- View table (ids follow spec order; see codegen/spec_337.yaml) -----
+EMSCRIPTEN_KEEPALIVE int         mjwf_view_count(void);
+EMSCRIPTEN_KEEPALIVE int         mjwf_view_id(const char* name);
+EMSCRIPTEN_KEEPALIVE const char* mjwf_view_name(int id);
+EMSCRIPTEN_KEEPALIVE int         mjwf_view_dtype(int id);     // 0=f64, 1=f32, 2=i32
+EMSCRIPTEN_KEEPALIVE int         mjwf_view_writable(int id);
+EMSCRIPTEN_KEEPALIVE int         mjwf_view_len(int h, int id);
+EMSCRIPTEN_KEEPALIVE const void* mjwf_view_addr(int h, int id); // read-only; never acquires an overlay
+
 // ----- Writers (rw views) -----
 EMSCRIPTEN_KEEPALIVE void mjwf_set_qpos(int h, const double* buf, int n);
 EMSCRIPTEN_KEEPALIVE void mjwf_set_qvel(int h, const double* buf, int n);
@@ -91,6 +117,294 @@ EMSCRIPTEN_KEEPALIVE int         mjwf_name2id(int h, int type, const char* name)
 EMSCRIPTEN_KEEPALIVE const char* mjwf_jnt_name_of(int h, int id);
 EMSCRIPTEN_KEEPALIVE const char* mjwf_actuator_name_of(int h, int id);
 
+// ----- Command buffer (many operations per call; layout in src/mjwf_cmdbuf.c) -----
+#define MJWF_CMDBUF_MAGIC   0x42434A4Du  // "MJCB"
+#define MJWF_REPLY_MAGIC    0x42524A4Du  // "MJRB"
+#define MJWF_CMDBUF_VERSION 1
+
+#define MJWF_CMD_SET_VIEW        1
+#define MJWF_CMD_STEP            2
+#define MJWF_CMD_FORWARD         3
+#define MJWF_CMD_RESET           4
+#define MJWF_CMD_SAVE_STATE      5
+#define MJWF_CMD_RESTORE_STATE   6
+#define MJWF_CMD_GATHER_VIEW     7
+#define MJWF_CMD_GATHER_CONTACTS 8
+
+// Per-record reply status
+#define MJWF_CMD_OK       0
+#define MJWF_CMD_E_HANDLE 1
+#define MJWF_CMD_E_OP     2
+#define MJWF_CMD_E_ARG    3
+#define MJWF_CMD_E_VIEW   4
+#define MJWF_CMD_E_RANGE  5
+#define MJWF_CMD_E_STATE  6
+#define MJWF_CMD_E_REPLY  7
+
+// Returns reply bytes written, or -1 for a malformed buffer (see mjwf_errmsg_last_global).
+EMSCRIPTEN_KEEPALIVE int mjwf_cmdbuf_exec(const void* cmd, int cmd_bytes, void* reply, int reply_cap);
+
+// ----- Batched finite-difference derivatives (layout in src/mjwf_derivs.c) -----
+#define MJWF_DERIV_CENTERED  1  // centered differences
+#define MJWF_DERIV_SENSORS   2  // transition: also emit C, D
+#define MJWF_DERIV_ACTUATION 4  // inverse: flg_actuation
+
+EMSCRIPTEN_KEEPALIVE int mjwf_transition_fd_stride(int h, int flags);
+EMSCRIPTEN_KEEPALIVE int mjwf_transition_fd_batch(int h, const double* states, int sig, const double* ctrls,
+                                                  int T, double eps, int flags, double* out);
+EMSCRIPTEN_KEEPALIVE int mjwf_inverse_fd_stride(int h);
+EMSCRIPTEN_KEEPALIVE int mjwf_inverse_fd_batch(int h, const double* states, int sig, const double* qaccs,
+                                               int T, double eps, int flags, double* out);
+
+// ----- Batched ray casting (semantics in src/mjwf_rays.c) -----
+// geomgroup: mjNGROUP bytes or NULL; bodyexclude: -1 for none; cutoff <= 0: unlimited.
+EMSCRIPTEN_KEEPALIVE int mjwf_ray_batch(int h, const double* pnt, const double* vec, int n,
+                                        const unsigned char* geomgroup, int flg_static, int bodyexclude,
+                                        double cutoff, double* dist, int* geomid);
+// Lidar pattern from a site/body frame (objtype mjOBJ_SITE or mjOBJ_BODY); output nel x naz.
+EMSCRIPTEN_KEEPALIVE int mjwf_ray_scan(int h, int objtype, int objid,
+                                       int naz, double az_min, double az_max,
+                                       int nel, double el_min, double el_max,
+                                       const unsigned char* geomgroup, int flg_static, int bodyexclude,
+                                       double cutoff, double* dist, int* geomid);
+
+// ----- Batched collision queries (semantics in src/mjwf_collide.c) -----
+// qpos is K x nq; colliding/ncon/mindist may be NULL. Returns the number of
+// colliding configurations, or -1 on error.
+EMSCRIPTEN_KEEPALIVE int mjwf_collision_batch(int h, const double* qpos, int K, double threshold,
+                                              unsigned char* colliding, int* ncon, double* mindist);
+
+// ----- Batched forward kinematics (layout in src/mjwf_fk.c) -----
+#define MJWF_FK_JACOBIAN 1  // append jacp | jacr (3 x nv each), runs mj_comPos
+#define MJWF_FK_QUAT     2  // orientation as quat 4 instead of mat 9
+
+// objs is nobj x 2 (mjOBJ_BODY or mjOBJ_SITE, id); out is K x nobj x mjwf_fk_stride(h, flags).
+EMSCRIPTEN_KEEPALIVE int mjwf_fk_stride(int h, int flags);
+EMSCRIPTEN_KEEPALIVE int mjwf_fk_batch(int h, const double* qpos, int K, const int* objs, int nobj,
+                                       int flags, double* out);
+
+// ----- Batched inverse dynamics (src/mjwf_inverse.c) -----
+// qpos T x nq, qvel/qacc T x nv in; qfrc_inverse and optional qfrc_constraint T x nv out.
+EMSCRIPTEN_KEEPALIVE int mjwf_inverse_batch(int h, const double* qpos, const double* qvel, const double* qacc,
+                                            int T, double* qfrc_inverse, double* qfrc_constraint);
+
+// ----- Batched rollouts (semantics in src/mjwf_rollout.c) -----
+// state0 in mj_getState(sig) layout, ctrls K x H x nu (or NULL), views = view ids
+// recorded after each step; out is K x H x mjwf_rollout_stride(h, views, nview).
+EMSCRIPTEN_KEEPALIVE int mjwf_rollout_stride(int h, const int* views, int nview);
+EMSCRIPTEN_KEEPALIVE int mjwf_rollout(int h, const double* state0, int sig, const double* ctrls,
+                                      int K, int H, const int* views, int nview, double* out);
+
+// ----- Vector environments (semantics in src/mjwf_vecenv.c) -----
+// Observation layouts come from codegen/spec_*.yaml (obs_layouts).
+EMSCRIPTEN_KEEPALIVE int mjwf_obs_layout_count(void);
+EMSCRIPTEN_KEEPALIVE int mjwf_obs_layout_id(const char* name);
+EMSCRIPTEN_KEEPALIVE int mjwf_obs_layout_dim(int h, int id);
+
+#define MJWF_DONE_TERMINATED 1  // done code: a predicate tripped
+#define MJWF_DONE_TRUNCATED  2  // done code: time limit
+#define MJWF_DONE_LT     0      // predicate ops: view[index] < value
+#define MJWF_DONE_GT     1      //                view[index] > value
+#define MJWF_DONE_ABS_GT 2      //                |view[index]| > value
+#define MJWF_VECENV_NSTAT 3     // stats per env: episodes, steps, last length
+
+// Returns a vector env id (> 0) over n copies of handle h's current state, or 0.
+EMSCRIPTEN_KEEPALIVE int  mjwf_vecenv_create(int h, int n, int layout);
+EMSCRIPTEN_KEEPALIVE void mjwf_vecenv_free(int e);
+EMSCRIPTEN_KEEPALIVE int  mjwf_vecenv_size(int e);
+EMSCRIPTEN_KEEPALIVE int  mjwf_vecenv_obs_dim(int e);
+EMSCRIPTEN_KEEPALIVE int  mjwf_vecenv_set_time_limit(int e, double seconds);
+EMSCRIPTEN_KEEPALIVE int  mjwf_vecenv_set_frame_skip(int e, int n);
+EMSCRIPTEN_KEEPALIVE int  mjwf_vecenv_set_noise(int e, double qpos_scale, double qvel_scale);
+EMSCRIPTEN_KEEPALIVE int  mjwf_vecenv_seed(int e, uint32_t seed);
+EMSCRIPTEN_KEEPALIVE int  mjwf_vecenv_add_done_if(int e, int view, int index, int op, double value);
+EMSCRIPTEN_KEEPALIVE int  mjwf_vecenv_clear_done_if(int e);
+EMSCRIPTEN_KEEPALIVE int  mjwf_vecenv_reset(int e, double* obs);
+// actions n x nu (or NULL); obs/final_obs n x obs_dim, done n bytes, stats n x MJWF_VECENV_NSTAT (each optional).
+EMSCRIPTEN_KEEPALIVE int  mjwf_vecenv_step(int e, const double* actions, double* obs, unsigned char* done,
+                                           int32_t* stats, double* final_obs);
+
+// ----- Model parameter overlays (semantics in src/mjwf_overlay.c) -----
+#define MJWF_SAMPLE_SCALE 0  // nominal * U(lo, hi)
+#define MJWF_SAMPLE_ADD   1  // nominal + U(lo, hi)
+#define MJWF_SAMPLE_SET   2  // U(lo, hi)
+
+EMSCRIPTEN_KEEPALIVE int mjwf_overlay_count(int h);
+// Drops the overlay of one view (view < 0: all), restoring nominal values.
+EMSCRIPTEN_KEEPALIVE int mjwf_overlay_reset(int h, int view);
+// Re-samples view[offset, offset + count) (count < 0: to the end) for nh handles.
+EMSCRIPTEN_KEEPALIVE int mjwf_overlay_sample(const int* handles, int nh, int view, int offset, int count,
+                                             int mode, double lo, double hi, uint32_t seed);
+EMSCRIPTEN_KEEPALIVE double mjwf_model_private_bytes(int h);
+EMSCRIPTEN_KEEPALIVE double mjwf_model_full_bytes(int h);
+
+// ----- Scene replication (semantics in src/mjwf_replicate.c) -----
+// One handle holding n non-colliding copies of the model at path, laid out on
+// a grid with the given spacing; returns the handle or -1 (global error).
+EMSCRIPTEN_KEEPALIVE int mjwf_make_replicated(const char* path, int n, double spacing);
+EMSCRIPTEN_KEEPALIVE int mjwf_replica_count(int h);  // 0 for ordinary handles
+// Env i owns view[offset + i * stride, offset + (i + 1) * stride).
+EMSCRIPTEN_KEEPALIVE int mjwf_replica_slice(int h, int view, int* offset, int* stride);
+// Copy owning a body or geom (mjOBJ_BODY / mjOBJ_GEOM), -1 for shared or invalid.
+EMSCRIPTEN_KEEPALIVE int mjwf_replica_env_of(int h, int objtype, int id);
+
+// ----- Wall-clock paced stepping (semantics in src/mjwf_pacing.c) -----
+#define MJWF_PACE_ADAPTIVE 1  // batch steps between clock reads, sized from the step-cost average
+#define MJWF_PACE_NSTAT    4  // stats: steps, lag (target - time, s), avg step cost (us), wall time used (us)
+
+// Steps until time reaches target_time or budget_us of wall time is spent;
+// returns steps taken, or -1 on error. stats may be NULL.
+EMSCRIPTEN_KEEPALIVE int    mjwf_step_for_budget(int h, double target_time, double budget_us, int flags,
+                                                 double* stats);
+EMSCRIPTEN_KEEPALIVE double mjwf_step_cost_us(int h);
+
+// ----- In-place model editing (semantics in src/mjwf_edit.c) -----
+// Like mjwf_make_from_xml, but keeps the mjSpec so the model can be edited.
+EMSCRIPTEN_KEEPALIVE int   mjwf_make_editable(const char* path);
+EMSCRIPTEN_KEEPALIVE void* mjwf_spec_ptr(int h);          // mjSpec* for the mjwf_mjs_* aliases
+EMSCRIPTEN_KEEPALIVE int   mjwf_model_generation(int h);  // changes when model/data move
+// Spec edits; NULL arguments leave the field unchanged. Applied by mjwf_recompile.
+EMSCRIPTEN_KEEPALIVE int mjwf_edit_body(int h, const char* name, const double* pos, const double* quat);
+EMSCRIPTEN_KEEPALIVE int mjwf_edit_geom(int h, const char* name, const double* pos, const double* quat,
+                                        const double* size);
+EMSCRIPTEN_KEEPALIVE int mjwf_edit_mesh(int h, const char* name, const char* file, const double* scale);
+// Attaches the model at path under body parent (NULL/"": world) at pos, names prefixed.
+EMSCRIPTEN_KEEPALIVE int mjwf_edit_attach(int h, const char* parent, const char* path, const char* prefix,
+                                          const double* pos);
+EMSCRIPTEN_KEEPALIVE int mjwf_edit_delete(int h, int objtype, const char* name);
+// mj_recompile in place, keeping qpos/qvel of surviving joints.
+EMSCRIPTEN_KEEPALIVE int mjwf_recompile(int h);
+
+// ----- Asset cache (semantics in src/mjwf_assets.c) -----
+// Indices into mjwf_asset_cache_stats output.
+#define MJWF_ASSET_STAT_ENTRIES         0
+#define MJWF_ASSET_STAT_BYTES           1
+#define MJWF_ASSET_STAT_HITS            2
+#define MJWF_ASSET_STAT_MISSES          3
+#define MJWF_ASSET_STAT_EVICTIONS       4
+#define MJWF_ASSET_STAT_BYTES_READ      5
+#define MJWF_ASSET_STAT_DUPLICATE_BYTES 6  // content also cached under another path
+#define MJWF_ASSET_NSTAT                7
+
+// name/path is the path MuJoCo resolves for the asset; all loads see the cache.
+EMSCRIPTEN_KEEPALIVE int  mjwf_asset_add_file(const char* path);
+EMSCRIPTEN_KEEPALIVE int  mjwf_asset_add_buffer(const char* name, const void* data, int nbytes);
+EMSCRIPTEN_KEEPALIVE int  mjwf_asset_remove(const char* name);
+EMSCRIPTEN_KEEPALIVE void mjwf_asset_cache_set_budget(double bytes);  // <= 0: unlimited
+EMSCRIPTEN_KEEPALIVE void mjwf_asset_cache_clear(void);
+EMSCRIPTEN_KEEPALIVE int  mjwf_asset_cache_stats(double* out);       // MJWF_ASSET_NSTAT doubles
+
+// ----- Render geometry manifest (semantics in src/mjwf_geometry.c) -----
+#define MJWF_GEOMETRY_VERSION     1
+#define MJWF_GEOMETRY_MESH_COLS   6  // vertadr vertnum faceadr facenum normaladr normalnum
+#define MJWF_GEOMETRY_HFIELD_COLS 3  // adr nrow ncol
+
+// Counts and array addresses; the tables follow at the given byte offsets.
+// Addresses are 64-bit so the layout is the same for every pointer width.
+typedef struct {
+  int32_t version;
+  int32_t nmesh, nhfield;
+  int32_t nmeshvert, nmeshnormal, nmeshface, nhfielddata;
+  int32_t mesh_table;    // byte offset of nmesh x MJWF_GEOMETRY_MESH_COLS int32
+  int32_t hfield_table;  // byte offset of nhfield x MJWF_GEOMETRY_HFIELD_COLS int32
+  int32_t reserved;
+  uint64_t mesh_vert, mesh_normal, mesh_face, mesh_facenormal;  // float/float/int/int
+  uint64_t hfield_data, hfield_size;                            // float/double
+} mjwf_geometry_header;
+
+EMSCRIPTEN_KEEPALIVE int mjwf_geometry_manifest_size(int h);  // bytes
+// Writes header + tables into out; returns bytes written, 0 if cap is too small.
+EMSCRIPTEN_KEEPALIVE int mjwf_geometry_manifest(int h, void* out, int cap);
+
+// ----- State snapshots (semantics in src/mjwf_snapshot.c) -----
+#define MJWF_SNAPSHOT_KEYFRAME   1  // encode: force a keyframe; also set in keyframe packets
+#define MJWF_SNAPSHOT_KINEMATICS 2  // apply: run mj_kinematics afterwards
+
+// Field set: nfield view ids, each quantized to quanta[i] (0 or quanta NULL:
+// lossless). Encoder and viewer handles must use the same set and model.
+// keyframe_every > 0 sends a keyframe every that many packets.
+EMSCRIPTEN_KEEPALIVE int mjwf_snapshot_config(int h, const int* views, const double* quanta, int nfield,
+                                              int keyframe_every);
+EMSCRIPTEN_KEEPALIVE int mjwf_snapshot_max_bytes(int h);  // buffer size for encode
+// Returns packet bytes written, 0 on error.
+EMSCRIPTEN_KEEPALIVE int mjwf_snapshot_encode(int h, int flags, unsigned char* out, int cap);
+EMSCRIPTEN_KEEPALIVE int mjwf_snapshot_apply(int h, const unsigned char* in, int n, int flags);
+
+// ----- Replay logs (semantics in src/mjwf_replay.c, format in src/mjwf_replay_log.h) -----
+// Indices into mjwf_replay_check output.
+#define MJWF_REPLAY_STEPS    0  // steps replayed
+#define MJWF_REPLAY_STEP     1  // first divergent step (1-based), 0 if none
+#define MJWF_REPLAY_COMP     2  // its first differing component (mjtState bit)
+#define MJWF_REPLAY_ELEMENT  3  // element within the component, -1 without a checkpoint
+#define MJWF_REPLAY_EXPECTED 4
+#define MJWF_REPLAY_ACTUAL   5
+#define MJWF_REPLAY_NRESULT  6
+
+// Records every mjwf_step / mjwf_step_for_budget step of h; checkpoint_every
+// > 0 also stores the full state every that many steps.
+EMSCRIPTEN_KEEPALIVE int mjwf_replay_record_start(int h, const char* path, int checkpoint_every);
+EMSCRIPTEN_KEEPALIVE int mjwf_replay_record_stop(int h);  // steps recorded, -1 if not recording
+// Replays the log on h (its state is overwritten): 1 all steps match, 0
+// diverged (see result), -1 bad log or different model. max_steps <= 0: all.
+EMSCRIPTEN_KEEPALIVE int mjwf_replay_check(int h, const char* path, double max_steps, double* result);
+EMSCRIPTEN_KEEPALIVE const char* mjwf_replay_comp_name(int comp);
+
+// ----- Sensor subsets (semantics in src/mjwf_sensors.c) -----
+// Selects sensors by name ("a,b,c"); returns the packed width in doubles, -1 on error.
+EMSCRIPTEN_KEEPALIVE int mjwf_sensor_select(int h, const char* names);
+// Packed offset of the k-th selected sensor (k = count: the width).
+EMSCRIPTEN_KEEPALIVE int mjwf_sensor_offset(int h, int k);
+// Packs the subset into out; returns doubles written, -1 on error.
+EMSCRIPTEN_KEEPALIVE int mjwf_sensor_gather(int h, double* out);
+// Steps n times, packing the subset after each step (n x width doubles).
+EMSCRIPTEN_KEEPALIVE int mjwf_step_gather(int h, int n, double* out);
+// Steps each of nh distinct handles nstep times (0: no step; handles run on
+// worker threads) and packs their subsets back to back; returns total doubles.
+EMSCRIPTEN_KEEPALIVE int mjwf_sensor_gather_batch(const int* handles, int nh, int nstep, double* out);
+
+// ----- Allocator and scratch arenas (semantics in src/mjwf_arena.c) -----
+// Indices into mjwf_heap_stats output; -1 where the build cannot tell.
+#define MJWF_HEAP_MEMORY 0  // linear memory size (never shrinks: also the peak)
+#define MJWF_HEAP_BRK    1  // sbrk(0), top of the allocator's heap
+#define MJWF_HEAP_IN_USE 2  // bytes in live allocations (mallinfo)
+#define MJWF_HEAP_FREE   3  // bytes the allocator holds free (mallinfo)
+#define MJWF_HEAP_ARENA  4  // bytes reserved by all handles' scratch arenas
+#define MJWF_HEAP_NSTAT  5
+
+EMSCRIPTEN_KEEPALIVE const char* mjwf_malloc_name(void);  // MJWF_MALLOC of the build, "system" natively
+EMSCRIPTEN_KEEPALIVE int mjwf_pointer_bytes(void);         // 8 in a MJWF_MEMORY64 bundle (pointers are BigInt in JS)
+EMSCRIPTEN_KEEPALIVE int mjwf_heap_stats(double* out);
+EMSCRIPTEN_KEEPALIVE double mjwf_arena_bytes(int h);
+
+// ----- Hibernation (semantics in src/mjwf_hibernate.c) -----
+// Indices into mjwf_resident_stats output.
+#define MJWF_RES_LIVE       0  // live handles
+#define MJWF_RES_AWAKE      1  // of which awake
+#define MJWF_RES_HIBERNATED 2  // of which hibernated
+#define MJWF_RES_DATA       3  // bytes: awake mjData, scratch data and arenas
+#define MJWF_RES_BLOB       4  // bytes: state blobs of hibernated handles
+#define MJWF_RES_SPARE      5  // bytes: parked mjData awaiting a wake
+#define MJWF_RES_BUDGET     6  // bytes, 0 when unset
+#define MJWF_RES_WAKES      7  // wakes since startup
+#define MJWF_RES_NSTAT      8
+
+EMSCRIPTEN_KEEPALIVE int mjwf_hibernate(int h);               // any later use of h wakes it
+EMSCRIPTEN_KEEPALIVE int mjwf_is_hibernated(int h);           // does not wake h
+EMSCRIPTEN_KEEPALIVE int mjwf_hibernate_budget(double bytes); // 0: none; trims, returns handles hibernated
+EMSCRIPTEN_KEEPALIVE int mjwf_hibernate_trim(void);
+EMSCRIPTEN_KEEPALIVE int mjwf_resident_stats(double* out);
+
+// ----- Async makes (semantics in src/mjwf_async.c) -----
+// mjwf_make_poll / mjwf_make_wait results.
+#define MJWF_MAKE_FAILED  -1  // message in mjwf_errmsg_last(h); mjwf_free(h) still needed
+#define MJWF_MAKE_PENDING  0
+#define MJWF_MAKE_READY    1
+
+EMSCRIPTEN_KEEPALIVE int mjwf_make_from_xml_async(const char* path);  // pending handle, or -1
+EMSCRIPTEN_KEEPALIVE int mjwf_make_poll(int h);
+EMSCRIPTEN_KEEPALIVE int mjwf_make_wait(int h);                       // blocks; not on a browser main thread
+EMSCRIPTEN_KEEPALIVE int mjwf_make_pending(void);                     // jobs still compiling
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,62 +1,383 @@
 // Minimal native harness to generate golden vectors for regression tests.
 // Loads an XML model, simulates fixed steps, and prints JSON with qpos[0], qvel[0].
+//
+// Golden files (read by tests/handles/golden.mjs):
+//   --golden <out_dir> [--steps N] [--threads T] [--fields qpos,qvel,act,sensordata]
+//            [--tol field=atol[,rtol]]... <model.xml>...
+//       simulates every model on a pool of threads with the replay ctrl
+//       pattern and writes one <index>_<name>.golden per model plus
+//       manifest.json (model dims, field layout and tolerances).
+//
+// Replay logs (format in src/mjwf_replay_log.h, shared with the WASM handle layer):
+//   --record <model.xml> <log> [steps] [checkpoint_every]
+//       simulates with a fixed sinusoidal ctrl pattern and writes a log;
+//   --replay <model.xml> <log>
+//       re-runs a log and prints the first divergent step/component as JSON
+//       (exit 0: identical, 1: diverged, 2: error).
+//
+// Golden file layout (little endian):
+//   char magic[8] "MJWFGOLD", i32 version, i32 steps, i32 nfield, i32 reserved,
+//   f64 timestep, i32 field id[nfield], i32 width[nfield],
+//   then per field a block of steps * width doubles: the value after each step.
 
 #include <mujoco/mujoco.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mjwf_replay_log.h"
 
 static void die(const char* msg) {
   std::fprintf(stderr, "%s\n", msg);
   std::exit(2);
 }
 
+static mjModel* try_load(const char* xmlpath, char* error, int nerror) {
+  error[0] = 0;
+  return mj_loadXML(xmlpath, nullptr, error, nerror);
+}
+
+static mjModel* load(const char* xmlpath) {
+  char error[1024];
+  mjModel* m = try_load(xmlpath, error, sizeof(error));
+  if (!m) {
+    std::fprintf(stderr, "loadXML failed: %s\n", error);
+    std::exit(2);
+  }
+  return m;
+}
+
+// Ctrl pattern shared by --record and --golden (and their WASM counterparts).
+// Changes every 10 steps so logs exercise both ctrl record kinds.
+static void drive_ctrl(const mjModel* m, mjData* d, int t) {
+  for (int i = 0; i < m->nu; ++i) d->ctrl[i] = std::sin(0.1 * (t / 10) + i);
+}
+
+static int record(const char* xmlpath, const char* logpath, int steps, int checkpoint_every) {
+  mjModel* m = load(xmlpath);
+  mjData* d = mj_makeData(m);
+  if (!d) die("makeData failed");
+  mjwf_rlog_writer w;
+  if (!mjwf_rlog_open(&w, logpath, m, d, checkpoint_every)) die("cannot write log");
+  for (int t = 0; t < steps; ++t) {
+    drive_ctrl(m, d, t);
+    mj_step(m, d);
+    if (!mjwf_rlog_step(&w, m, d)) die("log write failed");
+  }
+  mjwf_rlog_close(&w);
+  std::printf("{\"steps\": %d, \"mjversion\": \"%s\"}\n", steps, mj_versionString());
+  mj_deleteData(d);
+  mj_deleteModel(m);
+  return 0;
+}
+
+static int replay(const char* xmlpath, const char* logpath) {
+  mjModel* m = load(xmlpath);
+  mjData* d = mj_makeData(m);
+  if (!d) die("makeData failed");
+  mjwf_rlog_result r;
+  const int status = mjwf_rlog_replay(logpath, m, d, 0, &r);
+  if (status < 0) {
+    std::fprintf(stderr, "replay failed: %s\n", r.error);
+  } else {
+    std::printf("{\"match\": %s, \"steps\": %lld", status ? "true" : "false", r.steps);
+    if (!status) {
+      std::printf(", \"step\": %lld, \"field\": \"%s\", \"element\": %d", r.step,
+                  mjwf_rlog_comp_name(r.comp), r.element);
+      if (r.element >= 0) std::printf(", \"expected\": %.17g, \"actual\": %.17g", r.expected, r.actual);
+    }
+    std::printf("}\n");
+  }
+  mj_deleteData(d);
+  mj_deleteModel(m);
+  return status < 0 ? 2 : (status ? 0 : 1);
+}
+
+// ---------------------------------------------------------------------------
+// Golden files
+
+#define GOLDEN_VERSION 1
+
+// Field ids are part of the file format; append only.
+static const struct {
+  const char* name;
+  double atol, rtol;  // default tolerances, stored in the manifest
+} k_fields[] = {
+  {"time", 1e-12, 0},
+  {"qpos", 1e-8, 1e-6},
+  {"qvel", 1e-8, 1e-6},
+  {"act", 1e-8, 1e-6},
+  {"sensordata", 1e-6, 1e-5},
+  {"qacc", 1e-6, 1e-5},
+  {"ctrl", 0, 0},
+};
+static const int k_nfields = sizeof(k_fields) / sizeof(k_fields[0]);
+
+static int field_width(const mjModel* m, int f) {
+  switch (f) {
+    case 0: return 1;
+    case 1: return m->nq;
+    case 2: return m->nv;
+    case 3: return m->na;
+    case 4: return m->nsensordata;
+    case 5: return m->nv;
+    default: return m->nu;
+  }
+}
+
+static const mjtNum* field_data(const mjData* d, int f) {
+  switch (f) {
+    case 0: return &d->time;
+    case 1: return d->qpos;
+    case 2: return d->qvel;
+    case 3: return d->act;
+    case 4: return d->sensordata;
+    case 5: return d->qacc;
+    default: return d->ctrl;
+  }
+}
+
+struct GoldenJob {
+  std::string model, file;
+  int nq = 0, nv = 0, na = 0, nu = 0, nsensordata = 0;
+  double timestep = 0;
+  std::vector<int> width;
+  std::vector<long long> offset;
+  double ms = 0;
+  std::string error;
+};
+
+static void golden_one(GoldenJob* job, const std::filesystem::path& dir, int steps, const std::vector<int>& fields) {
+  const auto t0 = std::chrono::steady_clock::now();
+  char error[1024];
+  mjModel* m = try_load(job->model.c_str(), error, sizeof(error));
+  if (!m) {
+    job->error = std::string("loadXML failed: ") + error;
+    return;
+  }
+  mjData* d = mj_makeData(m);
+  if (!d) {
+    job->error = "makeData failed";
+    mj_deleteModel(m);
+    return;
+  }
+  job->nq = m->nq;
+  job->nv = m->nv;
+  job->na = m->na;
+  job->nu = m->nu;
+  job->nsensordata = m->nsensordata;
+  job->timestep = m->opt.timestep;
+
+  // Field-major blocks, so a reader can view each field as one array.
+  const int nfield = static_cast<int>(fields.size());
+  long long at = 32 + 8LL * nfield;
+  std::vector<std::vector<double>> block(nfield);
+  for (int k = 0; k < nfield; ++k) {
+    job->width.push_back(field_width(m, fields[k]));
+    job->offset.push_back(at);
+    at += 8LL * steps * job->width[k];
+    block[k].resize(static_cast<size_t>(steps) * job->width[k]);
+  }
+  for (int t = 0; t < steps; ++t) {
+    drive_ctrl(m, d, t);
+    mj_step(m, d);
+    for (int k = 0; k < nfield; ++k) {
+      const int w = job->width[k];
+      if (w) std::memcpy(&block[k][static_cast<size_t>(t) * w], field_data(d, fields[k]), sizeof(double) * w);
+    }
+  }
+  mj_deleteData(d);
+  mj_deleteModel(m);
+
+  FILE* f = std::fopen((dir / job->file).string().c_str(), "wb");
+  if (!f) {
+    job->error = "cannot write " + job->file;
+    return;
+  }
+  int32_t head[4] = {GOLDEN_VERSION, steps, nfield, 0};
+  std::vector<int32_t> layout(2 * nfield);
+  for (int k = 0; k < nfield; ++k) {
+    layout[k] = fields[k];
+    layout[nfield + k] = job->width[k];
+  }
+  bool ok = std::fwrite("MJWFGOLD", 1, 8, f) == 8 && std::fwrite(head, sizeof(head), 1, f) == 1 &&
+            std::fwrite(&job->timestep, sizeof(double), 1, f) == 1 &&
+            std::fwrite(layout.data(), sizeof(int32_t), layout.size(), f) == layout.size();
+  for (int k = 0; ok && k < nfield; ++k) {
+    ok = std::fwrite(block[k].data(), sizeof(double), block[k].size(), f) == block[k].size();
+  }
+  if (std::fclose(f) != 0 || !ok) job->error = "cannot write " + job->file;
+  job->ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static std::string json_str(const std::string& s) {
+  std::string out;
+  for (char c : s) {
+    if (c == '"' || c == '\\') out += '\\';
+    out += (c == '\n' || c == '\t') ? ' ' : c;
+  }
+  return out;
+}
+
+static int golden(int argc, char** argv) {
+  const char* usage =
+      "usage: --golden <out_dir> [--steps N] [--threads T] [--fields qpos,qvel,act,sensordata]\n"
+      "                [--tol field=atol[,rtol]]... <model.xml>...";
+  if (argc < 3) die(usage);
+  const std::filesystem::path dir(argv[2]);
+  int steps = 1000;
+  int threads = static_cast<int>(std::thread::hardware_concurrency());
+  std::vector<int> fields = {1, 2, 3, 4};
+  double atol[k_nfields], rtol[k_nfields];
+  for (int f = 0; f < k_nfields; ++f) {
+    atol[f] = k_fields[f].atol;
+    rtol[f] = k_fields[f].rtol;
+  }
+  auto field_id = [](const std::string& name) {
+    for (int f = 0; f < k_nfields; ++f) {
+      if (name == k_fields[f].name) return f;
+    }
+    std::fprintf(stderr, "unknown field: %s\n", name.c_str());
+    std::exit(2);
+  };
+
+  std::vector<GoldenJob> jobs;
+  for (int i = 3; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--steps" && i + 1 < argc) {
+      steps = std::atoi(argv[++i]);
+    } else if (arg == "--threads" && i + 1 < argc) {
+      threads = std::atoi(argv[++i]);
+    } else if (arg == "--fields" && i + 1 < argc) {
+      fields.clear();
+      std::string list = argv[++i];
+      for (size_t pos = 0; pos <= list.size();) {
+        const size_t end = std::min(list.find(',', pos), list.size());
+        fields.push_back(field_id(list.substr(pos, end - pos)));
+        pos = end + 1;
+      }
+    } else if (arg == "--tol" && i + 1 < argc) {
+      const std::string spec = argv[++i];
+      const size_t eq = spec.find('=');
+      if (eq == std::string::npos) die(usage);
+      const int f = field_id(spec.substr(0, eq));
+      char* rest = nullptr;
+      atol[f] = std::strtod(spec.c_str() + eq + 1, &rest);
+      rtol[f] = *rest == ',' ? std::strtod(rest + 1, nullptr) : 0;
+    } else {
+      GoldenJob job;
+      job.model = arg;
+      char name[32];
+      std::snprintf(name, sizeof(name), "%03d_", static_cast<int>(jobs.size()));
+      job.file = name + std::filesystem::path(arg).stem().string() + ".golden";
+      jobs.push_back(job);
+    }
+  }
+  if (jobs.empty() || steps <= 0) die(usage);
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+  if (ec) die("cannot create output directory");
+
+  // Models are independent: each worker takes the next one off the list.
+  const auto t0 = std::chrono::steady_clock::now();
+  std::atomic<int> next{0};
+  auto worker = [&]() {
+    for (int j; (j = next.fetch_add(1)) < static_cast<int>(jobs.size());) golden_one(&jobs[j], dir, steps, fields);
+  };
+  threads = std::max(1, std::min(threads, static_cast<int>(jobs.size())));
+  if (threads == 1) {
+    worker();
+  } else {
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) pool.emplace_back(worker);
+    for (auto& t : pool) t.join();
+  }
+  const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+  FILE* f = std::fopen((dir / "manifest.json").string().c_str(), "w");
+  if (!f) die("cannot write manifest.json");
+  std::fprintf(f, "{\n  \"version\": %d,\n  \"mjversion\": \"%s\",\n  \"steps\": %d,\n", GOLDEN_VERSION,
+               mj_versionString(), steps);
+  std::fprintf(f, "  \"ctrl\": \"sin(0.1*floor(t/10)+i)\",\n  \"models\": [");
+  int failed = 0;
+  for (size_t j = 0; j < jobs.size(); ++j) {
+    const GoldenJob& job = jobs[j];
+    std::fprintf(f, "%s\n    {\"model\": \"%s\", \"file\": \"%s\"", j ? "," : "", json_str(job.model).c_str(),
+                 job.file.c_str());
+    if (!job.error.empty()) {
+      std::fprintf(f, ", \"error\": \"%s\"}", json_str(job.error).c_str());
+      std::fprintf(stderr, "%s: %s\n", job.model.c_str(), job.error.c_str());
+      failed += 1;
+      continue;
+    }
+    std::fprintf(f, ", \"nq\": %d, \"nv\": %d, \"na\": %d, \"nu\": %d, \"nsensordata\": %d, \"timestep\": %.17g,"
+                    " \"ms\": %.1f,\n     \"fields\": [",
+                 job.nq, job.nv, job.na, job.nu, job.nsensordata, job.timestep, job.ms);
+    for (size_t k = 0; k < fields.size(); ++k) {
+      const int id = fields[k];
+      std::fprintf(f, "%s{\"name\": \"%s\", \"width\": %d, \"offset\": %lld, \"atol\": %g, \"rtol\": %g}",
+                   k ? ", " : "", k_fields[id].name, job.width[k], job.offset[k], atol[id], rtol[id]);
+    }
+    std::fprintf(f, "]}");
+  }
+  std::fprintf(f, "\n  ]\n}\n");
+  std::fclose(f);
+  std::printf("{\"models\": %zu, \"failed\": %d, \"steps\": %d, \"threads\": %d, \"ms\": %.1f}\n", jobs.size(),
+              failed, steps, threads, ms);
+  return failed ? 1 : 0;
+}
+
 int main(int argc, char** argv) {
+  if (argc > 1 && std::strcmp(argv[1], "--golden") == 0) return golden(argc, argv);
+  if (argc > 3 && std::strcmp(argv[1], "--record") == 0) {
+    const int steps = argc > 4 ? std::atoi(argv[4]) : 1000;
+    return record(argv[2], argv[3], steps > 0 ? steps : 1000, argc > 5 ? std::atoi(argv[5]) : 0);
+  }
+  if (argc > 3 && std::strcmp(argv[1], "--replay") == 0) return replay(argv[2], argv[3]);
+
   const char* xmlpath = argc > 1 ? argv[1] : nullptr;
   int steps = argc > 2 ? std::atoi(argv[2]) : 200;
   if (!xmlpath || steps <= 0) {
-    std::fprintf(stderr, "Usage: %s <model.xml> [steps]\n", argv[0]);
+    std::fprintf(stderr, "Usage: %s <model.xml> [steps]\n"
+                         "       %s --golden <out_dir> [options] <model.xml>...\n"
+                         "       %s --record <model.xml> <log> [steps] [checkpoint_every]\n"
+                         "       %s --replay <model.xml> <log>\n", argv[0], argv[0], argv[0], argv[0]);
     return 2;
   }
 
-  char error[1024] = {0};
-  mjModel* m = mj_loadXML(xmlpath, nullptr, error, sizeof(error));
-  if (!m) {
-    std::fprintf(stderr, "loadXML failed: %s\n", error);
-    return 2;
-  }
+  mjModel* m = load(xmlpath);
   mjData* d = mj_makeData(m);
   if (!d) die("makeData failed");
 
-  // JSON header
+  // simulate once, collecting both series
+  std::vector<double> qpos0(steps), qvel0(steps);
+  for (int i = 0; i < steps; ++i) {
+    mj_step(m, d);
+    qpos0[i] = m->nq > 0 ? d->qpos[0] : 0.0;
+    qvel0[i] = m->nv > 0 ? d->qvel[0] : 0.0;
+  }
+
   std::printf("{\n");
   std::printf("  \"nq\": %d,\n", m->nq);
   std::printf("  \"nv\": %d,\n", m->nv);
   std::printf("  \"qpos0\": [");
-
-  // simulate and collect
-  for (int i = 0; i < steps; ++i) {
-    mj_step(m, d);
-    // print qpos[0]
-    std::printf("%.*g", 17, m->nq > 0 ? d->qpos[0] : 0.0);
-    if (i + 1 < steps) std::printf(", ");
-  }
+  for (int i = 0; i < steps; ++i) std::printf("%.17g%s", qpos0[i], i + 1 < steps ? ", " : "");
   std::printf("],\n");
-
-  // qvel0 series
-  mj_resetData(m, d);
   std::printf("  \"qvel0\": [");
-  for (int i = 0; i < steps; ++i) {
-    mj_step(m, d);
-    std::printf("%.*g", 17, m->nv > 0 ? d->qvel[0] : 0.0);
-    if (i + 1 < steps) std::printf(", ");
-  }
+  for (int i = 0; i < steps; ++i) std::printf("%.17g%s", qvel0[i], i + 1 < steps ? ", " : "");
   std::printf("]\n");
-
   std::printf("}\n");
 
   mj_deleteData(d);
   mj_deleteModel(m);
   return 0;
 }
-
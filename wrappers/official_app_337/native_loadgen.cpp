@@ -0,0 +1,205 @@
+// Load generator for the native libmjwf: worker threads drive their own sets of
+// handles through a weighted create/step/read/free mix for a fixed time and
+// report throughput and latency percentiles per operation as one JSON line
+// (same keys as scripts/bench/loadgen.mjs, which runs the mix on mujoco.wasm).
+// Usage: mjwf_loadgen337 <model.xml> [threads] [seconds] [handles_per_thread]
+//                        [mix=create:1,step:40,read:20,free:1] [steps_per_op]
+//
+// create = mjwf_make_from_xml, step = random ctrl + mjwf_step, read = copy of
+// qpos/qvel/sensordata, free = mjwf_free. Each thread starts half full; a
+// create on a full set frees instead and a free on an empty set creates, so
+// the live population hovers around the configured size. Exits with 1 if any
+// call failed, so a short run doubles as a smoke test.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mjwf_exports.h"
+#include "mjwf_exports_generated.h"
+
+namespace {
+
+enum Op { kCreate, kStep, kRead, kFree, kNumOps };
+const char* const kOpNames[kNumOps] = {"create", "step", "read", "free"};
+
+using Clock = std::chrono::steady_clock;
+
+struct Config {
+  const char* xml = nullptr;
+  int threads = 4;
+  double seconds = 5;
+  int handles = 256;
+  int steps = 1;
+  int weight[kNumOps] = {1, 40, 20, 1};
+};
+
+struct ThreadStats {
+  std::vector<float> lat_us[kNumOps];
+  long long failures = 0;
+  int live = 0;
+};
+
+uint64_t next(uint64_t* s) {
+  uint64_t x = *s;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  return *s = x;
+}
+
+bool parse_mix(const char* mix, int* weight) {
+  std::string s(mix);
+  size_t pos = 0;
+  while (pos < s.size()) {
+    const size_t end = std::min(s.find(',', pos), s.size());
+    const std::string item = s.substr(pos, end - pos);
+    const size_t colon = item.find(':');
+    int op = -1;
+    for (int i = 0; i < kNumOps; ++i) {
+      if (colon != std::string::npos && item.compare(0, colon, kOpNames[i]) == 0) op = i;
+    }
+    if (op < 0) return false;
+    weight[op] = std::atoi(item.c_str() + colon + 1);
+    if (weight[op] < 0) return false;
+    pos = end + 1;
+  }
+  // The op pick is a draw modulo the total, walked through the weights.
+  int total = 0;
+  for (int i = 0; i < kNumOps; ++i) total += weight[i];
+  return total > 0;
+}
+
+void run(const Config& cfg, int tid, Clock::time_point deadline, std::atomic<int>* ready, ThreadStats* st) {
+  uint64_t rng = 0x9E3779B97F4A7C15ull * (tid + 1);
+  std::vector<int> live;
+  std::vector<double> sink;
+  for (int i = 0; i < cfg.handles / 2; ++i) {
+    const int h = mjwf_make_from_xml(cfg.xml);
+    if (h > 0) live.push_back(h);
+  }
+  ready->fetch_add(1);
+  while (ready->load() < cfg.threads) std::this_thread::yield();
+
+  int total = 0;
+  for (int w : cfg.weight) total += w;
+  while (Clock::now() < deadline) {
+    int pick = static_cast<int>(next(&rng) % static_cast<uint64_t>(total));
+    int op = 0;
+    while (pick >= cfg.weight[op]) pick -= cfg.weight[op++];
+    if (live.empty()) op = kCreate;
+    if (op == kCreate && static_cast<int>(live.size()) >= cfg.handles) op = kFree;
+    const size_t idx = live.empty() ? 0 : next(&rng) % live.size();
+
+    const auto t0 = Clock::now();
+    bool ok = true;
+    switch (op) {
+      case kCreate: {
+        const int h = mjwf_make_from_xml(cfg.xml);
+        ok = h > 0;
+        if (ok) live.push_back(h);
+        break;
+      }
+      case kStep: {
+        const int h = live[idx];
+        double* ctrl = mjwf_ctrl_ptr(h);
+        for (int i = 0, nu = mjwf_nu(h); i < nu; ++i) {
+          ctrl[i] = static_cast<double>(next(&rng) >> 11) * (2.0 / 9007199254740992.0) - 1.0;
+        }
+        ok = mjwf_step(h, cfg.steps) == 1;
+        break;
+      }
+      case kRead: {
+        const int h = live[idx];
+        const int nq = mjwf_nq(h), nv = mjwf_nv(h), ns = mjwf_nsensordata(h);
+        sink.resize(static_cast<size_t>(nq + nv + ns));
+        std::memcpy(sink.data(), mjwf_qpos_ptr(h), sizeof(double) * nq);
+        std::memcpy(sink.data() + nq, mjwf_qvel_ptr(h), sizeof(double) * nv);
+        if (ns) std::memcpy(sink.data() + nq + nv, mjwf_sensordata_ptr(h), sizeof(double) * ns);
+        break;
+      }
+      default:
+        mjwf_free(live[idx]);
+        live[idx] = live.back();
+        live.pop_back();
+        break;
+    }
+    const float us = std::chrono::duration<float, std::micro>(Clock::now() - t0).count();
+    if (ok) {
+      st->lat_us[op].push_back(us);
+    } else {
+      st->failures += 1;
+    }
+  }
+  st->live = static_cast<int>(live.size());
+  for (int h : live) mjwf_free(h);
+}
+
+double percentile(const std::vector<float>& sorted, double p) {
+  if (sorted.empty()) return 0;
+  const size_t i = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+  return sorted[i];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Config cfg;
+  cfg.xml = argc > 1 ? argv[1] : nullptr;
+  if (argc > 2) cfg.threads = std::atoi(argv[2]);
+  if (argc > 3) cfg.seconds = std::atof(argv[3]);
+  if (argc > 4) cfg.handles = std::atoi(argv[4]);
+  if (argc > 6) cfg.steps = std::atoi(argv[6]);
+  if (!cfg.xml || cfg.threads <= 0 || cfg.seconds <= 0 || cfg.handles <= 0 || cfg.steps <= 0 ||
+      (argc > 5 && !parse_mix(argv[5], cfg.weight))) {
+    std::fprintf(stderr,
+                 "Usage: %s <model.xml> [threads] [seconds] [handles_per_thread] "
+                 "[mix=create:1,step:40,read:20,free:1] [steps_per_op]\n",
+                 argv[0]);
+    return 2;
+  }
+  const int probe = mjwf_make_from_xml(cfg.xml);
+  if (probe <= 0) {
+    std::fprintf(stderr, "make_from_xml failed: %s\n", mjwf_errmsg_last_global());
+    return 2;
+  }
+  mjwf_free(probe);
+
+  std::vector<ThreadStats> stats(static_cast<size_t>(cfg.threads));
+  std::vector<std::thread> workers;
+  std::atomic<int> ready{0};
+  const auto deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                           std::chrono::duration<double>(cfg.seconds));
+  for (int t = 0; t < cfg.threads; ++t) workers.emplace_back(run, std::cref(cfg), t, deadline, &ready, &stats[t]);
+  for (auto& w : workers) w.join();
+
+  long long failures = 0;
+  int live = 0;
+  std::printf("{\"bench\":\"loadgen\",\"runtime\":\"native\",\"version\":\"%s\",\"threads\":%d,\"seconds\":%g,"
+              "\"handles_per_thread\":%d,\"steps_per_op\":%d",
+              mjwf_version_string(), cfg.threads, cfg.seconds, cfg.handles, cfg.steps);
+  long long steps = 0;
+  for (int op = 0; op < kNumOps; ++op) {
+    std::vector<float> all;
+    for (auto& st : stats) all.insert(all.end(), st.lat_us[op].begin(), st.lat_us[op].end());
+    std::sort(all.begin(), all.end());
+    if (op == kStep) steps = static_cast<long long>(all.size()) * cfg.steps;
+    std::printf(",\"%s\":{\"ops\":%zu,\"per_s\":%.0f,\"p50_us\":%.2f,\"p99_us\":%.2f,\"p999_us\":%.2f,\"max_us\":%.2f}",
+                kOpNames[op], all.size(), all.size() / cfg.seconds, percentile(all, 0.5), percentile(all, 0.99),
+                percentile(all, 0.999), all.empty() ? 0.0 : all.back());
+  }
+  for (auto& st : stats) {
+    failures += st.failures;
+    live += st.live;
+  }
+  std::printf(",\"steps_per_s\":%.0f,\"live_handles\":%d,\"failures\":%lld}\n", steps / cfg.seconds, live,
+              failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,207 @@
+// Asynchronous model compilation for MuJoCo WASM 3.3.7
+// mjwf_make_from_xml_async claims a handle and returns it at once; the load,
+// compile and mj_makeData of mjwf_make_from_xml run as a job on a detached
+// pthread (MJWF_THREADS: native builds or the pthread WASM build). The handle
+// stays pending until mjwf_make_poll (or mjwf_make_wait) on the caller's side
+// sees the job finished: it then installs the model and data, or routes the
+// compiler's message to the handle's mjwf_errmsg_last (codes 1/2, as for
+// mjwf_make_from_xml) and marks it failed. A pending or failed handle is not
+// valid for anything else; mjwf_free releases it in either state (a job still
+// running is abandoned and frees its results itself). Without MJWF_THREADS,
+// or when no thread can be started, the job runs inside the async call and
+// the first poll completes it.
+//
+// The job loads the file exactly as mjwf_make_from_xml does, through the asset
+// cache, which therefore refuses changes while jobs run (code 153). Keep the
+// XML file until the job completes. In the pthread WASM build the job's file
+// reads are proxied to the main thread, so a browser main thread should poll
+// from its frame loop rather than block in mjwf_make_wait.
+
+#include <mujoco/mujoco.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mjwf_exports.h"
+#include "mjwf_internal.h"
+
+#if defined(MJWF_THREADS)
+#include <pthread.h>
+#endif
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#else
+#ifndef EMSCRIPTEN_KEEPALIVE
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#endif
+
+// Parsing recurses through the XML tree: give jobs the main thread's stack
+// (-sSTACK_SIZE) rather than the small pthread default.
+#define MJWF_ASYNC_STACK (5 * 1024 * 1024)
+
+#if defined(MJWF_THREADS)
+static pthread_mutex_t g_async_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_async_done = PTHREAD_COND_INITIALIZER;
+#define MJWF_ASYNC_LOCK()   pthread_mutex_lock(&g_async_lock)
+#define MJWF_ASYNC_UNLOCK() pthread_mutex_unlock(&g_async_lock)
+#else
+#define MJWF_ASYNC_LOCK()   ((void)0)
+#define MJWF_ASYNC_UNLOCK() ((void)0)
+#endif
+
+typedef struct {
+  char* path;
+  mjModel* m;
+  mjData* d;
+  int code;             // error code when m is NULL
+  char error[1024];
+  int done;             // guarded by the lock, like abandoned
+  int abandoned;        // handle freed while compiling: the job frees itself
+} mjwf_make_job;
+
+static mjwf_make_job* g_job[MJWF_MAXH];  // touched by the caller's side only
+static int g_failed[MJWF_MAXH];
+static int g_running = 0;
+
+static void mjwf_job_free(mjwf_make_job* job) {
+  if (job->d) mj_deleteData(job->d);
+  if (job->m) mj_deleteModel(job->m);
+  free(job->path);
+  free(job);
+}
+
+static void mjwf_make_run(mjwf_make_job* job) {
+  mjModel* m = mj_loadXML(job->path, _mjwf_asset_vfs(), job->error, sizeof(job->error));
+  mjData* d = NULL;
+  if (!m) {
+    job->code = 1;
+    if (!job->error[0]) strcpy(job->error, "loadXML failed");
+  } else if (!(d = mj_makeData(m))) {
+    mj_deleteModel(m);
+    m = NULL;
+    job->code = 2;
+    strcpy(job->error, "mj_makeData failed");
+  }
+  MJWF_ASYNC_LOCK();
+  job->m = m;
+  job->d = d;
+  job->done = 1;
+  g_running -= 1;
+  const int abandoned = job->abandoned;
+#if defined(MJWF_THREADS)
+  pthread_cond_broadcast(&g_async_done);
+#endif
+  MJWF_ASYNC_UNLOCK();
+  if (abandoned) mjwf_job_free(job);
+}
+
+#if defined(MJWF_THREADS)
+static void* mjwf_make_thread(void* arg) {
+  mjwf_make_run((mjwf_make_job*)arg);
+  return NULL;
+}
+
+static int mjwf_make_spawn(mjwf_make_job* job) {
+  pthread_attr_t attr;
+  pthread_t tid;
+  if (pthread_attr_init(&attr) != 0) return 0;
+  pthread_attr_setstacksize(&attr, MJWF_ASYNC_STACK);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  const int ok = pthread_create(&tid, &attr, mjwf_make_thread, job) == 0;
+  pthread_attr_destroy(&attr);
+  return ok;
+}
+#endif
+
+int _mjwf_async_running(void) {
+  MJWF_ASYNC_LOCK();
+  const int n = g_running;
+  MJWF_ASYNC_UNLOCK();
+  return n;
+}
+
+void _mjwf_async_release(int h) {
+  if (h <= 0 || h >= MJWF_MAXH) return;
+  g_failed[h] = 0;
+  mjwf_make_job* job = g_job[h];
+  if (!job) return;
+  g_job[h] = NULL;
+  MJWF_ASYNC_LOCK();
+  const int done = job->done;
+  if (!done) job->abandoned = 1;
+  MJWF_ASYNC_UNLOCK();
+  if (done) mjwf_job_free(job);
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_make_from_xml_async(const char* path) {
+  if (!path) {
+    _mjwf_set_global_error(1, "make_from_xml_async: null path");
+    return -1;
+  }
+  const size_t len = strlen(path);
+  mjwf_make_job* job = (mjwf_make_job*)calloc(1, sizeof(mjwf_make_job));
+  char* copy = (char*)malloc(len + 1);
+  if (!job || !copy) {
+    free(job);
+    free(copy);
+    _mjwf_set_global_error(2, "make_from_xml_async: allocation failed");
+    return -1;
+  }
+  memcpy(copy, path, len + 1);
+  job->path = copy;
+  const int h = _mjwf_claim_handle();
+  if (h < 0) {
+    mjwf_job_free(job);
+    _mjwf_set_global_error(3, "no free handle");
+    return -1;
+  }
+  g_job[h] = job;
+  MJWF_ASYNC_LOCK();
+  g_running += 1;
+  MJWF_ASYNC_UNLOCK();
+#if defined(MJWF_THREADS)
+  if (mjwf_make_spawn(job)) return h;
+#endif
+  mjwf_make_run(job);
+  return h;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_make_poll(int h) {
+  if (h <= 0 || h >= MJWF_MAXH || g_failed[h]) return MJWF_MAKE_FAILED;
+  mjwf_make_job* job = g_job[h];
+  if (!job) return mjwf_valid(h) ? MJWF_MAKE_READY : MJWF_MAKE_FAILED;
+  MJWF_ASYNC_LOCK();
+  const int done = job->done;
+  MJWF_ASYNC_UNLOCK();
+  if (!done) return MJWF_MAKE_PENDING;
+  g_job[h] = NULL;
+  int status = MJWF_MAKE_READY;
+  if (job->m) {
+    _mjwf_install(h, job->m, job->d);
+    job->m = NULL;
+    job->d = NULL;
+  } else {
+    _mjwf_set_error(h, job->code, job->error);
+    g_failed[h] = 1;
+    status = MJWF_MAKE_FAILED;
+  }
+  mjwf_job_free(job);
+  return status;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_make_wait(int h) {
+  mjwf_make_job* job = (h > 0 && h < MJWF_MAXH) ? g_job[h] : NULL;
+  if (job) {
+    MJWF_ASYNC_LOCK();
+#if defined(MJWF_THREADS)
+    while (!job->done) pthread_cond_wait(&g_async_done, &g_async_lock);
+#endif
+    MJWF_ASYNC_UNLOCK();
+  }
+  return mjwf_make_poll(h);
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_make_pending(void) {
+  return _mjwf_async_running();
+}
@@ -7,6 +7,12 @@
 #include <stdlib.h>
 #include <stdint.h>
 
+#include "mjwf_internal.h"
+
+#if defined(MJWF_THREADS)
+#include <pthread.h>
+#endif
+
 #if defined(__EMSCRIPTEN__)
 #include <emscripten/emscripten.h>
 #else
@@ -15,18 +21,38 @@
 #endif
 #endif
 
-#define MJWF_MAXH 64
-
 typedef struct MjwfHandle {
   mjModel* m;
   mjData*  d;
   int      last_errno;
   char     last_errmsg[256];
+  mjtNum*  state_slot[MJWF_STATE_SLOTS];  // lazily sized to mj_stateSize(FULLPHYSICS)
+  mjData*  scratch[MJWF_MAXWORKERS];      // per-worker scratch for batched services
+  int      shared_from;                   // base handle when m is a shallow copy of its model
+  int      nshare;                        // live handles sharing this handle's model
+  mjSpec*  spec;                          // kept by mjwf_make_editable for in-place recompiles
+  int      generation;                    // bumped whenever m/d are reallocated in place
+  int      in_use;                        // claimed by mjwf_alloc_handle, cleared on free
 } MjwfHandle;
 
+// With MJWF_THREADS, handles may be created and freed from several threads
+// (e.g. native libmjwf servers): slot claims and share counts are taken under
+// a lock, and the global error is per thread. Calls on one handle still must
+// not overlap.
+#if defined(MJWF_THREADS)
+static pthread_mutex_t g_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+#define MJWF_POOL_LOCK()   pthread_mutex_lock(&g_pool_lock)
+#define MJWF_POOL_UNLOCK() pthread_mutex_unlock(&g_pool_lock)
+#define MJWF_TLS _Thread_local
+#else
+#define MJWF_POOL_LOCK()   ((void)0)
+#define MJWF_POOL_UNLOCK() ((void)0)
+#define MJWF_TLS
+#endif
+
 static MjwfHandle g_pool[MJWF_MAXH];
-static int       g_last_errno = 0;
-static char      g_last_errmsg[256] = {0};
+static MJWF_TLS int  g_last_errno = 0;
+static MJWF_TLS char g_last_errmsg[256] = {0};
 
 static void mjwf_set_global_error(int code, const char* msg) {
   g_last_errno = code;
@@ -52,32 +78,66 @@ static void mjwf_set_error(MjwfHandle* h, int code, const char* msg) {
   }
 }
 
+void _mjwf_set_error(int h, int code, const char* msg) {
+  if (h <= 0 || h >= MJWF_MAXH) { mjwf_set_global_error(code, msg); return; }
+  mjwf_set_error(&g_pool[h], code, msg);
+}
+
+void _mjwf_set_global_error(int code, const char* msg) {
+  mjwf_set_global_error(code, msg);
+}
+
 static int mjwf_alloc_handle(void) {
+  int h = -1;
+  MJWF_POOL_LOCK();
   for (int i = 1; i < MJWF_MAXH; ++i) { // start from 1 for nicer ids
-    if (g_pool[i].m == NULL && g_pool[i].d == NULL) {
+    if (!g_pool[i].in_use) {
+      g_pool[i].in_use = 1;
       g_pool[i].last_errno = 0;
       g_pool[i].last_errmsg[0] = '\0';
-      return i;
+      h = i;
+      break;
     }
   }
-  return -1;
+  MJWF_POOL_UNLOCK();
+  return h;
 }
 
 static void mjwf_free_slot(int h) {
   if (h <= 0 || h >= MJWF_MAXH) return;
+  for (int s = 0; s < MJWF_STATE_SLOTS; ++s) {
+    free(g_pool[h].state_slot[s]);
+    g_pool[h].state_slot[s] = NULL;
+  }
+  for (int w = 0; w < MJWF_MAXWORKERS; ++w) {
+    if (g_pool[h].scratch[w]) mj_deleteData(g_pool[h].scratch[w]);
+    g_pool[h].scratch[w] = NULL;
+  }
+  // Under the lock, so none of these stores can land after another thread's
+  // mjwf_alloc_handle has claimed the slot again.
+  MJWF_POOL_LOCK();
   g_pool[h].m = NULL;
   g_pool[h].d = NULL;
+  g_pool[h].shared_from = 0;
+  g_pool[h].nshare = 0;
+  g_pool[h].generation += 1;  // not reset: ids can be reused by a different model
   g_pool[h].last_errno = 0;
   g_pool[h].last_errmsg[0] = '\0';
+  g_pool[h].in_use = 0;
+  MJWF_POOL_UNLOCK();
 }
 
-EMSCRIPTEN_KEEPALIVE int mjwf_make_from_xml(const char* path) {
-  char error[1024] = {0};
-  mjModel* m = mj_loadXML(path, NULL, error, sizeof(error));
-  if (!m) {
-    mjwf_set_global_error(1, error[0] ? error : "loadXML failed");
-    return -1;
-  }
+int _mjwf_claim_handle(void) {
+  return mjwf_alloc_handle();
+}
+
+void _mjwf_install(int h, mjModel* m, mjData* d) {
+  if (h <= 0 || h >= MJWF_MAXH || !g_pool[h].in_use) return;
+  g_pool[h].m = m;
+  g_pool[h].d = d;
+}
+
+int _mjwf_make_from_model(mjModel* m) {
   mjData* d = mj_makeData(m);
   if (!d) {
     mj_deleteModel(m);
@@ -98,22 +158,192 @@ EMSCRIPTEN_KEEPALIVE int mjwf_make_from_xml(const char* path) {
   return h;
 }
 
+EMSCRIPTEN_KEEPALIVE int mjwf_make_from_xml(const char* path) {
+  char error[1024] = {0};
+  mjModel* m = mj_loadXML(path, _mjwf_asset_vfs(), error, sizeof(error));
+  if (!m) {
+    mjwf_set_global_error(1, error[0] ? error : "loadXML failed");
+    return -1;
+  }
+  return _mjwf_make_from_model(m);
+}
+
 EMSCRIPTEN_KEEPALIVE void mjwf_free(int h) {
   if (h <= 0 || h >= MJWF_MAXH) return;
+  if (g_pool[h].nshare > 0) {
+    mjwf_set_error(&g_pool[h], 4, "free: handle still has shared models");
+    return;
+  }
+  _mjwf_async_release(h);
+  _mjwf_hibernate_release(h);  // first: the hooks below must not wake h
+  _mjwf_overlay_release(h);
+  _mjwf_replica_release(h);
+  _mjwf_pace_release(h);
+  _mjwf_snapshot_release(h);
+  _mjwf_replay_release(h);
+  _mjwf_sensor_release(h);
+  _mjwf_arena_release(h);
+  if (g_pool[h].spec) { mj_deleteSpec(g_pool[h].spec); g_pool[h].spec = NULL; }
   if (g_pool[h].d) { mj_deleteData(g_pool[h].d); g_pool[h].d = NULL; }
-  if (g_pool[h].m) { mj_deleteModel(g_pool[h].m); g_pool[h].m = NULL; }
+  if (g_pool[h].m) {
+    const int root = g_pool[h].shared_from;
+    if (root) {
+      free(g_pool[h].m);
+      MJWF_POOL_LOCK();
+      g_pool[root].nshare -= 1;
+      MJWF_POOL_UNLOCK();
+    } else {
+      mj_deleteModel(g_pool[h].m);
+    }
+    g_pool[h].m = NULL;
+  }
   mjwf_free_slot(h);
 }
 
+// Every handle entry point goes through here, so this is also where the LRU
+// clock ticks and where a hibernated handle (m kept, d released) wakes.
 EMSCRIPTEN_KEEPALIVE int mjwf_valid(int h) {
-  return (h > 0 && h < MJWF_MAXH && g_pool[h].m && g_pool[h].d) ? 1 : 0;
+  if (h <= 0 || h >= MJWF_MAXH || !g_pool[h].m) return 0;
+  return _mjwf_hibernate_touch(h, g_pool[h].d != NULL);
+}
+
+// Shared handles: the new handle gets its own mjData (copied from the base's
+// current state) and a shallow mjModel struct whose arrays alias the base
+// model, so per-handle overlays (mjwf_overlay.c) and scalar options can differ
+// while the bulk of the model is stored once. Sharing a shared handle shares
+// its base. The base cannot be freed while shares are alive.
+EMSCRIPTEN_KEEPALIVE int mjwf_make_shared(int base) {
+  if (!mjwf_valid(base)) {
+    mjwf_set_global_error(5, "make_shared: invalid base handle");
+    return -1;
+  }
+  const int root = g_pool[base].shared_from ? g_pool[base].shared_from : base;
+  mjModel* m = (mjModel*)malloc(sizeof(mjModel));
+  if (!m) {
+    mjwf_set_global_error(2, "make_shared: allocation failed");
+    return -1;
+  }
+  *m = *g_pool[root].m;
+  _mjwf_overlay_strip(root, m);
+  mjData* d = mj_makeData(m);
+  if (!d) {
+    free(m);
+    mjwf_set_global_error(2, "mj_makeData failed");
+    return -1;
+  }
+  mj_copyData(d, m, g_pool[base].d);
+  int h = mjwf_alloc_handle();
+  if (h < 0) {
+    mj_deleteData(d);
+    free(m);
+    mjwf_set_global_error(3, "no free handle");
+    return -1;
+  }
+  g_pool[h].m = m;
+  g_pool[h].d = d;
+  g_pool[h].shared_from = root;
+  MJWF_POOL_LOCK();
+  g_pool[root].nshare += 1;
+  MJWF_POOL_UNLOCK();
+  return h;
+}
+
+int _mjwf_shared_base(int h) {
+  return mjwf_valid(h) ? g_pool[h].shared_from : 0;
+}
+
+// --- Hibernation (policy in mjwf_hibernate.c; none of these wake h) ---
+mjModel* _mjwf_model_peek(int h, int* root, int* generation) {
+  if (h <= 0 || h >= MJWF_MAXH || !g_pool[h].in_use || !g_pool[h].m) return NULL;
+  const int r = g_pool[h].shared_from ? g_pool[h].shared_from : h;
+  if (root) *root = r;
+  if (generation) *generation = g_pool[r].generation;
+  return g_pool[h].m;
+}
+
+double _mjwf_mjdata_bytes(const mjData* d) {
+  return d ? (double)(sizeof(mjData) + d->nbuffer + d->narena) : 0;
+}
+
+double _mjwf_data_bytes(int h) {
+  if (h <= 0 || h >= MJWF_MAXH || !g_pool[h].d) return 0;
+  double bytes = _mjwf_mjdata_bytes(g_pool[h].d);
+  for (int w = 0; w < MJWF_MAXWORKERS; ++w) bytes += _mjwf_mjdata_bytes(g_pool[h].scratch[w]);
+  return bytes;
+}
+
+mjData* _mjwf_data_detach(int h) {
+  if (h <= 0 || h >= MJWF_MAXH) return NULL;
+  MjwfHandle* H = &g_pool[h];
+  for (int w = 0; w < MJWF_MAXWORKERS; ++w) {
+    if (H->scratch[w]) mj_deleteData(H->scratch[w]);
+    H->scratch[w] = NULL;
+  }
+  mjData* d = H->d;
+  H->d = NULL;
+  return d;
+}
+
+void _mjwf_data_attach(int h, mjData* d) {
+  if (h > 0 && h < MJWF_MAXH) g_pool[h].d = d;
+}
+
+// --- Editable handles (spec kept alive, see mjwf_edit.c) ---
+EMSCRIPTEN_KEEPALIVE int mjwf_make_editable(const char* path) {
+  char error[1024] = {0};
+  mjSpec* spec = mj_parseXML(path, _mjwf_asset_vfs(), error, sizeof(error));
+  if (!spec) {
+    mjwf_set_global_error(1, error[0] ? error : "parseXML failed");
+    return -1;
+  }
+  mjModel* m = mj_compile(spec, _mjwf_asset_vfs());
+  if (!m) {
+    mjwf_set_global_error(1, mjs_getError(spec));
+    mj_deleteSpec(spec);
+    return -1;
+  }
+  const int h = _mjwf_make_from_model(m);
+  if (h < 0) {
+    mj_deleteSpec(spec);
+    return -1;
+  }
+  g_pool[h].spec = spec;
+  return h;
+}
+
+mjSpec* _mjwf_spec_of(int h) {
+  return mjwf_valid(h) ? g_pool[h].spec : NULL;
+}
+
+int _mjwf_share_count(int h) {
+  return mjwf_valid(h) ? g_pool[h].nshare : 0;
+}
+
+int _mjwf_model_generation(int h) {
+  return mjwf_valid(h) ? g_pool[h].generation : -1;
+}
+
+void _mjwf_model_changed(int h) {
+  if (!mjwf_valid(h)) return;
+  MjwfHandle* H = &g_pool[h];
+  for (int s = 0; s < MJWF_STATE_SLOTS; ++s) {
+    free(H->state_slot[s]);
+    H->state_slot[s] = NULL;
+  }
+  for (int w = 0; w < MJWF_MAXWORKERS; ++w) {
+    if (H->scratch[w]) mj_deleteData(H->scratch[w]);
+    H->scratch[w] = NULL;
+  }
+  H->generation += 1;
 }
 
 EMSCRIPTEN_KEEPALIVE int mjwf_step(int h, int n) {
   if (!mjwf_valid(h) || n <= 0) return 0;
   MjwfHandle* H = &g_pool[h];
+  const int record = _mjwf_replay_recording(h);
   for (int i = 0; i < n; ++i) {
     mj_step(H->m, H->d);
+    if (record) _mjwf_replay_record(h);
   }
   return 1;
 }
@@ -132,13 +362,50 @@ EMSCRIPTEN_KEEPALIVE int mjwf_reset(int h) {
   return 1;
 }
 
-EMSCRIPTEN_KEEPALIVE int mjwf_errno_last(int h) {
+// --- State slots (mj_getState/mj_setState, full physics) ---
+EMSCRIPTEN_KEEPALIVE int mjwf_state_size(int h) {
+  if (!mjwf_valid(h)) return 0;
+  return mj_stateSize(g_pool[h].m, mjSTATE_FULLPHYSICS);
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_state_save(int h, int slot) {
+  if (!mjwf_valid(h)) return 0;
+  MjwfHandle* H = &g_pool[h];
+  if (slot < 0 || slot >= MJWF_STATE_SLOTS) {
+    mjwf_set_error(H, 10, "state slot out of range");
+    return 0;
+  }
+  if (!H->state_slot[slot]) {
+    H->state_slot[slot] = (mjtNum*)malloc(sizeof(mjtNum) * mj_stateSize(H->m, mjSTATE_FULLPHYSICS));
+    if (!H->state_slot[slot]) {
+      mjwf_set_error(H, 11, "state slot allocation failed");
+      return 0;
+    }
+  }
+  mj_getState(H->m, H->d, H->state_slot[slot], mjSTATE_FULLPHYSICS);
+  return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_state_restore(int h, int slot) {
   if (!mjwf_valid(h)) return 0;
+  MjwfHandle* H = &g_pool[h];
+  if (slot < 0 || slot >= MJWF_STATE_SLOTS || !H->state_slot[slot]) {
+    mjwf_set_error(H, 12, "state slot empty");
+    return 0;
+  }
+  mj_setState(H->m, H->d, H->state_slot[slot], mjSTATE_FULLPHYSICS);
+  return 1;
+}
+
+// Also readable on claimed handles without a model (failed async makes), and
+// without waking hibernated ones.
+EMSCRIPTEN_KEEPALIVE int mjwf_errno_last(int h) {
+  if (h <= 0 || h >= MJWF_MAXH || !g_pool[h].in_use) return 0;
   return g_pool[h].last_errno;
 }
 
 EMSCRIPTEN_KEEPALIVE const char* mjwf_errmsg_last(int h) {
-  if (!mjwf_valid(h)) return "";
+  if (h <= 0 || h >= MJWF_MAXH || !g_pool[h].in_use) return "";
   return g_pool[h].last_errmsg;
 }
 
@@ -199,9 +466,39 @@ mjData* _mjwf_data_of(int h) {
   return g_pool[h].d;
 }
 
+// Raw pointers for mixing handles with the mjwf_mj_* aliases.
+EMSCRIPTEN_KEEPALIVE mjModel* mjwf_model_ptr(int h) { return _mjwf_model_of(h); }
+EMSCRIPTEN_KEEPALIVE mjData*  mjwf_data_ptr(int h) { return _mjwf_data_of(h); }
+
+// --- Scratch data (batched services) ---
+// Scratch mjData is created on the calling thread before fanning out, then
+// reused across calls; each worker only touches its own index.
+int _mjwf_scratch_reserve(int h, int nworker) {
+  if (!mjwf_valid(h)) return 0;
+  MjwfHandle* H = &g_pool[h];
+  if (nworker > MJWF_MAXWORKERS) nworker = MJWF_MAXWORKERS;
+  for (int w = 0; w < nworker; ++w) {
+    if (!H->scratch[w]) {
+      H->scratch[w] = mj_makeData(H->m);
+      if (!H->scratch[w]) {
+        mjwf_set_error(H, 40, "scratch mj_makeData failed");
+        return 0;
+      }
+    }
+    mj_copyData(H->scratch[w], H->m, H->d);
+  }
+  return 1;
+}
+
+mjData* _mjwf_scratch_of(int h, int worker) {
+  if (!mjwf_valid(h) || worker < 0 || worker >= MJWF_MAXWORKERS) return NULL;
+  return g_pool[h].scratch[worker];
+}
+
 // --- Contacts (on-demand scratch views) ---
 // Expose compact views for contact positions (ncon*3) and frames (ncon*9).
-// Buffers are lazily sized to m->nconmax and reused across calls.
+// Buffers are per-handle arena slots, lazily sized to m->nconmax and reused
+// across calls.
 EMSCRIPTEN_KEEPALIVE int mjwf_ncon(int h) {
   if (!mjwf_valid(h)) return 0;
   return g_pool[h].d ? (int)(g_pool[h].d->ncon) : 0;
@@ -210,9 +507,9 @@ EMSCRIPTEN_KEEPALIVE int mjwf_ncon(int h) {
 EMSCRIPTEN_KEEPALIVE double* mjwf_contact_pos_ptr(int h) {
   if (!mjwf_valid(h)) return NULL;
   mjModel* m = g_pool[h].m; mjData* d = g_pool[h].d;
-  static double* buf = NULL; static int cap = 0; // capacity in doubles
   const int need = (int)(m->nconmax) * 3;
-  if (cap < need) { if (buf) free(buf); buf = (double*)malloc(sizeof(double) * need); cap = need; }
+  double* buf = (double*)_mjwf_arena_buffer(h, MJWF_BUF_CONTACT_POS, sizeof(double) * (size_t)need);
+  if (!buf) return NULL;
   const int n = (int)(d->ncon);
   for (int i = 0; i < n; ++i) {
     const mjContact* c = &d->contact[i];
@@ -229,9 +526,9 @@ EMSCRIPTEN_KEEPALIVE double* mjwf_contact_pos_ptr(int h) {
 EMSCRIPTEN_KEEPALIVE double* mjwf_contact_frame_ptr(int h) {
   if (!mjwf_valid(h)) return NULL;
   mjModel* m = g_pool[h].m; mjData* d = g_pool[h].d;
-  static double* buf = NULL; static int cap = 0; // capacity in doubles
   const int need = (int)(m->nconmax) * 9;
-  if (cap < need) { if (buf) free(buf); buf = (double*)malloc(sizeof(double) * need); cap = need; }
+  double* buf = (double*)_mjwf_arena_buffer(h, MJWF_BUF_CONTACT_FRAME, sizeof(double) * (size_t)need);
+  if (!buf) return NULL;
   const int n = (int)(d->ncon);
   for (int i = 0; i < n; ++i) {
     const mjContact* c = &d->contact[i];
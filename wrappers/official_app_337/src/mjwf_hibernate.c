@@ -0,0 +1,276 @@
+// Hibernation of idle handles for MuJoCo WASM 3.3.7
+// mjwf_hibernate captures a handle's integration state (mj_getState with
+// mjSTATE_INTEGRATION: full physics plus controls, applied forces, mocap,
+// equality flags, userdata and warmstart) into a compact blob and releases its
+// mjData, scratch data and scratch arena; the model stays. The next use of
+// the handle through any entry point (mjwf_valid) wakes it: the mjData comes
+// from the spare pool when a compatible one is parked there, otherwise from
+// mj_makeData, the state is restored and mj_forward recomputes the derived
+// quantities. Stepping continues exactly as if the handle had never slept, but
+// views read after a wake are post-forward values (sensordata of the current
+// state, not of the state before the last step), and the mjData has moved:
+// re-fetch mjwf_*_ptr pointers after hibernating.
+//
+// With a budget set, mjwf_hibernate_trim hibernates the least recently used
+// handles until resident handle memory (awake mjData, their scratch data and
+// arenas, plus the spare pool) fits. Wakes never evict: the resident set may
+// exceed the budget until the next trim, so a server trims between requests.
+// Under the budget, hibernated mjData are parked (up to MJWF_HIB_SPARES) for
+// the next wake of a handle of the same model instead of being freed. Trim
+// hibernates other handles, so with MJWF_THREADS it must not overlap calls on
+// other handles; waking from worker threads is fine.
+
+#include <mujoco/mujoco.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mjwf_exports.h"
+#include "mjwf_internal.h"
+
+#if defined(MJWF_THREADS)
+#include <pthread.h>
+#endif
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#else
+#ifndef EMSCRIPTEN_KEEPALIVE
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#endif
+
+#define MJWF_HIB_STATE  mjSTATE_INTEGRATION
+#define MJWF_HIB_SPARES 8
+
+// Batched services validate their handle from worker threads, so the LRU
+// clock and the spare pool are shared between threads.
+#if defined(MJWF_THREADS)
+static pthread_mutex_t g_spare_lock = PTHREAD_MUTEX_INITIALIZER;
+#define MJWF_SPARE_LOCK()   pthread_mutex_lock(&g_spare_lock)
+#define MJWF_SPARE_UNLOCK() pthread_mutex_unlock(&g_spare_lock)
+#define MJWF_CLOCK_ADD(x, n)   __atomic_add_fetch(&(x), (n), __ATOMIC_RELAXED)
+#define MJWF_CLOCK_STORE(x, v) __atomic_store_n(&(x), (v), __ATOMIC_RELAXED)
+#else
+#define MJWF_SPARE_LOCK()   ((void)0)
+#define MJWF_SPARE_UNLOCK() ((void)0)
+#define MJWF_CLOCK_ADD(x, n)   ((x) += (n))
+#define MJWF_CLOCK_STORE(x, v) ((x) = (v))
+#endif
+
+typedef struct {
+  mjtNum* blob;               // non-NULL while hibernated
+  int nblob;
+  unsigned long long tick;    // LRU clock at the last mjwf_valid
+} mjwf_sleeper;
+
+typedef struct {
+  int root;                   // share root and its generation when parked
+  int generation;
+  mjData* d;
+  double bytes;
+} mjwf_spare;
+
+static mjwf_sleeper g_sleep[MJWF_MAXH];
+static mjwf_spare g_spare[MJWF_HIB_SPARES];  // oldest first
+static int g_nspare = 0;
+static double g_spare_bytes = 0;
+static double g_budget = 0;                  // 0: no budget
+static unsigned long long g_clock = 0;
+static unsigned long long g_nwake = 0;
+
+static void mjwf_spare_drop(int i) {
+  mj_deleteData(g_spare[i].d);
+  g_spare_bytes -= g_spare[i].bytes;
+  memmove(&g_spare[i], &g_spare[i + 1], (size_t)(g_nspare - i - 1) * sizeof(mjwf_spare));
+  g_nspare -= 1;
+}
+
+// Caller holds the spare lock. Drops spares whose model was freed or recompiled.
+static void mjwf_spare_prune(void) {
+  for (int i = g_nspare - 1; i >= 0; --i) {
+    int generation = -1;
+    if (!_mjwf_model_peek(g_spare[i].root, NULL, &generation) || generation != g_spare[i].generation) {
+      mjwf_spare_drop(i);
+    }
+  }
+}
+
+static mjData* mjwf_spare_take(int root, int generation) {
+  mjData* d = NULL;
+  MJWF_SPARE_LOCK();
+  mjwf_spare_prune();
+  for (int i = g_nspare - 1; i >= 0 && !d; --i) {
+    if (g_spare[i].root == root && g_spare[i].generation == generation) {
+      d = g_spare[i].d;
+      g_spare_bytes -= g_spare[i].bytes;
+      memmove(&g_spare[i], &g_spare[i + 1], (size_t)(g_nspare - i - 1) * sizeof(mjwf_spare));
+      g_nspare -= 1;
+    }
+  }
+  MJWF_SPARE_UNLOCK();
+  return d;
+}
+
+// Parks d, pushing out the oldest spare when the pool is full.
+static void mjwf_spare_put(int root, int generation, mjData* d) {
+  MJWF_SPARE_LOCK();
+  if (g_nspare == MJWF_HIB_SPARES) mjwf_spare_drop(0);
+  g_spare[g_nspare] = (mjwf_spare){root, generation, d, _mjwf_mjdata_bytes(d)};
+  g_spare_bytes += g_spare[g_nspare].bytes;
+  g_nspare += 1;
+  MJWF_SPARE_UNLOCK();
+}
+
+// Awake handle memory plus the spare pool.
+static double mjwf_resident_bytes(void) {
+  double bytes = g_spare_bytes;
+  for (int h = 1; h < MJWF_MAXH; ++h) {
+    if (!g_sleep[h].blob) bytes += _mjwf_data_bytes(h) + mjwf_arena_bytes(h);
+  }
+  return bytes;
+}
+
+// park: offer the released mjData to the spare pool.
+static int mjwf_hibernate_one(int h, int park) {
+  mjwf_sleeper* s = &g_sleep[h];
+  int root = 0, generation = 0;
+  mjModel* m = _mjwf_model_peek(h, &root, &generation);
+  if (!m) return 0;
+  if (s->blob) return 1;
+  const int n = mj_stateSize(m, MJWF_HIB_STATE);
+  mjtNum* blob = (mjtNum*)malloc(sizeof(mjtNum) * (size_t)(n > 0 ? n : 1));
+  if (!blob) {
+    _mjwf_set_error(h, 200, "hibernate: state blob allocation failed");
+    return 0;
+  }
+  mjData* d = _mjwf_data_detach(h);
+  if (!d) {
+    free(blob);
+    return 0;
+  }
+  mj_getState(m, d, blob, MJWF_HIB_STATE);
+  _mjwf_arena_release(h);
+  s->blob = blob;
+  s->nblob = n;
+  if (park) {
+    mjwf_spare_put(root, generation, d);
+  } else {
+    mj_deleteData(d);
+  }
+  return 1;
+}
+
+static int mjwf_wake(int h) {
+  mjwf_sleeper* s = &g_sleep[h];
+  int root = 0, generation = 0;
+  mjModel* m = _mjwf_model_peek(h, &root, &generation);
+  if (!m || !s->blob) return 0;
+  mjData* d = mjwf_spare_take(root, generation);
+  if (d) {
+    mj_resetData(m, d);
+  } else {
+    d = mj_makeData(m);
+  }
+  if (!d) {
+    _mjwf_set_error(h, 201, "hibernate: wake failed (mj_makeData)");
+    return 0;
+  }
+  mj_setState(m, d, s->blob, MJWF_HIB_STATE);
+  mj_forward(m, d);
+  _mjwf_data_attach(h, d);
+  free(s->blob);
+  s->blob = NULL;
+  s->nblob = 0;
+  MJWF_CLOCK_ADD(g_nwake, 1);
+  return 1;
+}
+
+int _mjwf_hibernate_touch(int h, int awake) {
+  MJWF_CLOCK_STORE(g_sleep[h].tick, MJWF_CLOCK_ADD(g_clock, 1));
+  return awake ? 1 : mjwf_wake(h);
+}
+
+void _mjwf_hibernate_release(int h) {
+  if (h <= 0 || h >= MJWF_MAXH) return;
+  free(g_sleep[h].blob);
+  g_sleep[h] = (mjwf_sleeper){0};
+  MJWF_SPARE_LOCK();
+  for (int i = g_nspare - 1; i >= 0; --i) {
+    if (g_spare[i].root == h) mjwf_spare_drop(i);
+  }
+  MJWF_SPARE_UNLOCK();
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_hibernate(int h) {
+  if (!_mjwf_model_peek(h, NULL, NULL)) return 0;
+  if (g_sleep[h].blob) return 1;
+  // Under the budget the mjData stays resident as a spare, which moves it
+  // between accounts without changing the total.
+  const int park = g_budget > 0 && mjwf_resident_bytes() <= g_budget;
+  return mjwf_hibernate_one(h, park);
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_is_hibernated(int h) {
+  return (_mjwf_model_peek(h, NULL, NULL) && g_sleep[h].blob) ? 1 : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_hibernate_trim(void) {
+  if (g_budget <= 0) return 0;
+  MJWF_SPARE_LOCK();
+  mjwf_spare_prune();
+  MJWF_SPARE_UNLOCK();
+  double resident = mjwf_resident_bytes();
+  int n = 0;
+  while (resident > g_budget) {
+    MJWF_SPARE_LOCK();
+    const int nspare = g_nspare;
+    if (nspare) {
+      resident -= g_spare[0].bytes;
+      mjwf_spare_drop(0);
+    }
+    MJWF_SPARE_UNLOCK();
+    if (nspare) continue;
+    int lru = 0;
+    for (int h = 1; h < MJWF_MAXH; ++h) {
+      if (g_sleep[h].blob || !_mjwf_data_bytes(h)) continue;
+      if (!lru || g_sleep[h].tick < g_sleep[lru].tick) lru = h;
+    }
+    if (!lru) break;
+    const double bytes = _mjwf_data_bytes(lru) + mjwf_arena_bytes(lru);
+    if (!mjwf_hibernate_one(lru, 0)) break;
+    resident -= bytes;
+    n += 1;
+  }
+  return n;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_hibernate_budget(double bytes) {
+  if (!(bytes >= 0)) {
+    _mjwf_set_global_error(202, "hibernate_budget: bytes must be >= 0");
+    return -1;
+  }
+  g_budget = bytes;
+  return mjwf_hibernate_trim();
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_resident_stats(double* out) {
+  if (!out) return 0;
+  double live = 0, asleep = 0, blob = 0;
+  for (int h = 1; h < MJWF_MAXH; ++h) {
+    if (!_mjwf_model_peek(h, NULL, NULL)) continue;
+    live += 1;
+    if (g_sleep[h].blob) {
+      asleep += 1;
+      blob += (double)g_sleep[h].nblob * sizeof(mjtNum);
+    }
+  }
+  out[MJWF_RES_LIVE] = live;
+  out[MJWF_RES_AWAKE] = live - asleep;
+  out[MJWF_RES_HIBERNATED] = asleep;
+  out[MJWF_RES_DATA] = mjwf_resident_bytes() - g_spare_bytes;
+  out[MJWF_RES_BLOB] = blob;
+  out[MJWF_RES_SPARE] = g_spare_bytes;
+  out[MJWF_RES_BUDGET] = g_budget;
+  out[MJWF_RES_WAKES] = (double)g_nwake;
+  return 1;
+}
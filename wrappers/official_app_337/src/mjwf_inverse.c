@@ -0,0 +1,71 @@
+// Batched inverse dynamics for MuJoCo WASM 3.3.7
+// Runs mj_inverse for every frame of a (qpos, qvel, qacc) trajectory on
+// per-worker scratch mjData synced from the handle once per call, so model
+// state not covered by the trajectory (mocap, act, ...) comes from the handle.
+//
+// Inputs are row-major: qpos T x nq, qvel T x nv, qacc T x nv.
+// Outputs: qfrc_inverse T x nv, and optionally qfrc_constraint T x nv (the
+// joint-space constraint force of each frame; NULL to skip).
+
+#include <mujoco/mujoco.h>
+#include <string.h>
+
+#include "mjwf_exports.h"
+#include "mjwf_internal.h"
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#else
+#ifndef EMSCRIPTEN_KEEPALIVE
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#endif
+
+typedef struct {
+  int h;
+  const mjModel* m;
+  const double* qpos;
+  const double* qvel;
+  const double* qacc;
+  double* qfrc_inverse;
+  double* qfrc_constraint;
+} mjwf_inverse_job;
+
+static void mjwf_inverse_frames(void* ctx, int worker, int begin, int end) {
+  const mjwf_inverse_job* job = (const mjwf_inverse_job*)ctx;
+  const mjModel* m = job->m;
+  mjData* d = _mjwf_scratch_of(job->h, worker);
+  const size_t nq = (size_t)m->nq;
+  const size_t nv = (size_t)m->nv;
+  for (int t = begin; t < end; ++t) {
+    memcpy(d->qpos, job->qpos + t * nq, sizeof(double) * nq);
+    memcpy(d->qvel, job->qvel + t * nv, sizeof(double) * nv);
+    memcpy(d->qacc, job->qacc + t * nv, sizeof(double) * nv);
+    mj_inverse(m, d);
+    memcpy(job->qfrc_inverse + t * nv, d->qfrc_inverse, sizeof(double) * nv);
+    if (job->qfrc_constraint) {
+      memcpy(job->qfrc_constraint + t * nv, d->qfrc_constraint, sizeof(double) * nv);
+    }
+  }
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_inverse_batch(int h, const double* qpos, const double* qvel, const double* qacc,
+                                            int T, double* qfrc_inverse, double* qfrc_constraint) {
+  if (!mjwf_valid(h)) return 0;
+  if (!qpos || !qvel || !qacc || !qfrc_inverse || T <= 0) {
+    _mjwf_set_error(h, 80, "inverse_batch: empty trajectory or output");
+    return 0;
+  }
+  mjwf_inverse_job job = {0};
+  job.h = h;
+  job.m = _mjwf_model_of(h);
+  job.qpos = qpos;
+  job.qvel = qvel;
+  job.qacc = qacc;
+  job.qfrc_inverse = qfrc_inverse;
+  job.qfrc_constraint = qfrc_constraint;
+  const int nworker = _mjwf_worker_count(T);
+  if (!_mjwf_scratch_reserve(h, nworker)) return 0;
+  _mjwf_parallel_for(T, nworker, mjwf_inverse_frames, &job);
+  return 1;
+}
@@ -0,0 +1,168 @@
+// Copy-on-write model parameter overlays for MuJoCo WASM 3.3.7
+// Views marked overlay in codegen/spec_*.yaml (friction, masses, damping,
+// gains, ...) are model arrays a handle may override without touching the
+// model it shares (see mjwf_make_shared). The first write access -- taking the
+// view pointer, a command-buffer SET_VIEW or a sample call -- duplicates that
+// one array and swaps the copy into the handle's mjModel struct, so stepping
+// and every batched service pick it up with no per-step work. The original
+// ("nominal") array is kept for re-sampling and restored on reset/free.
+//
+// Derived model constants (body_subtreemass, dof_invweight0, ...) are not
+// recomputed after overrides.
+
+#include <mujoco/mujoco.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mjwf_exports.h"
+#include "mjwf_exports_generated.h"
+#include "mjwf_internal.h"
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#else
+#ifndef EMSCRIPTEN_KEEPALIVE
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#endif
+
+typedef struct {
+  int view;
+  double* nominal;
+  double* priv;
+  int n;
+} mjwf_overlay;
+
+static mjwf_overlay g_overlay[MJWF_MAXH][MJWF_VIEW_COUNT];
+static int g_noverlay[MJWF_MAXH];
+
+static mjwf_overlay* mjwf_overlay_find(int h, int view) {
+  for (int i = 0; i < g_noverlay[h]; ++i) {
+    if (g_overlay[h][i].view == view) return &g_overlay[h][i];
+  }
+  return NULL;
+}
+
+static mjwf_overlay* mjwf_overlay_get(int h, int view) {
+  if (!mjwf_valid(h)) return NULL;
+  if (!_mjwf_view_is_overlay(view)) {
+    _mjwf_set_error(h, 110, "overlay: view is not an overlay view");
+    return NULL;
+  }
+  mjwf_overlay* o = mjwf_overlay_find(h, view);
+  if (o) return o;
+  mjModel* m = _mjwf_model_of(h);
+  void** slot = _mjwf_view_model_slot(m, view);
+  const int n = _mjwf_view_size(m, view);
+  double* priv = n > 0 ? (double*)malloc(sizeof(double) * n) : NULL;
+  if (n > 0 && !priv) {
+    _mjwf_set_error(h, 111, "overlay: allocation failed");
+    return NULL;
+  }
+  o = &g_overlay[h][g_noverlay[h]++];
+  o->view = view;
+  o->nominal = (double*)*slot;
+  o->priv = priv;
+  o->n = n;
+  if (n > 0) {
+    memcpy(priv, o->nominal, sizeof(double) * n);
+    *slot = priv;
+  }
+  return o;
+}
+
+void* _mjwf_overlay_acquire(int h, int view) {
+  mjwf_overlay* o = mjwf_overlay_get(h, view);
+  if (!o) return NULL;
+  return o->n > 0 ? o->priv : o->nominal;
+}
+
+void* _mjwf_view_writable_addr(int h, int view) {
+  if (_mjwf_view_is_overlay(view)) return _mjwf_overlay_acquire(h, view);
+  return _mjwf_view_addr(_mjwf_model_of(h), _mjwf_data_of(h), view);
+}
+
+static void mjwf_overlay_drop(int h, int i) {
+  mjwf_overlay* o = &g_overlay[h][i];
+  mjModel* m = _mjwf_model_of(h);
+  void** slot = m ? _mjwf_view_model_slot(m, o->view) : NULL;
+  if (slot && o->n > 0) *slot = o->nominal;
+  free(o->priv);
+  g_overlay[h][i] = g_overlay[h][--g_noverlay[h]];
+}
+
+void _mjwf_overlay_release(int h) {
+  if (h <= 0 || h >= MJWF_MAXH) return;
+  while (g_noverlay[h] > 0) mjwf_overlay_drop(h, g_noverlay[h] - 1);
+}
+
+void _mjwf_overlay_strip(int h, mjModel* m) {
+  if (h <= 0 || h >= MJWF_MAXH) return;
+  for (int i = 0; i < g_noverlay[h]; ++i) {
+    const mjwf_overlay* o = &g_overlay[h][i];
+    if (o->n > 0) *_mjwf_view_model_slot(m, o->view) = o->nominal;
+  }
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_overlay_count(int h) {
+  return mjwf_valid(h) ? g_noverlay[h] : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_overlay_reset(int h, int view) {
+  if (!mjwf_valid(h)) return 0;
+  for (int i = g_noverlay[h] - 1; i >= 0; --i) {
+    if (view < 0 || g_overlay[h][i].view == view) mjwf_overlay_drop(h, i);
+  }
+  return 1;
+}
+
+static uint64_t mjwf_overlay_rng(uint64_t* s) {
+  uint64_t z = (*s += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_overlay_sample(const int* handles, int nh, int view, int offset, int count,
+                                             int mode, double lo, double hi, uint32_t seed) {
+  if (!handles || nh <= 0 || mode < MJWF_SAMPLE_SCALE || mode > MJWF_SAMPLE_SET) {
+    _mjwf_set_global_error(112, "overlay_sample: bad arguments");
+    return 0;
+  }
+  for (int k = 0; k < nh; ++k) {
+    mjwf_overlay* o = mjwf_overlay_get(handles[k], view);
+    if (!o) return 0;
+    int c = count;
+    if (offset < 0 || offset > o->n) {
+      _mjwf_set_error(handles[k], 113, "overlay_sample: offset out of range");
+      return 0;
+    }
+    if (c < 0 || c > o->n - offset) c = o->n - offset;
+    uint64_t s = ((uint64_t)seed << 32) ^ (uint64_t)k;
+    for (int i = offset; i < offset + c; ++i) {
+      const double u = lo + (hi - lo) * (double)(mjwf_overlay_rng(&s) >> 11) * (1.0 / 9007199254740992.0);
+      switch (mode) {
+        case MJWF_SAMPLE_SCALE: o->priv[i] = o->nominal[i] * u; break;
+        case MJWF_SAMPLE_ADD:   o->priv[i] = o->nominal[i] + u; break;
+        default:                o->priv[i] = u; break;
+      }
+    }
+  }
+  return 1;
+}
+
+// Memory accounting: bytes this handle's model costs on its own (model struct,
+// plus the model buffer unless shared, plus overlay copies) vs a full copy.
+EMSCRIPTEN_KEEPALIVE double mjwf_model_private_bytes(int h) {
+  if (!mjwf_valid(h)) return 0;
+  double bytes = (double)sizeof(mjModel);
+  if (!_mjwf_shared_base(h)) bytes += (double)_mjwf_model_of(h)->nbuffer;
+  for (int i = 0; i < g_noverlay[h]; ++i) bytes += (double)sizeof(double) * g_overlay[h][i].n;
+  return bytes;
+}
+
+EMSCRIPTEN_KEEPALIVE double mjwf_model_full_bytes(int h) {
+  if (!mjwf_valid(h)) return 0;
+  return (double)sizeof(mjModel) + (double)_mjwf_model_of(h)->nbuffer;
+}
@@ -0,0 +1,113 @@
+// Wall-clock paced stepping for MuJoCo WASM 3.3.7
+// mjwf_step_for_budget steps a handle until its simulated time reaches a
+// target or a wall-clock budget runs out, whichever comes first, so viewers
+// can ask for "catch up to now, but spend at most X us" once per frame.
+//
+// The handle keeps a moving average of the cost of one mj_step; a batch is
+// only started when the average says it fits in the remaining budget, so a
+// frame overshoots by at most one step's cost variance. At least one step is
+// taken whenever the handle is behind, so a budget smaller than a single step
+// (zero included) slows the simulation down instead of freezing it.
+//
+// With MJWF_PACE_ADAPTIVE, steps run in batches sized from the average (up to
+// MJWF_PACE_MAXBATCH) and the clock is read once per batch instead of once per
+// step, which matters for cheap models where reading the clock (a JS call in
+// WASM) is a noticeable fraction of a step.
+
+#if !defined(__EMSCRIPTEN__) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L  // clock_gettime
+#endif
+
+#include <math.h>
+#include <mujoco/mujoco.h>
+
+#include "mjwf_exports.h"
+#include "mjwf_internal.h"
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#else
+#include <time.h>
+#ifndef EMSCRIPTEN_KEEPALIVE
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#endif
+
+#define MJWF_PACE_MAXBATCH 32
+#define MJWF_PACE_ALPHA 0.1  // moving-average weight of the newest batch
+
+static double g_step_us[MJWF_MAXH];  // moving average of one mj_step, 0 = unknown
+
+double _mjwf_now_us(void) {
+#if defined(__EMSCRIPTEN__)
+  return emscripten_get_now() * 1000.0;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec * 1e-3;
+#endif
+}
+
+void _mjwf_pace_release(int h) {
+  if (h > 0 && h < MJWF_MAXH) g_step_us[h] = 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_step_for_budget(int h, double target_time, double budget_us, int flags,
+                                              double* stats) {
+  if (!mjwf_valid(h)) return -1;
+  if (!(budget_us >= 0)) {
+    _mjwf_set_error(h, 130, "step_for_budget: budget must be >= 0");
+    return -1;
+  }
+  if (!isfinite(target_time)) {
+    _mjwf_set_error(h, 130, "step_for_budget: target time must be finite");
+    return -1;
+  }
+  const mjModel* m = _mjwf_model_of(h);
+  mjData* d = _mjwf_data_of(h);
+  const double dt = m->opt.timestep;
+  const double t0 = _mjwf_now_us();
+  const int record = _mjwf_replay_recording(h);
+  double elapsed = 0;
+  int steps = 0;
+  // Half a step of slack so accumulated rounding in d->time never costs an
+  // extra step past the target.
+  while (d->time + 0.5 * dt < target_time) {
+    const double avg = g_step_us[h];
+    // Sized in double and clamped before the int conversion: an unlimited
+    // budget or a far target would overflow it.
+    double want = 1;
+    if (steps > 0) {
+      const double left = budget_us - elapsed;
+      if (left <= 0 || (avg > 0 && avg > left)) break;
+      if ((flags & MJWF_PACE_ADAPTIVE) && avg > 0) want = 0.5 * left / avg;
+    } else if ((flags & MJWF_PACE_ADAPTIVE) && avg > 0) {
+      want = 0.5 * budget_us / avg;
+    }
+    want = fmin(want, (target_time - d->time) / dt + 0.5);
+    want = fmin(want, MJWF_PACE_MAXBATCH);
+    const int batch = want < 1 ? 1 : (int)want;
+
+    const double tb = _mjwf_now_us();
+    for (int i = 0; i < batch; ++i) {
+      mj_step(m, d);
+      if (record) _mjwf_replay_record(h);
+    }
+    const double now = _mjwf_now_us();
+    const double cost = (now - tb) / batch;
+    g_step_us[h] = avg > 0 ? avg + MJWF_PACE_ALPHA * (cost - avg) : cost;
+    elapsed = now - t0;
+    steps += batch;
+  }
+  if (stats) {
+    stats[0] = steps;
+    stats[1] = target_time - d->time;
+    stats[2] = g_step_us[h];
+    stats[3] = elapsed;
+  }
+  return steps;
+}
+
+EMSCRIPTEN_KEEPALIVE double mjwf_step_cost_us(int h) {
+  return mjwf_valid(h) ? g_step_us[h] : 0;
+}
@@ -0,0 +1,179 @@
+// Batched ray casting for MuJoCo WASM 3.3.7
+// One call casts many rays against the handle's current kinematics (call
+// mjwf_forward or step first). Output is distance (-1 for no hit or beyond
+// cutoff) and geom id (-1 for no hit) per ray, both packed row-major.
+//
+// mjwf_ray_batch : N arbitrary rays, pnt/vec are N x 3 (mj_ray semantics:
+//                  distance is in units of |vec|).
+// mjwf_ray_scan  : lidar-style pattern from a site or body frame. Ray (i, j)
+//                  for elevation row i and azimuth column j points along
+//                  R * (cos(el) cos(az), cos(el) sin(az), sin(el)), i.e. the
+//                  frame's +x is forward and +z is up. Rows are cast with
+//                  mj_multiRay since they share an origin.
+// Filters: geomgroup (mjNGROUP bytes, NULL for all groups), flg_static and a
+// single excluded body id (-1 for none), as in mj_ray.
+
+#include <mujoco/mujoco.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "mjwf_exports.h"
+#include "mjwf_internal.h"
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#else
+#ifndef EMSCRIPTEN_KEEPALIVE
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#endif
+
+typedef struct {
+  int h;
+  const mjModel* m;
+  mjData* shared;       // batch always, scan when running inline
+  const double* pnt;    // batch: N x 3; scan: single origin
+  const double* vec;    // N x 3
+  int ncol;             // scan: rays per row
+  const mjtByte* geomgroup;
+  mjtByte flg_static;
+  int bodyexclude;
+  double cutoff;
+  double* dist;
+  int* geomid;
+} mjwf_ray_job;
+
+static mjData* mjwf_ray_data(const mjwf_ray_job* job, int worker) {
+  return job->shared ? job->shared : _mjwf_scratch_of(job->h, worker);
+}
+
+static void mjwf_ray_finish(const mjwf_ray_job* job, int i, double dist, int gid) {
+  if (gid < 0 || dist < 0 || (job->cutoff > 0 && dist > job->cutoff)) {
+    dist = -1;
+    gid = -1;
+  }
+  job->dist[i] = dist;
+  if (job->geomid) job->geomid[i] = gid;
+}
+
+static void mjwf_ray_range(void* ctx, int worker, int begin, int end) {
+  const mjwf_ray_job* job = (const mjwf_ray_job*)ctx;
+  const mjData* d = mjwf_ray_data(job, worker);
+  for (int i = begin; i < end; ++i) {
+    int gid = -1;
+    const double dist = mj_ray(job->m, d, job->pnt + 3 * i, job->vec + 3 * i,
+                               job->geomgroup, job->flg_static, job->bodyexclude, &gid);
+    mjwf_ray_finish(job, i, dist, gid);
+  }
+}
+
+static void mjwf_scan_range(void* ctx, int worker, int begin, int end) {
+  const mjwf_ray_job* job = (const mjwf_ray_job*)ctx;
+  mjData* d = mjwf_ray_data(job, worker);
+  const double cutoff = job->cutoff > 0 ? job->cutoff : mjMAXVAL;
+  for (int row = begin; row < end; ++row) {
+    const int off = row * job->ncol;
+    mj_multiRay(job->m, d, job->pnt, job->vec + 3 * off, job->geomgroup, job->flg_static,
+                job->bodyexclude, job->geomid + off, job->dist + off, job->ncol, cutoff);
+    for (int j = 0; j < job->ncol; ++j) {
+      mjwf_ray_finish(job, off + j, job->dist[off + j], job->geomid[off + j]);
+    }
+  }
+}
+
+// mj_multiRay allocates on the mjData stack, so parallel scans cast on
+// per-worker copies of the handle's data. mj_ray only reads d: batches share
+// the handle's from every worker and never reserve scratch.
+static int mjwf_ray_run(mjwf_ray_job* job, int n, mjwf_range_fn fn) {
+  const int nworker = _mjwf_worker_count(n);
+  if (nworker > 1) {
+    if (!_mjwf_scratch_reserve(job->h, nworker)) return 0;
+    job->shared = NULL;
+  } else {
+    job->shared = _mjwf_data_of(job->h);
+  }
+  _mjwf_parallel_for(n, nworker, fn, job);
+  return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_ray_batch(int h, const double* pnt, const double* vec, int n,
+                                        const unsigned char* geomgroup, int flg_static, int bodyexclude,
+                                        double cutoff, double* dist, int* geomid) {
+  if (!mjwf_valid(h)) return 0;
+  if (!pnt || !vec || !dist || n <= 0) {
+    _mjwf_set_error(h, 50, "ray_batch: empty input or output");
+    return 0;
+  }
+  mjwf_ray_job job = {0};
+  job.h = h;
+  job.m = _mjwf_model_of(h);
+  job.pnt = pnt;
+  job.vec = vec;
+  job.geomgroup = geomgroup;
+  job.flg_static = (mjtByte)(flg_static != 0);
+  job.bodyexclude = bodyexclude;
+  job.cutoff = cutoff;
+  job.dist = dist;
+  job.geomid = geomid;
+  job.shared = _mjwf_data_of(h);
+  _mjwf_parallel_for(n, _mjwf_worker_count(n), mjwf_ray_range, &job);
+  return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_ray_scan(int h, int objtype, int objid,
+                                       int naz, double az_min, double az_max,
+                                       int nel, double el_min, double el_max,
+                                       const unsigned char* geomgroup, int flg_static, int bodyexclude,
+                                       double cutoff, double* dist, int* geomid) {
+  if (!mjwf_valid(h)) return 0;
+  const mjModel* m = _mjwf_model_of(h);
+  const mjData* d = _mjwf_data_of(h);
+  const double* pos;
+  const double* mat;
+  if (objtype == mjOBJ_SITE && objid >= 0 && objid < m->nsite) {
+    pos = d->site_xpos + 3 * objid;
+    mat = d->site_xmat + 9 * objid;
+  } else if (objtype == mjOBJ_BODY && objid >= 0 && objid < m->nbody) {
+    pos = d->xpos + 3 * objid;
+    mat = d->xmat + 9 * objid;
+  } else {
+    _mjwf_set_error(h, 51, "ray_scan: frame must be a valid site or body");
+    return 0;
+  }
+  if (naz <= 0 || nel <= 0 || !dist) {
+    _mjwf_set_error(h, 50, "ray_scan: empty pattern or output");
+    return 0;
+  }
+
+  // Grow-only per-handle scratch: directions are rebuilt per call and geom ids
+  // land here when the caller does not want them (mj_multiRay needs both).
+  const int n = naz * nel;
+  double* scan_vec = (double*)_mjwf_arena_buffer(h, MJWF_BUF_RAY_VEC, sizeof(double) * 3 * (size_t)n);
+  int* scan_gid = (int*)_mjwf_arena_buffer(h, MJWF_BUF_RAY_GEOMID, sizeof(int) * (size_t)n);
+  if (!scan_vec || !scan_gid) {
+    _mjwf_set_error(h, 52, "ray_scan: allocation failed");
+    return 0;
+  }
+  for (int i = 0; i < nel; ++i) {
+    const double el = nel > 1 ? el_min + (el_max - el_min) * i / (nel - 1) : el_min;
+    for (int j = 0; j < naz; ++j) {
+      const double az = naz > 1 ? az_min + (az_max - az_min) * j / (naz - 1) : az_min;
+      const double local[3] = { cos(el) * cos(az), cos(el) * sin(az), sin(el) };
+      mju_mulMatVec3(scan_vec + 3 * (i * naz + j), mat, local);
+    }
+  }
+
+  mjwf_ray_job job = {0};
+  job.h = h;
+  job.m = m;
+  job.pnt = pos;
+  job.vec = scan_vec;
+  job.ncol = naz;
+  job.geomgroup = geomgroup;
+  job.flg_static = (mjtByte)(flg_static != 0);
+  job.bodyexclude = bodyexclude;
+  job.cutoff = cutoff;
+  job.dist = dist;
+  job.geomid = geomid ? geomid : scan_gid;
+  return mjwf_ray_run(&job, nel, mjwf_scan_range);
+}
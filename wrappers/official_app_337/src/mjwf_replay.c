@@ -0,0 +1,100 @@
+// Replay logs for MuJoCo WASM 3.3.7
+// mjwf_replay_record_start makes a handle append every step taken through
+// mjwf_step or mjwf_step_for_budget to a binary log: the initial state once,
+// then per step the ctrl (only when it changed) and 32-bit hashes of each
+// state component, plus a full state every checkpoint_every steps. Other
+// inputs (qfrc_applied, xfrc_applied, mocap, ...) are only captured in the
+// initial state, so keep them fixed while recording.
+//
+// mjwf_replay_check re-runs a log on a handle of the same model and stops at
+// the first step whose hashes differ, reporting the step and component (and
+// the element, when the log has a checkpoint at that step; record with
+// checkpoint_every = 1 to always get it). mujoco_compare337 --record/--replay
+// reads and writes the same format natively (see mjwf_replay_log.h), so logs
+// move freely between WASM and native builds.
+//
+// An in-place mjwf_recompile ends a recording at the next step (code 183):
+// the log stays valid and holds the steps taken before the edit.
+
+#include <mujoco/mujoco.h>
+
+#include "mjwf_exports.h"
+#include "mjwf_internal.h"
+#include "mjwf_replay_log.h"
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#else
+#ifndef EMSCRIPTEN_KEEPALIVE
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#endif
+
+static mjwf_rlog_writer g_rec[MJWF_MAXH];
+static int g_rec_generation[MJWF_MAXH];  // model the log's header describes
+
+int _mjwf_replay_recording(int h) {
+  return h > 0 && h < MJWF_MAXH && g_rec[h].f != NULL;
+}
+
+void _mjwf_replay_record(int h) {
+  if (!_mjwf_replay_recording(h)) return;
+  if (g_rec_generation[h] != _mjwf_model_generation(h)) {
+    // Recompiled in place: sizes no longer match the header or the buffers.
+    mjwf_rlog_close(&g_rec[h]);
+    _mjwf_set_error(h, 183, "replay: model recompiled, recording stopped");
+    return;
+  }
+  if (!mjwf_rlog_step(&g_rec[h], _mjwf_model_of(h), _mjwf_data_of(h))) {
+    mjwf_rlog_close(&g_rec[h]);
+    _mjwf_set_error(h, 182, "replay: write failed, recording stopped");
+  }
+}
+
+void _mjwf_replay_release(int h) {
+  if (_mjwf_replay_recording(h)) mjwf_rlog_close(&g_rec[h]);
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_replay_record_start(int h, const char* path, int checkpoint_every) {
+  if (!mjwf_valid(h)) return 0;
+  if (_mjwf_replay_recording(h)) {
+    _mjwf_set_error(h, 180, "replay_record_start: handle is already recording");
+    return 0;
+  }
+  if (!mjwf_rlog_open(&g_rec[h], path, _mjwf_model_of(h), _mjwf_data_of(h), checkpoint_every)) {
+    _mjwf_set_error(h, 180, "replay_record_start: cannot write log");
+    return 0;
+  }
+  g_rec_generation[h] = _mjwf_model_generation(h);
+  return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_replay_record_stop(int h) {
+  if (!_mjwf_replay_recording(h)) return -1;
+  const int steps = (int)g_rec[h].steps;
+  mjwf_rlog_close(&g_rec[h]);
+  return steps;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_replay_check(int h, const char* path, double max_steps, double* result) {
+  if (!mjwf_valid(h)) return -1;
+  mjwf_rlog_result r;
+  const int status = mjwf_rlog_replay(path, _mjwf_model_of(h), _mjwf_data_of(h), (long long)max_steps, &r);
+  if (status < 0) {
+    _mjwf_set_error(h, 181, r.error);
+    return -1;
+  }
+  if (result) {
+    result[MJWF_REPLAY_STEPS] = (double)r.steps;
+    result[MJWF_REPLAY_STEP] = (double)r.step;
+    result[MJWF_REPLAY_COMP] = r.comp;
+    result[MJWF_REPLAY_ELEMENT] = r.element;
+    result[MJWF_REPLAY_EXPECTED] = r.expected;
+    result[MJWF_REPLAY_ACTUAL] = r.actual;
+  }
+  return status;
+}
+
+EMSCRIPTEN_KEEPALIVE const char* mjwf_replay_comp_name(int comp) {
+  return mjwf_rlog_comp_name(comp);
+}
@@ -0,0 +1,219 @@
+// Replay log reader/writer for MuJoCo WASM 3.3.7 (format in mjwf_replay_log.h)
+// Each step is hashed per state component (time, qpos, qvel, act, warmstart,
+// mocap, userdata, plugin state) with a 32-bit bit-exact hash, so a replay
+// finds the first divergent step and component in a single pass. Components
+// that are empty for the model are left out.
+
+#include "mjwf_replay_log.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static const struct {
+  int bit;
+  const char* name;
+} k_comp[MJWF_RLOG_MAXCOMP] = {
+  {mjSTATE_TIME, "time"},
+  {mjSTATE_QPOS, "qpos"},
+  {mjSTATE_QVEL, "qvel"},
+  {mjSTATE_ACT, "act"},
+  {mjSTATE_WARMSTART, "qacc_warmstart"},
+  {mjSTATE_MOCAP_POS, "mocap_pos"},
+  {mjSTATE_MOCAP_QUAT, "mocap_quat"},
+  {mjSTATE_USERDATA, "userdata"},
+  {mjSTATE_PLUGIN, "plugin_state"},
+};
+
+const char* mjwf_rlog_comp_name(int comp) {
+  for (int i = 0; i < MJWF_RLOG_MAXCOMP; ++i) {
+    if (k_comp[i].bit == comp) return k_comp[i].name;
+  }
+  return "unknown";
+}
+
+static const mjtNum* mjwf_rlog_comp_data(const mjData* d, int comp) {
+  switch (comp) {
+    case mjSTATE_TIME:       return &d->time;
+    case mjSTATE_QPOS:       return d->qpos;
+    case mjSTATE_QVEL:       return d->qvel;
+    case mjSTATE_ACT:        return d->act;
+    case mjSTATE_WARMSTART:  return d->qacc_warmstart;
+    case mjSTATE_MOCAP_POS:  return d->mocap_pos;
+    case mjSTATE_MOCAP_QUAT: return d->mocap_quat;
+    case mjSTATE_USERDATA:   return d->userdata;
+    case mjSTATE_PLUGIN:     return d->plugin_state;
+    default:                 return NULL;
+  }
+}
+
+static int mjwf_rlog_components(const mjModel* m, int32_t* comp) {
+  int n = 0;
+  for (int i = 0; i < MJWF_RLOG_MAXCOMP; ++i) {
+    if (mj_stateSize(m, k_comp[i].bit) > 0) comp[n++] = k_comp[i].bit;
+  }
+  return n;
+}
+
+// Offset of a component inside an mjSTATE_INTEGRATION vector.
+static int mjwf_rlog_comp_offset(const mjModel* m, int comp) {
+  int offset = 0;
+  for (int bit = 1; bit < comp; bit <<= 1) offset += mj_stateSize(m, bit);
+  return offset;
+}
+
+static uint32_t mjwf_rlog_hash(const mjtNum* x, int n) {
+  uint64_t h = 0x9E3779B97F4A7C15ull ^ (uint64_t)n;
+  for (int i = 0; i < n; ++i) {
+    uint64_t w;
+    memcpy(&w, &x[i], sizeof(w));
+    w *= 0xBF58476D1CE4E5B9ull;
+    w ^= w >> 31;
+    h = (h ^ w) * 0x94D049BB133111EBull;
+  }
+  return (uint32_t)(h ^ (h >> 32));
+}
+
+static void mjwf_rlog_hashes(const mjModel* m, const mjData* d, const mjwf_rlog_header* hdr, uint32_t* out) {
+  for (int i = 0; i < hdr->ncomp; ++i) {
+    out[i] = mjwf_rlog_hash(mjwf_rlog_comp_data(d, hdr->comp[i]), mj_stateSize(m, hdr->comp[i]));
+  }
+}
+
+static void mjwf_rlog_fill_header(mjwf_rlog_header* hdr, const mjModel* m, int checkpoint_every) {
+  memset(hdr, 0, sizeof(*hdr));
+  memcpy(hdr->magic, "MJWFRLOG", 8);
+  hdr->version = MJWF_RLOG_VERSION;
+  hdr->nq = m->nq;
+  hdr->nv = m->nv;
+  hdr->na = m->na;
+  hdr->nu = m->nu;
+  hdr->nstate = mj_stateSize(m, mjSTATE_INTEGRATION);
+  hdr->checkpoint_every = checkpoint_every > 0 ? checkpoint_every : 0;
+  hdr->ncomp = mjwf_rlog_components(m, hdr->comp);
+  hdr->timestep = m->opt.timestep;
+  strncpy(hdr->mjversion, mj_versionString(), sizeof(hdr->mjversion) - 1);
+}
+
+int mjwf_rlog_open(mjwf_rlog_writer* w, const char* path, const mjModel* m, const mjData* d,
+                   int checkpoint_every) {
+  memset(w, 0, sizeof(*w));
+  mjwf_rlog_fill_header(&w->hdr, m, checkpoint_every);
+  w->ctrl = (double*)malloc(sizeof(double) * (m->nu > 0 ? m->nu : 1));
+  w->state = (mjtNum*)malloc(sizeof(mjtNum) * (w->hdr.nstate > 0 ? w->hdr.nstate : 1));
+  w->f = (path && w->ctrl && w->state) ? fopen(path, "wb") : NULL;
+  if (!w->f) {
+    mjwf_rlog_close(w);
+    return 0;
+  }
+  mj_getState(m, d, w->state, mjSTATE_INTEGRATION);
+  if (fwrite(&w->hdr, sizeof(w->hdr), 1, w->f) != 1 ||
+      fwrite(w->state, sizeof(mjtNum), (size_t)w->hdr.nstate, w->f) != (size_t)w->hdr.nstate) {
+    mjwf_rlog_close(w);
+    return 0;
+  }
+  return 1;
+}
+
+int mjwf_rlog_step(mjwf_rlog_writer* w, const mjModel* m, const mjData* d) {
+  if (!w->f) return 0;
+  const int nu = w->hdr.nu;
+  const int every = w->hdr.checkpoint_every;
+  unsigned char tag = 0;
+  if (nu && (w->steps == 0 || memcmp(w->ctrl, d->ctrl, sizeof(double) * nu) != 0)) tag |= MJWF_RLOG_CTRL;
+  if (every && (w->steps + 1) % every == 0) tag |= MJWF_RLOG_CHECKPOINT;
+  uint32_t hash[MJWF_RLOG_MAXCOMP];
+  mjwf_rlog_hashes(m, d, &w->hdr, hash);
+
+  int ok = fputc(tag, w->f) != EOF;
+  if (tag & MJWF_RLOG_CTRL) {
+    memcpy(w->ctrl, d->ctrl, sizeof(double) * nu);
+    ok = ok && fwrite(d->ctrl, sizeof(double), (size_t)nu, w->f) == (size_t)nu;
+  }
+  ok = ok && fwrite(hash, sizeof(uint32_t), (size_t)w->hdr.ncomp, w->f) == (size_t)w->hdr.ncomp;
+  if (tag & MJWF_RLOG_CHECKPOINT) {
+    mj_getState(m, d, w->state, mjSTATE_INTEGRATION);
+    ok = ok && fwrite(w->state, sizeof(mjtNum), (size_t)w->hdr.nstate, w->f) == (size_t)w->hdr.nstate;
+  }
+  w->steps += 1;
+  return ok;
+}
+
+void mjwf_rlog_close(mjwf_rlog_writer* w) {
+  if (w->f) fclose(w->f);
+  free(w->ctrl);
+  free(w->state);
+  memset(w, 0, sizeof(*w));
+}
+
+static int mjwf_rlog_fail(mjwf_rlog_result* r, FILE* f, mjtNum* state, const char* msg) {
+  snprintf(r->error, sizeof(r->error), "%s", msg);
+  if (f) fclose(f);
+  free(state);
+  return -1;
+}
+
+int mjwf_rlog_replay(const char* path, const mjModel* m, mjData* d, long long max_steps,
+                     mjwf_rlog_result* r) {
+  memset(r, 0, sizeof(*r));
+  r->element = -1;
+  FILE* f = path ? fopen(path, "rb") : NULL;
+  if (!f) return mjwf_rlog_fail(r, NULL, NULL, "cannot open log");
+  mjwf_rlog_header hdr, want;
+  mjwf_rlog_fill_header(&want, m, 0);
+  if (fread(&hdr, sizeof(hdr), 1, f) != 1 || memcmp(hdr.magic, want.magic, 8) != 0 ||
+      hdr.version != MJWF_RLOG_VERSION) {
+    return mjwf_rlog_fail(r, f, NULL, "not a replay log");
+  }
+  if (hdr.nq != want.nq || hdr.nv != want.nv || hdr.na != want.na || hdr.nu != want.nu ||
+      hdr.nstate != want.nstate || hdr.ncomp != want.ncomp || hdr.timestep != want.timestep ||
+      memcmp(hdr.comp, want.comp, sizeof(hdr.comp)) != 0) {
+    return mjwf_rlog_fail(r, f, NULL, "log was recorded with a different model");
+  }
+  mjtNum* state = (mjtNum*)malloc(sizeof(mjtNum) * (hdr.nstate > 0 ? hdr.nstate : 1));
+  if (!state) return mjwf_rlog_fail(r, f, NULL, "allocation failed");
+  if (fread(state, sizeof(mjtNum), (size_t)hdr.nstate, f) != (size_t)hdr.nstate) {
+    return mjwf_rlog_fail(r, f, state, "truncated initial state");
+  }
+  mj_setState(m, d, state, mjSTATE_INTEGRATION);
+
+  const size_t nu = (size_t)hdr.nu;
+  const size_t ncomp = (size_t)hdr.ncomp;
+  const size_t nstate = (size_t)hdr.nstate;
+  uint32_t expected[MJWF_RLOG_MAXCOMP], actual[MJWF_RLOG_MAXCOMP];
+  int c;
+  while ((max_steps <= 0 || r->steps < max_steps) && (c = fgetc(f)) != EOF) {
+    const int tag = c;
+    if (((tag & MJWF_RLOG_CTRL) && fread(d->ctrl, sizeof(double), nu, f) != nu) ||
+        fread(expected, sizeof(uint32_t), ncomp, f) != ncomp ||
+        ((tag & MJWF_RLOG_CHECKPOINT) && fread(state, sizeof(mjtNum), nstate, f) != nstate)) {
+      return mjwf_rlog_fail(r, f, state, "truncated step record");
+    }
+    mj_step(m, d);
+    r->steps += 1;
+    mjwf_rlog_hashes(m, d, &hdr, actual);
+    for (size_t i = 0; i < ncomp; ++i) {
+      if (expected[i] == actual[i]) continue;
+      r->step = r->steps;
+      r->comp = hdr.comp[i];
+      if (tag & MJWF_RLOG_CHECKPOINT) {
+        const mjtNum* cur = mjwf_rlog_comp_data(d, r->comp);
+        const mjtNum* ref = state + mjwf_rlog_comp_offset(m, r->comp);
+        const int n = mj_stateSize(m, r->comp);
+        for (int k = 0; k < n; ++k) {
+          if (memcmp(&cur[k], &ref[k], sizeof(mjtNum)) != 0) {
+            r->element = k;
+            r->expected = ref[k];
+            r->actual = cur[k];
+            break;
+          }
+        }
+      }
+      fclose(f);
+      free(state);
+      return 0;
+    }
+  }
+  fclose(f);
+  free(state);
+  return 1;
+}
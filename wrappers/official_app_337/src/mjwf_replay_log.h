@@ -0,0 +1,80 @@
+// Replay log format for MuJoCo WASM 3.3.7
+// Plain C on top of MuJoCo only, so the same reader/writer is compiled into
+// the handle layer (mjwf_replay.c) and the native mujoco_compare337 tool.
+//
+// File layout (host byte order; WASM and the usual native hosts are both
+// little endian):
+//   mjwf_rlog_header
+//   initial state: nstate doubles (mjSTATE_INTEGRATION)
+//   one record per step:
+//     u8 tag (MJWF_RLOG_CTRL | MJWF_RLOG_CHECKPOINT)
+//     [nu doubles ctrl, when it changed since the previous record]
+//     ncomp u32 hashes of the state after the step, one per component
+//     [nstate doubles state after the step, every checkpoint_every steps]
+
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MJWF_RLOG_VERSION    1
+#define MJWF_RLOG_MAXCOMP    9
+#define MJWF_RLOG_CTRL       1
+#define MJWF_RLOG_CHECKPOINT 2
+
+typedef struct {
+  char magic[8];                    // "MJWFRLOG"
+  int32_t version;
+  int32_t nq, nv, na, nu;
+  int32_t nstate;                   // mj_stateSize(m, mjSTATE_INTEGRATION)
+  int32_t checkpoint_every;         // 0: no checkpoints
+  int32_t ncomp;
+  int32_t comp[MJWF_RLOG_MAXCOMP];  // mjtState bit of each hashed component
+  double timestep;
+  char mjversion[16];
+} mjwf_rlog_header;
+
+typedef struct {
+  FILE* f;
+  mjwf_rlog_header hdr;
+  long long steps;
+  double* ctrl;  // ctrl of the previous record
+  mjtNum* state;
+} mjwf_rlog_writer;
+
+// Outcome of mjwf_rlog_replay. step is 1-based: the state after step `step`
+// differs from the log. element is the first differing index within the
+// component when a checkpoint covers that step, else -1.
+typedef struct {
+  long long steps;
+  long long step;
+  int comp;
+  int element;
+  double expected, actual;
+  char error[128];
+} mjwf_rlog_result;
+
+// Writes header and the current state as initial state; 0 on failure.
+int  mjwf_rlog_open(mjwf_rlog_writer* w, const char* path, const mjModel* m, const mjData* d,
+                    int checkpoint_every);
+// Appends the record of the step just taken (ctrl and resulting state).
+int  mjwf_rlog_step(mjwf_rlog_writer* w, const mjModel* m, const mjData* d);
+void mjwf_rlog_close(mjwf_rlog_writer* w);
+
+// Loads the log's initial state into d and re-runs it, stopping at the first
+// step whose state hashes differ (or after max_steps > 0). Returns 1 when
+// every step matched, 0 on divergence, -1 on a bad log or model mismatch
+// (result->error).
+int mjwf_rlog_replay(const char* path, const mjModel* m, mjData* d, long long max_steps,
+                     mjwf_rlog_result* result);
+
+const char* mjwf_rlog_comp_name(int comp);
+
+#ifdef __cplusplus
+}
+#endif
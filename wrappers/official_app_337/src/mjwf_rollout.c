@@ -0,0 +1,117 @@
+// Batched rollouts for MuJoCo WASM 3.3.7 (sampling-based MPC)
+// Runs K rollouts of H steps from one initial state with per-rollout control
+// sequences, on per-worker scratch mjData, recording selected views after
+// every step.
+//
+// state0 is in mj_getState(sig) layout; every rollout starts from the
+// handle's full integration state with state0 applied on top, so results do
+// not depend on how rollouts are split across workers.
+// ctrls is K x H x nu (NULL keeps the ctrl of the start state).
+// views lists view ids (mjwf_view_id); each step records their values
+// back-to-back as doubles, so out is K x H x mjwf_rollout_stride(h, views, nview).
+
+#include <mujoco/mujoco.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mjwf_exports.h"
+#include "mjwf_exports_generated.h"  // MJWF_VIEW_COUNT
+#include "mjwf_internal.h"
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#else
+#ifndef EMSCRIPTEN_KEEPALIVE
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#endif
+
+typedef struct {
+  int h;
+  const mjModel* m;
+  const mjtNum* base;    // handle state, mjSTATE_INTEGRATION
+  const double* state0;
+  unsigned int sig;
+  const double* ctrls;
+  int H;
+  const int* views;
+  int nview;
+  int stride;
+  double* out;
+} mjwf_rollout_job;
+
+EMSCRIPTEN_KEEPALIVE int mjwf_rollout_stride(int h, const int* views, int nview) {
+  const mjModel* m = _mjwf_model_of(h);
+  if (!m || (nview > 0 && !views)) return 0;
+  int stride = 0;
+  for (int i = 0; i < nview; ++i) stride += _mjwf_view_size(m, views[i]);
+  return stride;
+}
+
+static double* mjwf_rollout_record(const mjModel* m, mjData* d, const int* views, int nview, double* o) {
+  for (int i = 0; i < nview; ++i) o += _mjwf_view_read_f64(m, d, views[i], 0, -1, o);
+  return o;
+}
+
+static void mjwf_rollout_range(void* ctx, int worker, int begin, int end) {
+  const mjwf_rollout_job* job = (const mjwf_rollout_job*)ctx;
+  const mjModel* m = job->m;
+  mjData* d = _mjwf_scratch_of(job->h, worker);
+  const size_t nu = (size_t)m->nu;
+  for (int k = begin; k < end; ++k) {
+    mj_setState(m, d, job->base, mjSTATE_INTEGRATION);
+    mj_setState(m, d, job->state0, job->sig);
+    const double* u = job->ctrls ? job->ctrls + (size_t)k * job->H * nu : NULL;
+    double* o = job->out + (size_t)k * job->H * job->stride;
+    for (int t = 0; t < job->H; ++t) {
+      if (u && nu) memcpy(d->ctrl, u + t * nu, sizeof(double) * nu);
+      mj_step(m, d);
+      o = mjwf_rollout_record(m, d, job->views, job->nview, o);
+    }
+  }
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_rollout(int h, const double* state0, int sig, const double* ctrls,
+                                      int K, int H, const int* views, int nview, double* out) {
+  if (!mjwf_valid(h)) return 0;
+  if (!state0 || K <= 0 || H <= 0 || nview < 0 || (nview > 0 && (!views || !out))) {
+    _mjwf_set_error(h, 90, "rollout: empty input or output");
+    return 0;
+  }
+  if (sig <= 0 || sig >= (1 << mjNSTATE)) {
+    _mjwf_set_error(h, 93, "rollout: invalid state signature");
+    return 0;
+  }
+  const mjModel* m = _mjwf_model_of(h);
+  for (int i = 0; i < nview; ++i) {
+    if (views[i] < 0 || views[i] >= MJWF_VIEW_COUNT) {
+      _mjwf_set_error(h, 91, "rollout: unknown view id");
+      return 0;
+    }
+  }
+  const size_t mark = _mjwf_arena_mark(h);
+  mjtNum* base = (mjtNum*)_mjwf_arena_alloc(h, sizeof(mjtNum) * mj_stateSize(m, mjSTATE_INTEGRATION));
+  if (!base) {
+    _mjwf_set_error(h, 92, "rollout: allocation failed");
+    return 0;
+  }
+  mj_getState(m, _mjwf_data_of(h), base, mjSTATE_INTEGRATION);
+
+  mjwf_rollout_job job = {0};
+  job.h = h;
+  job.m = m;
+  job.base = base;
+  job.state0 = state0;
+  job.sig = (unsigned int)sig;
+  job.ctrls = ctrls;
+  job.H = H;
+  job.views = views;
+  job.nview = nview;
+  job.stride = mjwf_rollout_stride(h, views, nview);
+  job.out = out;
+  const int nworker = _mjwf_worker_count(K);
+  const int ok = _mjwf_scratch_reserve(h, nworker);
+  if (ok) _mjwf_parallel_for(K, nworker, mjwf_rollout_range, &job);
+  _mjwf_arena_reset(h, mark);
+  return ok;
+}
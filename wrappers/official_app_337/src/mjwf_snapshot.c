@@ -0,0 +1,333 @@
+// Compact state snapshots for MuJoCo WASM 3.3.7
+// A snapshot codec is configured per handle with an ordered list of views and
+// a quantum per view. The sim side encodes its handle every tick into a small
+// binary packet; viewers configure their own handle (same model) with the
+// same field set and apply the packets to it.
+//
+// Values are quantized to round(x / quantum) and sent as the difference to
+// the last keyframe, zigzag + varint coded with runs of unchanged values
+// collapsed, so resting bodies cost next to nothing. A quantum of 0 sends the
+// field losslessly (64-bit XOR against the keyframe). Keyframes are sent
+// every keyframe_every ticks or on request (MJWF_SNAPSHOT_KEYFRAME); deltas
+// always refer to a keyframe, never to the previous delta, so a viewer that
+// drops deltas only needs the latest keyframe to resync.
+//
+// Packet layout (little endian):
+//   u8 'M', u8 'S', u8 version, u8 flags (MJWF_SNAPSHOT_KEYFRAME)
+//   u32 layout hash (field set, quanta and view sizes)
+//   u32 keyframe id the packet refers to (its own id for keyframes)
+//   u32 sequence number
+//   f64 simulation time
+//   coded values, fields in configuration order
+//
+// Quantized values saturate at +-2^53 quanta; NaN is sent as 0.
+
+#include <math.h>
+#include <mujoco/mujoco.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mjwf_exports.h"
+#include "mjwf_exports_generated.h"  // MJWF_VIEW_COUNT
+#include "mjwf_internal.h"
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#else
+#ifndef EMSCRIPTEN_KEEPALIVE
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#endif
+
+#define MJWF_SNAPSHOT_VERSION 1
+#define MJWF_SNAPSHOT_HEADER 24
+#define MJWF_SNAPSHOT_QMAX 9007199254740992.0  // 2^53
+
+typedef struct {
+  int nfield;
+  int view[MJWF_VIEW_COUNT];
+  double quantum[MJWF_VIEW_COUNT];
+  int size[MJWF_VIEW_COUNT];
+  int nvalue;
+  int keyframe_every;
+  int generation;
+  uint32_t hash;
+  uint64_t* ref;    // keyframe: quantized values, or raw bits for lossless fields
+  double* values;   // scratch, nvalue
+  uint64_t* codes;  // scratch, nvalue
+  int has_ref;
+  uint32_t keyframe_id;
+  uint32_t seq;     // encoder only
+  uint32_t since_keyframe;
+} mjwf_snapshot;
+
+static mjwf_snapshot g_snap[MJWF_MAXH];
+
+static void mjwf_snapshot_clear(mjwf_snapshot* s) {
+  free(s->ref);
+  free(s->values);
+  free(s->codes);
+  memset(s, 0, sizeof(*s));
+}
+
+void _mjwf_snapshot_release(int h) {
+  if (h > 0 && h < MJWF_MAXH) mjwf_snapshot_clear(&g_snap[h]);
+}
+
+static mjwf_snapshot* mjwf_snapshot_of(int h) {
+  if (!mjwf_valid(h)) return NULL;
+  mjwf_snapshot* s = &g_snap[h];
+  if (!s->nfield || s->generation != _mjwf_model_generation(h)) {
+    _mjwf_set_error(h, 174, "snapshot: not configured for this model (call mjwf_snapshot_config)");
+    return NULL;
+  }
+  return s;
+}
+
+static uint32_t mjwf_fnv(uint32_t h, const void* p, size_t n) {
+  const unsigned char* b = (const unsigned char*)p;
+  for (size_t i = 0; i < n; ++i) h = (h ^ b[i]) * 16777619u;
+  return h;
+}
+
+static void mjwf_put_u32(unsigned char* p, uint32_t v) {
+  for (int i = 0; i < 4; ++i) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static uint32_t mjwf_get_u32(const unsigned char* p) {
+  return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static int mjwf_put_varint(unsigned char* p, uint64_t v) {
+  int n = 0;
+  while (v >= 0x80) {
+    p[n++] = (unsigned char)(v | 0x80);
+    v >>= 7;
+  }
+  p[n++] = (unsigned char)v;
+  return n;
+}
+
+// Returns bytes consumed, 0 when the varint runs past end.
+static int mjwf_get_varint(const unsigned char* p, const unsigned char* end, uint64_t* v) {
+  uint64_t r = 0;
+  for (int n = 0; n < 10 && p + n < end; ++n) {
+    r |= (uint64_t)(p[n] & 0x7F) << (7 * n);
+    if (!(p[n] & 0x80)) {
+      *v = r;
+      return n + 1;
+    }
+  }
+  return 0;
+}
+
+static uint64_t mjwf_bits(double x) {
+  uint64_t b;
+  memcpy(&b, &x, sizeof(b));
+  return b;
+}
+
+static int64_t mjwf_quantize(double x, double quantum) {
+  const double q = nearbyint(x / quantum);
+  if (q != q) return 0;
+  if (q > MJWF_SNAPSHOT_QMAX) return (int64_t)MJWF_SNAPSHOT_QMAX;
+  if (q < -MJWF_SNAPSHOT_QMAX) return -(int64_t)MJWF_SNAPSHOT_QMAX;
+  return (int64_t)q;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_snapshot_config(int h, const int* views, const double* quanta, int nfield,
+                                              int keyframe_every) {
+  if (!mjwf_valid(h)) return 0;
+  mjwf_snapshot* s = &g_snap[h];
+  mjwf_snapshot_clear(s);
+  if (!views || nfield <= 0 || nfield > MJWF_VIEW_COUNT) {
+    _mjwf_set_error(h, 170, "snapshot_config: need 1..MJWF_VIEW_COUNT fields");
+    return 0;
+  }
+  const mjModel* m = _mjwf_model_of(h);
+  uint32_t hash = 2166136261u;
+  for (int i = 0; i < nfield; ++i) {
+    const double q = quanta ? quanta[i] : 0;
+    if (views[i] < 0 || views[i] >= MJWF_VIEW_COUNT || !(q >= 0)) {
+      _mjwf_set_error(h, 170, "snapshot_config: bad view id or quantum");
+      mjwf_snapshot_clear(s);
+      return 0;
+    }
+    // Applying writes the views: model arrays only through a private overlay,
+    // never into a model other handles share.
+    if (_mjwf_view_is_model(views[i]) && !_mjwf_view_is_overlay(views[i])) {
+      _mjwf_set_error(h, 170, "snapshot_config: model views must be overlay views");
+      mjwf_snapshot_clear(s);
+      return 0;
+    }
+    s->view[i] = views[i];
+    s->quantum[i] = q;
+    s->size[i] = _mjwf_view_size(m, views[i]);
+    s->nvalue += s->size[i];
+    hash = mjwf_fnv(hash, &s->view[i], sizeof(int));
+    hash = mjwf_fnv(hash, &s->quantum[i], sizeof(double));
+    hash = mjwf_fnv(hash, &s->size[i], sizeof(int));
+  }
+  const size_t n = s->nvalue > 0 ? (size_t)s->nvalue : 1;
+  s->ref = (uint64_t*)calloc(n, sizeof(uint64_t));
+  s->values = (double*)malloc(n * sizeof(double));
+  s->codes = (uint64_t*)malloc(n * sizeof(uint64_t));
+  if (!s->ref || !s->values || !s->codes) {
+    mjwf_snapshot_clear(s);
+    _mjwf_set_error(h, 170, "snapshot_config: allocation failed");
+    return 0;
+  }
+  s->nfield = nfield;
+  s->hash = hash;
+  s->keyframe_every = keyframe_every;
+  s->generation = _mjwf_model_generation(h);
+  return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_snapshot_max_bytes(int h) {
+  const mjwf_snapshot* s = mjwf_snapshot_of(h);
+  return s ? MJWF_SNAPSHOT_HEADER + 10 * s->nvalue : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_snapshot_encode(int h, int flags, unsigned char* out, int cap) {
+  mjwf_snapshot* s = mjwf_snapshot_of(h);
+  if (!s) return 0;
+  if (!out || cap < MJWF_SNAPSHOT_HEADER + 10 * s->nvalue) {
+    _mjwf_set_error(h, 171, "snapshot_encode: buffer smaller than mjwf_snapshot_max_bytes");
+    return 0;
+  }
+  const mjModel* m = _mjwf_model_of(h);
+  mjData* d = _mjwf_data_of(h);
+  const int key = !s->has_ref || (flags & MJWF_SNAPSHOT_KEYFRAME) ||
+                  (s->keyframe_every > 0 && s->since_keyframe >= (uint32_t)s->keyframe_every);
+  if (key) {
+    s->keyframe_id = s->has_ref ? s->keyframe_id + 1 : 0;
+    s->since_keyframe = 0;
+  }
+  s->since_keyframe += 1;
+
+  out[0] = 'M';
+  out[1] = 'S';
+  out[2] = MJWF_SNAPSHOT_VERSION;
+  out[3] = key ? MJWF_SNAPSHOT_KEYFRAME : 0;
+  mjwf_put_u32(out + 4, s->hash);
+  mjwf_put_u32(out + 8, s->keyframe_id);
+  mjwf_put_u32(out + 12, s->seq++);
+  memcpy(out + 16, &d->time, sizeof(double));
+
+  unsigned char* p = out + MJWF_SNAPSHOT_HEADER;
+  uint64_t zeros = 0;
+  int k = 0;
+  for (int f = 0; f < s->nfield; ++f) {
+    double* v = s->values + k;
+    _mjwf_view_read_f64(m, d, s->view[f], 0, s->size[f], v);
+    const double quantum = s->quantum[f];
+    for (int i = 0; i < s->size[f]; ++i, ++k) {
+      uint64_t code;
+      if (quantum > 0) {
+        const int64_t q = mjwf_quantize(v[i], quantum);
+        const int64_t delta = key ? q : q - (int64_t)s->ref[k];
+        if (key) s->ref[k] = (uint64_t)q;
+        code = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+      } else {
+        const uint64_t bits = mjwf_bits(v[i]);
+        code = key ? bits : bits ^ s->ref[k];
+        if (key) s->ref[k] = bits;
+      }
+      if (code == 0) {
+        zeros += 1;
+        continue;
+      }
+      if (zeros) {
+        *p++ = 0;
+        p += mjwf_put_varint(p, zeros - 1);
+        zeros = 0;
+      }
+      p += mjwf_put_varint(p, code);
+    }
+  }
+  if (zeros) {
+    *p++ = 0;
+    p += mjwf_put_varint(p, zeros - 1);
+  }
+  s->has_ref = 1;
+  return (int)(p - out);
+}
+
+static void mjwf_snapshot_store(void* dst, int dtype, int i, double x) {
+  switch (dtype) {
+    case MJWF_DTYPE_F64: ((double*)dst)[i] = x; break;
+    case MJWF_DTYPE_F32: ((float*)dst)[i] = (float)x; break;
+    default:             ((int32_t*)dst)[i] = (int32_t)x; break;
+  }
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_snapshot_apply(int h, const unsigned char* in, int n, int flags) {
+  mjwf_snapshot* s = mjwf_snapshot_of(h);
+  if (!s) return 0;
+  if (!in || n < MJWF_SNAPSHOT_HEADER || in[0] != 'M' || in[1] != 'S' || in[2] != MJWF_SNAPSHOT_VERSION ||
+      mjwf_get_u32(in + 4) != s->hash) {
+    _mjwf_set_error(h, 172, "snapshot_apply: not a snapshot for this field set");
+    return 0;
+  }
+  const int key = (in[3] & MJWF_SNAPSHOT_KEYFRAME) != 0;
+  const uint32_t keyframe_id = mjwf_get_u32(in + 8);
+  if (!key && (!s->has_ref || keyframe_id != s->keyframe_id)) {
+    _mjwf_set_error(h, 173, "snapshot_apply: delta refers to a keyframe this handle has not seen");
+    return 0;
+  }
+
+  // Decode into scratch first so a truncated packet leaves the handle as it was.
+  const unsigned char* p = in + MJWF_SNAPSHOT_HEADER;
+  const unsigned char* end = in + n;
+  uint64_t zeros = 0;
+  for (int k = 0; k < s->nvalue; ++k) {
+    if (zeros) {
+      s->codes[k] = 0;
+      zeros -= 1;
+      continue;
+    }
+    const int used = mjwf_get_varint(p, end, &s->codes[k]);
+    const int run = (used && s->codes[k] == 0) ? mjwf_get_varint(p + used, end, &zeros) : 1;
+    if (!used || !run) {
+      _mjwf_set_error(h, 172, "snapshot_apply: truncated packet");
+      return 0;
+    }
+    p += used + (s->codes[k] == 0 ? run : 0);
+  }
+  if (zeros || p != end) {
+    _mjwf_set_error(h, 172, "snapshot_apply: packet length does not match the field set");
+    return 0;
+  }
+
+  int k = 0;
+  for (int f = 0; f < s->nfield; ++f) {
+    const double quantum = s->quantum[f];
+    void* dst = _mjwf_view_writable_addr(h, s->view[f]);
+    const int dtype = mjwf_view_dtype(s->view[f]);
+    for (int i = 0; i < s->size[f]; ++i, ++k) {
+      const uint64_t code = s->codes[k];
+      double x;
+      if (quantum > 0) {
+        const int64_t delta = (int64_t)(code >> 1) ^ -(int64_t)(code & 1);
+        const int64_t q = key ? delta : (int64_t)s->ref[k] + delta;
+        if (key) s->ref[k] = (uint64_t)q;
+        x = (double)q * quantum;
+      } else {
+        const uint64_t bits = key ? code : code ^ s->ref[k];
+        if (key) s->ref[k] = bits;
+        memcpy(&x, &bits, sizeof(x));
+      }
+      if (dst) mjwf_snapshot_store(dst, dtype, i, x);
+    }
+  }
+  if (key) {
+    s->keyframe_id = keyframe_id;
+    s->has_ref = 1;
+  }
+  mjData* d = _mjwf_data_of(h);
+  memcpy(&d->time, in + 16, sizeof(double));
+  if (flags & MJWF_SNAPSHOT_KINEMATICS) mj_kinematics(_mjwf_model_of(h), d);
+  return 1;
+}
@@ -0,0 +1,335 @@
+// Auto-resetting vector environments for MuJoCo WASM 3.3.7
+// A vector env owns N mjData instances sharing one handle's model. Every step
+// applies actions, advances frame_skip physics steps per env, checks the time
+// limit and done predicates, resets finished envs (handle state at creation +
+// per-env RNG noise) and writes observations, done codes and episode stats.
+//
+// Observations follow a layout from codegen/spec_*.yaml (obs_layouts), packed
+// N x mjwf_vecenv_obs_dim(e) as doubles. They (and predicates) read the data
+// as mj_step leaves it: qpos/qvel are post-step, sensors from the last forward.
+// done[i]: 0 running, MJWF_DONE_TERMINATED (predicate), MJWF_DONE_TRUNCATED
+// (time limit); a finished env is already reset, so obs holds the first
+// observation of its next episode and final_obs (optional) the last one.
+// stats is N x MJWF_VECENV_NSTAT int32: finished episodes, steps in the
+// current episode, length of the last finished episode.
+//
+// RNG: splitmix64 per env, seeded from (seed, env index), so noise sequences
+// are reproducible and independent of the worker split.
+
+#include <mujoco/mujoco.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mjwf_exports.h"
+#include "mjwf_exports_generated.h"
+#include "mjwf_internal.h"
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#else
+#ifndef EMSCRIPTEN_KEEPALIVE
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#endif
+
+#ifndef MJWF_VECENV_MAX
+#define MJWF_VECENV_MAX     8     // raised by the MEMORY64 bundle
+#endif
+#define MJWF_VECENV_MAXN    4096
+#define MJWF_VECENV_MAXPRED 8
+
+typedef struct {
+  int view;
+  int index;
+  int op;
+  double value;
+} mjwf_done_pred;
+
+typedef struct {
+  int used;
+  int h;
+  const mjModel* m;   // the handle's model at creation, checked on every call
+  int generation;     // ... together with its generation (in-place recompiles)
+  int n;
+  int layout;
+  int obsdim;
+  mjData** d;
+  mjtNum* base;       // handle state at creation, mjSTATE_INTEGRATION
+  uint64_t* rng;
+  double* t0;         // episode start time per env
+  int32_t* stats;     // n x MJWF_VECENV_NSTAT
+  uint32_t seed;
+  double time_limit;  // seconds of sim time, 0 = none
+  int frame_skip;
+  double qpos_noise;
+  double qvel_noise;
+  mjwf_done_pred pred[MJWF_VECENV_MAXPRED];
+  int npred;
+} mjwf_vecenv;
+
+static mjwf_vecenv g_envs[MJWF_VECENV_MAX + 1];  // id 0 unused
+
+static mjwf_vecenv* mjwf_vecenv_get(int e) {
+  if (e <= 0 || e > MJWF_VECENV_MAX || !g_envs[e].used) return NULL;
+  mjwf_vecenv* E = &g_envs[e];
+  if (!mjwf_valid(E->h) || _mjwf_model_of(E->h) != E->m ||
+      _mjwf_model_generation(E->h) != E->generation) {
+    _mjwf_set_global_error(100, "vecenv: handle was freed or replaced");
+    return NULL;
+  }
+  return E;
+}
+
+static uint64_t mjwf_splitmix64(uint64_t* s) {
+  uint64_t z = (*s += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+// Uniform in [-1, 1).
+static double mjwf_vecenv_uniform(uint64_t* s) {
+  return 2.0 * (double)(mjwf_splitmix64(s) >> 11) * (1.0 / 9007199254740992.0) - 1.0;
+}
+
+static void mjwf_vecenv_seed_all(mjwf_vecenv* E) {
+  for (int i = 0; i < E->n; ++i) {
+    E->rng[i] = ((uint64_t)E->seed << 32) ^ (uint64_t)i;
+    mjwf_splitmix64(&E->rng[i]);
+  }
+}
+
+static void mjwf_vecenv_release(mjwf_vecenv* E) {
+  if (E->d) {
+    for (int i = 0; i < E->n; ++i) {
+      if (E->d[i]) mj_deleteData(E->d[i]);
+    }
+  }
+  free(E->d);
+  free(E->base);
+  free(E->rng);
+  free(E->t0);
+  free(E->stats);
+  memset(E, 0, sizeof(*E));
+}
+
+static void mjwf_vecenv_obs(const mjwf_vecenv* E, mjData* d, double* out) {
+  int nfield = 0;
+  const _mjwf_obs_field* f = _mjwf_obs_layout(E->layout, &nfield);
+  for (int i = 0; i < nfield; ++i) {
+    out += _mjwf_view_read_f64(E->m, d, f[i].view, f[i].offset, f[i].count, out);
+  }
+}
+
+static void mjwf_vecenv_reset_one(mjwf_vecenv* E, int i) {
+  const mjModel* m = E->m;
+  mjData* d = E->d[i];
+  mj_setState(m, d, E->base, mjSTATE_INTEGRATION);
+  if (E->qpos_noise > 0) {
+    for (int j = 0; j < m->nq; ++j) d->qpos[j] += E->qpos_noise * mjwf_vecenv_uniform(&E->rng[i]);
+    mj_normalizeQuat(m, d->qpos);
+  }
+  if (E->qvel_noise > 0) {
+    for (int j = 0; j < m->nv; ++j) d->qvel[j] += E->qvel_noise * mjwf_vecenv_uniform(&E->rng[i]);
+  }
+  mj_forward(m, d);
+  E->t0[i] = d->time;
+  E->stats[MJWF_VECENV_NSTAT * i + 1] = 0;
+}
+
+static int mjwf_vecenv_check(const mjwf_vecenv* E, int i) {
+  mjData* d = E->d[i];
+  for (int p = 0; p < E->npred; ++p) {
+    const mjwf_done_pred* P = &E->pred[p];
+    double v = 0;
+    if (_mjwf_view_read_f64(E->m, d, P->view, P->index, 1, &v) != 1) continue;
+    const int hit = (P->op == MJWF_DONE_LT && v < P->value) ||
+                    (P->op == MJWF_DONE_GT && v > P->value) ||
+                    (P->op == MJWF_DONE_ABS_GT && fabs(v) > P->value) ||
+                    v != v;  // NaN always ends the episode
+    if (hit) return MJWF_DONE_TERMINATED;
+  }
+  if (E->time_limit > 0 && d->time - E->t0[i] >= E->time_limit - 0.5 * E->m->opt.timestep) {
+    return MJWF_DONE_TRUNCATED;
+  }
+  return 0;
+}
+
+typedef struct {
+  mjwf_vecenv* E;
+  const double* actions;
+  double* obs;
+  double* final_obs;
+  unsigned char* done;
+} mjwf_vecenv_job;
+
+static void mjwf_vecenv_step_range(void* ctx, int worker, int begin, int end) {
+  const mjwf_vecenv_job* job = (const mjwf_vecenv_job*)ctx;
+  mjwf_vecenv* E = job->E;
+  const mjModel* m = E->m;
+  (void)worker;
+  for (int i = begin; i < end; ++i) {
+    mjData* d = E->d[i];
+    if (job->actions && m->nu) {
+      memcpy(d->ctrl, job->actions + (size_t)i * m->nu, sizeof(double) * m->nu);
+    }
+    for (int s = 0; s < E->frame_skip; ++s) mj_step(m, d);
+    int32_t* st = E->stats + MJWF_VECENV_NSTAT * i;
+    st[1] += 1;
+    const int done = mjwf_vecenv_check(E, i);
+    if (done) {
+      if (job->final_obs) mjwf_vecenv_obs(E, d, job->final_obs + (size_t)i * E->obsdim);
+      st[0] += 1;
+      st[2] = st[1];
+      mjwf_vecenv_reset_one(E, i);
+    }
+    if (job->done) job->done[i] = (unsigned char)done;
+    if (job->obs) mjwf_vecenv_obs(E, d, job->obs + (size_t)i * E->obsdim);
+  }
+}
+
+static void mjwf_vecenv_reset_range(void* ctx, int worker, int begin, int end) {
+  const mjwf_vecenv_job* job = (const mjwf_vecenv_job*)ctx;
+  (void)worker;
+  for (int i = begin; i < end; ++i) {
+    mjwf_vecenv_reset_one(job->E, i);
+    if (job->obs) mjwf_vecenv_obs(job->E, job->E->d[i], job->obs + (size_t)i * job->E->obsdim);
+  }
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_vecenv_create(int h, int n, int layout) {
+  if (!mjwf_valid(h)) return 0;
+  if (n <= 0 || n > MJWF_VECENV_MAXN || layout < 0 || layout >= MJWF_OBS_COUNT) {
+    _mjwf_set_error(h, 101, "vecenv: bad size or observation layout");
+    return 0;
+  }
+  int e = 1;
+  while (e <= MJWF_VECENV_MAX && g_envs[e].used) ++e;
+  if (e > MJWF_VECENV_MAX) {
+    _mjwf_set_error(h, 102, "vecenv: no free slots");
+    return 0;
+  }
+  mjwf_vecenv* E = &g_envs[e];
+  const mjModel* m = _mjwf_model_of(h);
+  E->used = 1;
+  E->h = h;
+  E->m = m;
+  E->generation = _mjwf_model_generation(h);
+  E->n = n;
+  E->layout = layout;
+  E->obsdim = mjwf_obs_layout_dim(h, layout);
+  E->frame_skip = 1;
+  E->d = (mjData**)calloc(n, sizeof(mjData*));
+  E->base = (mjtNum*)malloc(sizeof(mjtNum) * mj_stateSize(m, mjSTATE_INTEGRATION));
+  E->rng = (uint64_t*)malloc(sizeof(uint64_t) * n);
+  E->t0 = (double*)malloc(sizeof(double) * n);
+  E->stats = (int32_t*)calloc((size_t)n * MJWF_VECENV_NSTAT, sizeof(int32_t));
+  int ok = E->d && E->base && E->rng && E->t0 && E->stats;
+  for (int i = 0; ok && i < n; ++i) ok = (E->d[i] = mj_makeData(m)) != NULL;
+  if (!ok) {
+    mjwf_vecenv_release(E);
+    _mjwf_set_error(h, 103, "vecenv: allocation failed");
+    return 0;
+  }
+  mj_getState(m, _mjwf_data_of(h), E->base, mjSTATE_INTEGRATION);
+  mjwf_vecenv_seed_all(E);
+  for (int i = 0; i < n; ++i) mjwf_vecenv_reset_one(E, i);
+  return e;
+}
+
+EMSCRIPTEN_KEEPALIVE void mjwf_vecenv_free(int e) {
+  if (e <= 0 || e > MJWF_VECENV_MAX || !g_envs[e].used) return;
+  mjwf_vecenv_release(&g_envs[e]);
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_vecenv_size(int e) {
+  const mjwf_vecenv* E = mjwf_vecenv_get(e);
+  return E ? E->n : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_vecenv_obs_dim(int e) {
+  const mjwf_vecenv* E = mjwf_vecenv_get(e);
+  return E ? E->obsdim : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_vecenv_set_time_limit(int e, double seconds) {
+  mjwf_vecenv* E = mjwf_vecenv_get(e);
+  if (!E) return 0;
+  E->time_limit = seconds > 0 ? seconds : 0;
+  return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_vecenv_set_frame_skip(int e, int n) {
+  mjwf_vecenv* E = mjwf_vecenv_get(e);
+  if (!E) return 0;
+  E->frame_skip = n > 0 ? n : 1;
+  return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_vecenv_set_noise(int e, double qpos_scale, double qvel_scale) {
+  mjwf_vecenv* E = mjwf_vecenv_get(e);
+  if (!E) return 0;
+  E->qpos_noise = qpos_scale;
+  E->qvel_noise = qvel_scale;
+  return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_vecenv_seed(int e, uint32_t seed) {
+  mjwf_vecenv* E = mjwf_vecenv_get(e);
+  if (!E) return 0;
+  E->seed = seed;
+  mjwf_vecenv_seed_all(E);
+  return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_vecenv_add_done_if(int e, int view, int index, int op, double value) {
+  mjwf_vecenv* E = mjwf_vecenv_get(e);
+  if (!E) return 0;
+  if (E->npred >= MJWF_VECENV_MAXPRED || index < 0 || index >= _mjwf_view_size(E->m, view) ||
+      op < MJWF_DONE_LT || op > MJWF_DONE_ABS_GT) {
+    _mjwf_set_error(E->h, 104, "vecenv: bad done predicate");
+    return 0;
+  }
+  mjwf_done_pred* P = &E->pred[E->npred++];
+  P->view = view;
+  P->index = index;
+  P->op = op;
+  P->value = value;
+  return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_vecenv_clear_done_if(int e) {
+  mjwf_vecenv* E = mjwf_vecenv_get(e);
+  if (!E) return 0;
+  E->npred = 0;
+  return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_vecenv_reset(int e, double* obs) {
+  mjwf_vecenv* E = mjwf_vecenv_get(e);
+  if (!E) return 0;
+  memset(E->stats, 0, sizeof(int32_t) * MJWF_VECENV_NSTAT * E->n);
+  mjwf_vecenv_seed_all(E);
+  mjwf_vecenv_job job = {0};
+  job.E = E;
+  job.obs = obs;
+  _mjwf_parallel_for(E->n, _mjwf_worker_count(E->n), mjwf_vecenv_reset_range, &job);
+  return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_vecenv_step(int e, const double* actions, double* obs, unsigned char* done,
+                                          int32_t* stats, double* final_obs) {
+  mjwf_vecenv* E = mjwf_vecenv_get(e);
+  if (!E) return 0;
+  mjwf_vecenv_job job = {0};
+  job.E = E;
+  job.actions = actions;
+  job.obs = obs;
+  job.final_obs = final_obs;
+  job.done = done;
+  _mjwf_parallel_for(E->n, _mjwf_worker_count(E->n), mjwf_vecenv_step_range, &job);
+  if (stats) memcpy(stats, E->stats, sizeof(int32_t) * MJWF_VECENV_NSTAT * E->n);
+  return 1;
+}
@@ -1,5 +1,5 @@
 #!/usr/bin/env python3
-import sys, os, yaml
+import re, sys, os, yaml
 
 HDR_PREAMBLE = """
 // AUTO-GENERATED. Do not edit by hand. See codegen/spec_337.yaml
@@ -27,6 +27,7 @@ SRC_PREAMBLE = """
 // AUTO-GENERATED. Do not edit by hand. See codegen/spec_337.yaml
 #include <mujoco/mujoco.h>
 #include <stddef.h>
+#include <string.h>
 #if defined(__EMSCRIPTEN__)
 #include <emscripten/emscripten.h>
 #else
@@ -47,6 +48,8 @@ typedef struct { mjModel* m; mjData* d; } _mjwf_view_pair;
 // Getters implemented in mjwf_handles.c
 extern mjModel* _mjwf_model_of(int h);
 extern mjData*  _mjwf_data_of(int h);
+// Copy-on-write model arrays (mjwf_overlay.c)
+extern void* _mjwf_overlay_acquire(int h, int id);
 """.lstrip()
 
 def _ctype_for(dtype: str) -> str:
@@ -66,6 +69,22 @@ def emit_view_decl(name, dtype):
 def emit_dim_decl(name):
     return f"EMSCRIPTEN_KEEPALIVE int mjwf_{name}(int h);\n"
 
+def _check_overlay(v):
+    if not v.get('overlay'):
+        return False
+    if not str(v['src']).strip().startswith('m->') or v['dtype'] != 'f64' or str(v.get('rw')) != 'rw':
+        raise SystemExit(f"view {v['name']}: overlay views must be writable model-side f64")
+    return True
+
+def emit_overlay_view_impl(name, dtype):
+    cty = _ctype_for(dtype)
+    return (
+        f"EMSCRIPTEN_KEEPALIVE {cty} mjwf_{name}_ptr(int h) {{\n"
+        f"  // Taking the pointer counts as a write: the handle gets its own copy.\n"
+        f"  return ({cty})_mjwf_overlay_acquire(h, {_view_enum(name)});\n"
+        f"}}\n\n"
+    )
+
 def emit_view_impl(name, src, dtype):
     cty = _ctype_for(dtype)
     # pick guard based on src owner (m-> or d->)
@@ -79,6 +98,206 @@ def emit_view_impl(name, src, dtype):
         f"}}\n\n"
     )
 
+_DTYPE_ENUM = {'f64': 'MJWF_DTYPE_F64', 'f32': 'MJWF_DTYPE_F32', 'i32': 'MJWF_DTYPE_I32'}
+
+def _view_enum(name):
+    return f"MJWF_VIEW_{name.upper()}"
+
+# Model counts a view length can be expressed in ("m->nbody*3" = extent nbody,
+# row 3). Anything else maps to MJWF_EXTENT_OTHER.
+_EXTENTS = ['nq', 'nv', 'nu', 'na', 'nbody', 'njnt', 'ngeom', 'nsite', 'nmat', 'nsensordata']
+
+def _view_extent(v):
+    m = re.fullmatch(r'\s*m->(\w+)\s*(?:\*\s*(\w+)\s*)?', str(v['len']))
+    if not m or m.group(1) not in _EXTENTS:
+        return 'MJWF_EXTENT_OTHER', '1'
+    return f"MJWF_EXTENT_{m.group(1).upper()}", m.group(2) or '1'
+
+def emit_view_table_decl(views):
+    out = ["// View table: ids follow spec order and are stable within a layout hash.\n"]
+    out.append("enum { MJWF_DTYPE_F64 = 0, MJWF_DTYPE_F32 = 1, MJWF_DTYPE_I32 = 2 };\n")
+    out.append("enum {\n")
+    for i, v in enumerate(views):
+        out.append(f"  {_view_enum(v['name'])} = {i},\n")
+    out.append(f"  MJWF_VIEW_COUNT = {len(views)}\n}};\n")
+    out.append("// View extents: the model count a view's length is a multiple of.\n")
+    out.append("enum {\n")
+    for i, e in enumerate(_EXTENTS):
+        out.append(f"  MJWF_EXTENT_{e.upper()} = {i},\n")
+    out.append(f"  MJWF_EXTENT_OTHER = {len(_EXTENTS)}\n}};\n")
+    out.append("EMSCRIPTEN_KEEPALIVE int mjwf_view_count(void);\n")
+    out.append("EMSCRIPTEN_KEEPALIVE int mjwf_view_id(const char* name);\n")
+    out.append("EMSCRIPTEN_KEEPALIVE const char* mjwf_view_name(int id);\n")
+    out.append("EMSCRIPTEN_KEEPALIVE int mjwf_view_dtype(int id);\n")
+    out.append("EMSCRIPTEN_KEEPALIVE int mjwf_view_writable(int id);\n")
+    out.append("EMSCRIPTEN_KEEPALIVE int mjwf_view_len(int h, int id);\n")
+    out.append("EMSCRIPTEN_KEEPALIVE const void* mjwf_view_addr(int h, int id);\n")
+    return ''.join(out)
+
+def emit_view_table_impl(views):
+    out = ["typedef struct { const char* name; int dtype; int rw; int overlay; int model; } _mjwf_view_desc;\n\n"]
+    out.append("static const _mjwf_view_desc _mjwf_views[MJWF_VIEW_COUNT] = {\n")
+    for v in views:
+        rw = 1 if str(v.get('rw', 'ro')) == 'rw' else 0
+        ov = 1 if _check_overlay(v) else 0
+        mo = 0 if str(v['src']).strip().startswith('d->') else 1
+        out.append(f"  {{\"{v['name']}\", {_DTYPE_ENUM.get(v['dtype'], 'MJWF_DTYPE_I32')}, {rw}, {ov}, {mo}}},\n")
+    out.append("};\n\n")
+
+    out.append("int _mjwf_view_is_overlay(int id) {\n")
+    out.append("  return (id >= 0 && id < MJWF_VIEW_COUNT) ? _mjwf_views[id].overlay : 0;\n}\n\n")
+    out.append("int _mjwf_view_is_model(int id) {\n")
+    out.append("  return (id >= 0 && id < MJWF_VIEW_COUNT) ? _mjwf_views[id].model : 0;\n}\n\n")
+    out.append("void** _mjwf_view_model_slot(mjModel* m, int id) {\n")
+    out.append("  if (!m) return NULL;\n")
+    out.append("  switch (id) {\n")
+    for v in views:
+        if _check_overlay(v):
+            out.append(f"    case {_view_enum(v['name'])}: return (void**)&({str(v['src']).strip()});\n")
+    out.append("    default: return NULL;\n  }\n}\n\n")
+
+    out.append("void* _mjwf_view_addr(const mjModel* m, mjData* d, int id) {\n")
+    out.append("  switch (id) {\n")
+    for v in views:
+        src = str(v['src']).strip()
+        owner = 'd' if src.startswith('d->') else 'm'
+        out.append(f"    case {_view_enum(v['name'])}: return {owner} ? (void*)({src}) : NULL;\n")
+    out.append("    default: return NULL;\n  }\n}\n\n")
+
+    out.append("int _mjwf_view_size(const mjModel* m, int id) {\n")
+    out.append("  if (!m) return 0;\n")
+    out.append("  switch (id) {\n")
+    for v in views:
+        out.append(f"    case {_view_enum(v['name'])}: return (int)({v['len']});\n")
+    out.append("    default: return 0;\n  }\n}\n\n")
+
+    out.append("int _mjwf_view_extent(int id, int* row) {\n")
+    out.append("  switch (id) {\n")
+    for v in views:
+        extent, row = _view_extent(v)
+        out.append(f"    case {_view_enum(v['name'])}: if (row) *row = {row}; return {extent};\n")
+    out.append("    default: if (row) *row = 0; return MJWF_EXTENT_OTHER;\n  }\n}\n\n")
+
+    out.append("int _mjwf_view_elem_bytes(int id) {\n")
+    out.append("  if (id < 0 || id >= MJWF_VIEW_COUNT) return 0;\n")
+    out.append("  return _mjwf_views[id].dtype == MJWF_DTYPE_F64 ? 8 : 4;\n}\n\n")
+
+    out.append("int _mjwf_view_read_f64(const mjModel* m, mjData* d, int id, int offset, int count, double* out) {\n")
+    out.append("  const void* src = _mjwf_view_addr(m, d, id);\n")
+    out.append("  const int size = _mjwf_view_size(m, id);\n")
+    out.append("  if (offset < 0 || offset > size) return 0;\n")
+    out.append("  if (count < 0 || count > size - offset) count = size - offset;\n")
+    out.append("  if (!src || count <= 0) return 0;\n")
+    out.append("  switch (_mjwf_views[id].dtype) {\n")
+    out.append("    case MJWF_DTYPE_F64: memcpy(out, (const double*)src + offset, sizeof(double) * count); break;\n")
+    out.append("    case MJWF_DTYPE_F32: for (int i = 0; i < count; ++i) out[i] = ((const float*)src)[offset + i]; break;\n")
+    out.append("    default: for (int i = 0; i < count; ++i) out[i] = ((const int32_t*)src)[offset + i]; break;\n")
+    out.append("  }\n  return count;\n}\n\n")
+
+    out.append("EMSCRIPTEN_KEEPALIVE int mjwf_view_count(void) { return MJWF_VIEW_COUNT; }\n\n")
+    out.append("EMSCRIPTEN_KEEPALIVE int mjwf_view_id(const char* name) {\n")
+    out.append("  if (!name) return -1;\n")
+    out.append("  for (int i = 0; i < MJWF_VIEW_COUNT; ++i) {\n")
+    out.append("    if (strcmp(_mjwf_views[i].name, name) == 0) return i;\n  }\n  return -1;\n}\n\n")
+    out.append("EMSCRIPTEN_KEEPALIVE const char* mjwf_view_name(int id) {\n")
+    out.append("  return (id >= 0 && id < MJWF_VIEW_COUNT) ? _mjwf_views[id].name : NULL;\n}\n\n")
+    out.append("EMSCRIPTEN_KEEPALIVE int mjwf_view_dtype(int id) {\n")
+    out.append("  return (id >= 0 && id < MJWF_VIEW_COUNT) ? _mjwf_views[id].dtype : -1;\n}\n\n")
+    out.append("EMSCRIPTEN_KEEPALIVE int mjwf_view_writable(int id) {\n")
+    out.append("  return (id >= 0 && id < MJWF_VIEW_COUNT) ? _mjwf_views[id].rw : 0;\n}\n\n")
+    out.append("EMSCRIPTEN_KEEPALIVE int mjwf_view_len(int h, int id) {\n")
+    out.append("  if (!mjwf_valid(h)) return 0;\n")
+    out.append("  return _mjwf_view_size(_mjwf_model_of(h), id);\n}\n\n")
+    # Read-only address: unlike mjwf_<name>_ptr it never acquires an overlay,
+    # so a shared handle keeps reading the base model until it writes.
+    out.append("EMSCRIPTEN_KEEPALIVE const void* mjwf_view_addr(int h, int id) {\n")
+    out.append("  if (!mjwf_valid(h)) return NULL;\n")
+    out.append("  return _mjwf_view_addr(_mjwf_model_of(h), _mjwf_data_of(h), id);\n}\n\n")
+    return ''.join(out)
+
+def _obs_enum(name):
+    return f"MJWF_OBS_{name.upper()}"
+
+def _obs_fields(layout, view_ids):
+    fields = []
+    if not layout.get('fields'):
+        raise SystemExit(f"obs layout {layout['name']}: no fields")
+    for f in layout['fields']:
+        if f['view'] not in view_ids:
+            raise SystemExit(f"obs layout {layout['name']}: unknown view {f['view']}")
+        fields.append((view_ids[f['view']], int(f.get('offset', 0)), int(f.get('count', -1))))
+    return fields
+
+def emit_obs_layout_decl(layouts):
+    out = ["// Observation layouts: ordered (view, offset, count) slices; count -1 = to end of view.\n"]
+    out.append("typedef struct { int view; int offset; int count; } _mjwf_obs_field;\n")
+    out.append("enum {\n")
+    for i, l in enumerate(layouts):
+        out.append(f"  {_obs_enum(l['name'])} = {i},\n")
+    out.append(f"  MJWF_OBS_COUNT = {len(layouts)}\n}};\n")
+    out.append("const _mjwf_obs_field* _mjwf_obs_layout(int id, int* nfield);\n")
+    out.append("EMSCRIPTEN_KEEPALIVE int mjwf_obs_layout_count(void);\n")
+    out.append("EMSCRIPTEN_KEEPALIVE int mjwf_obs_layout_id(const char* name);\n")
+    out.append("EMSCRIPTEN_KEEPALIVE int mjwf_obs_layout_dim(int h, int id);\n")
+    return ''.join(out)
+
+def emit_obs_layout_impl(layouts, views):
+    view_ids = {v['name']: _view_enum(v['name']) for v in views}
+    out = []
+    for l in layouts:
+        fields = _obs_fields(l, view_ids)
+        out.append(f"static const _mjwf_obs_field _mjwf_obs_{l['name']}[] = {{\n")
+        for view, offset, count in fields:
+            out.append(f"  {{{view}, {offset}, {count}}},\n")
+        out.append("};\n")
+    out.append("\nstatic const struct { const char* name; const _mjwf_obs_field* fields; int nfield; } _mjwf_obs[] = {\n")
+    for l in layouts:
+        out.append(f"  {{\"{l['name']}\", _mjwf_obs_{l['name']}, {len(l['fields'])}}},\n")
+    if not layouts:
+        out.append("  {NULL, NULL, 0},\n")
+    out.append("};\n\n")
+    out.append("const _mjwf_obs_field* _mjwf_obs_layout(int id, int* nfield) {\n")
+    out.append("  if (id < 0 || id >= MJWF_OBS_COUNT) return NULL;\n")
+    out.append("  if (nfield) *nfield = _mjwf_obs[id].nfield;\n")
+    out.append("  return _mjwf_obs[id].fields;\n}\n\n")
+    out.append("EMSCRIPTEN_KEEPALIVE int mjwf_obs_layout_count(void) { return MJWF_OBS_COUNT; }\n\n")
+    out.append("EMSCRIPTEN_KEEPALIVE int mjwf_obs_layout_id(const char* name) {\n")
+    out.append("  if (!name) return -1;\n")
+    out.append("  for (int i = 0; i < MJWF_OBS_COUNT; ++i) {\n")
+    out.append("    if (strcmp(_mjwf_obs[i].name, name) == 0) return i;\n  }\n  return -1;\n}\n\n")
+    out.append("EMSCRIPTEN_KEEPALIVE int mjwf_obs_layout_dim(int h, int id) {\n")
+    out.append("  if (!mjwf_valid(h) || id < 0 || id >= MJWF_OBS_COUNT) return 0;\n")
+    out.append("  const mjModel* m = _mjwf_model_of(h);\n")
+    out.append("  int dim = 0;\n")
+    out.append("  for (int i = 0; i < _mjwf_obs[id].nfield; ++i) {\n")
+    out.append("    const _mjwf_obs_field* f = &_mjwf_obs[id].fields[i];\n")
+    out.append("    const int size = _mjwf_view_size(m, f->view);\n")
+    out.append("    const int off = f->offset < size ? f->offset : size;\n")
+    out.append("    dim += (f->count < 0 || f->count > size - off) ? size - off : f->count;\n")
+    out.append("  }\n  return dim;\n}\n\n")
+    return ''.join(out)
+
+def emit_dts(views, dims, memory64):
+    # Raw wasmExports signatures of the view getters and the view table.
+    out = ["// AUTO-GENERATED. Do not edit by hand. See codegen/spec_337.yaml\n"]
+    out.append(f"// {'wasm64' if memory64 else 'wasm32'} bundle: view pointers are {'bigint' if memory64 else 'numbers'}.\n")
+    out.append(f"export type Ptr = {'bigint' if memory64 else 'number'};\n")
+    out.append("export interface MJWFViewExports {\n")
+    for v in views:
+        out.append(f"  mjwf_{v['name']}_ptr(h: number): Ptr;\n")
+    for d in dims:
+        k, _ = list(d.items())[0]
+        out.append(f"  mjwf_{k}(h: number): number;\n")
+    out.append("  mjwf_view_count(): number;\n")
+    out.append("  mjwf_view_id(name: Ptr): number;\n")
+    out.append("  mjwf_view_name(id: number): Ptr;\n")
+    out.append("  mjwf_view_dtype(id: number): number;\n")
+    out.append("  mjwf_view_writable(id: number): number;\n")
+    out.append("  mjwf_view_len(h: number, id: number): number;\n")
+    out.append("  mjwf_view_addr(h: number, id: number): Ptr;\n")
+    out.append("}\n")
+    return ''.join(out)
+
 def emit_dim_impl(name, expr):
     return (
         f"EMSCRIPTEN_KEEPALIVE int mjwf_{name}(int h) {{\n"
@@ -89,13 +308,16 @@ def emit_dim_impl(name, expr):
     )
 
 def main():
-    if len(sys.argv) != 4:
-        print("Usage: gen_exports.py <spec.yaml> <out.h> <out.c>")
+    args = [a for a in sys.argv[1:] if a != '--memory64']
+    memory64 = len(args) != len(sys.argv) - 1
+    if len(args) not in (3, 4):
+        print("Usage: gen_exports.py <spec.yaml> <out.h> <out.c> [<out.d.ts>] [--memory64]")
         return 2
-    spec_path, out_h, out_c = sys.argv[1:]
+    spec_path, out_h, out_c = args[:3]
     spec = yaml.safe_load(open(spec_path, 'r', encoding='utf-8'))
     views = spec.get('views', [])
     dims  = spec.get('dims', [])
+    layouts = spec.get('obs_layouts', [])
 
     # Header
     with open(out_h, 'w', encoding='utf-8') as fh:
@@ -105,16 +327,28 @@ def main():
         for d in dims:
             k, v = list(d.items())[0]
             fh.write(emit_dim_decl(k))
+        fh.write(emit_view_table_decl(views))
+        fh.write(emit_obs_layout_decl(layouts))
         fh.write(HDR_POST)
 
     # Source
     with open(out_c, 'w', encoding='utf-8') as fc:
         fc.write(SRC_PREAMBLE)
+        fc.write(f'#include "{os.path.basename(out_h)}"\n\n')
         for v in views:
-            fc.write(emit_view_impl(v['name'], v['src'], v['dtype']))
+            if _check_overlay(v):
+                fc.write(emit_overlay_view_impl(v['name'], v['dtype']))
+            else:
+                fc.write(emit_view_impl(v['name'], v['src'], v['dtype']))
         for d in dims:
             k, v = list(d.items())[0]
             fc.write(emit_dim_impl(k, v))
+        fc.write(emit_view_table_impl(views))
+        fc.write(emit_obs_layout_impl(layouts, views))
+
+    if len(args) == 4:
+        with open(args[3], 'w', encoding='utf-8') as fd:
+            fd.write(emit_dts(views, dims, memory64))
 
 if __name__ == '__main__':
     sys.exit(main())
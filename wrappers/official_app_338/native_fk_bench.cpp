@@ -0,0 +1,86 @@
+// Native counterpart of scripts/bench/fk.mjs: batched FK throughput through the
+// mjwf handle layer, printed as one JSON line with the same keys.
+// Usage: mjwf_fk_bench338 <model.xml> [configs] [threads]
+
+#include <mujoco/mujoco.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "mjwf_exports.h"
+
+static volatile double g_sink;  // keeps the mj_forward baseline observable
+
+static double now_ms() {
+  using clock = std::chrono::steady_clock;
+  return std::chrono::duration<double, std::milli>(clock::now().time_since_epoch()).count();
+}
+
+template <typename F>
+static double time_ms(F fn, int reps = 3) {
+  fn();
+  const double t0 = now_ms();
+  for (int r = 0; r < reps; ++r) fn();
+  return (now_ms() - t0) / reps;
+}
+
+int main(int argc, char** argv) {
+  const char* xmlpath = argc > 1 ? argv[1] : nullptr;
+  const int K = argc > 2 ? std::atoi(argv[2]) : 4096;
+  const int threads = argc > 3 ? std::atoi(argv[3]) : 1;
+  if (!xmlpath || K <= 0) {
+    std::fprintf(stderr, "Usage: %s <model.xml> [configs] [threads]\n", argv[0]);
+    return 2;
+  }
+  const int h = mjwf_make_from_xml(xmlpath);
+  if (h <= 0) {
+    std::fprintf(stderr, "make_from_xml failed: %s\n", mjwf_errmsg_last_global());
+    return 2;
+  }
+  const int used = mjwf_set_threads(threads);
+  const mjModel* m = reinterpret_cast<const mjModel*>(mjwf_model_ptr(h));
+  mjData* d = reinterpret_cast<mjData*>(mjwf_data_ptr(h));
+
+  // Every site (or every body when there are none), random configurations
+  // around qpos0 with normalized quaternions.
+  std::vector<int> objs;
+  if (m->nsite) {
+    for (int i = 0; i < m->nsite; ++i) objs.insert(objs.end(), {mjOBJ_SITE, i});
+  } else {
+    for (int i = 1; i < m->nbody; ++i) objs.insert(objs.end(), {mjOBJ_BODY, i});
+  }
+  const int nobj = static_cast<int>(objs.size() / 2);
+  std::vector<double> qpos(static_cast<size_t>(K) * m->nq);
+  unsigned seed = 11;
+  for (int k = 0; k < K; ++k) {
+    double* q = qpos.data() + static_cast<size_t>(k) * m->nq;
+    for (int i = 0; i < m->nq; ++i) {
+      seed = seed * 1103515245u + 12345u;
+      q[i] = m->qpos0[i] + 2.0 * ((seed >> 8) / 16777216.0) - 1.0;
+    }
+    mj_normalizeQuat(m, q);
+  }
+
+  std::vector<double> pose(static_cast<size_t>(K) * nobj * mjwf_fk_stride(h, 0));
+  std::vector<double> jac(static_cast<size_t>(K) * nobj * mjwf_fk_stride(h, MJWF_FK_JACOBIAN));
+  const double t_fwd = time_ms([&] {
+    for (int k = 0; k < K; ++k) {
+      mju_copy(d->qpos, qpos.data() + static_cast<size_t>(k) * m->nq, m->nq);
+      mj_forward(m, d);
+      g_sink = m->nsite ? d->site_xpos[0] : d->xpos[3];
+    }
+  });
+  const double t_pose = time_ms([&] { mjwf_fk_batch(h, qpos.data(), K, objs.data(), nobj, 0, pose.data()); });
+  const double t_jac = time_ms([&] {
+    mjwf_fk_batch(h, qpos.data(), K, objs.data(), nobj, MJWF_FK_JACOBIAN, jac.data());
+  });
+
+  auto rate = [K](double ms) { return static_cast<long long>(K / (ms / 1000.0)); };
+  std::printf("{\"bench\":\"fk\",\"runtime\":\"native\",\"version\":\"%s\",\"configs\":%d,\"objects\":%d,"
+              "\"threads\":%d,\"forward_configs_per_s\":%lld,\"batch_configs_per_s\":%lld,"
+              "\"batch_jac_configs_per_s\":%lld}\n",
+              mjwf_version_string(), K, nobj, used, rate(t_fwd), rate(t_pose), rate(t_jac));
+  mjwf_free(h);
+  return 0;
+}
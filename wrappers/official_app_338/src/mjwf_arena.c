@@ -0,0 +1,175 @@
+// Per-handle scratch arenas and heap statistics for MuJoCo WASM 3.3.8-alpha
+// Scratch the mjwf layer needs per call (rollout base states, ...) is bump
+// allocated from the handle's arena between _mjwf_arena_mark and
+// _mjwf_arena_reset instead of malloc/free on every call. The arena grows by
+// chaining blocks; a reset back to an empty arena that had to chain merges
+// them into one block of the combined size, so steady-state calls touch the
+// allocator not at all. Buffers that live across calls and only grow (the
+// contact and ray-scan views) are per-handle slots reallocated on growth.
+// Everything is freed with the handle.
+//
+// mjwf_heap_stats reports the allocator's view of the heap; the allocator of
+// the WASM bundle is chosen at configure time (MJWF_MALLOC: dlmalloc,
+// emmalloc or mimalloc), and so is the pointer width (MJWF_MEMORY64).
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mjwf_exports.h"
+#include "mjwf_internal.h"
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#include <emscripten/heap.h>
+#include <unistd.h>
+#else
+#ifndef EMSCRIPTEN_KEEPALIVE
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#endif
+
+#if defined(MJWF_HAVE_MALLINFO) || defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#ifndef MJWF_MALLOC_NAME
+#define MJWF_MALLOC_NAME "system"
+#endif
+
+#define MJWF_ARENA_BLOCK 16384  // first block; later blocks double
+#define MJWF_ARENA_ALIGN 16
+
+typedef struct mjwf_block {
+  struct mjwf_block* prev;
+  size_t cap;
+  size_t used;
+  size_t base;  // bytes in all earlier blocks, so marks are plain offsets
+} mjwf_block;
+
+typedef struct {
+  mjwf_block* top;
+  void* buf[MJWF_NBUF];
+  size_t buf_cap[MJWF_NBUF];
+} mjwf_arena;
+
+static mjwf_arena g_arena[MJWF_MAXH];
+
+static size_t mjwf_block_header(void) {
+  return (sizeof(mjwf_block) + MJWF_ARENA_ALIGN - 1) & ~(size_t)(MJWF_ARENA_ALIGN - 1);
+}
+
+static mjwf_block* mjwf_block_new(mjwf_block* prev, size_t cap) {
+  mjwf_block* b = (mjwf_block*)malloc(mjwf_block_header() + cap);
+  if (!b) return NULL;
+  b->prev = prev;
+  b->cap = cap;
+  b->used = 0;
+  b->base = prev ? prev->base + prev->cap : 0;
+  return b;
+}
+
+static void mjwf_blocks_free(mjwf_block* b) {
+  while (b) {
+    mjwf_block* prev = b->prev;
+    free(b);
+    b = prev;
+  }
+}
+
+size_t _mjwf_arena_mark(int h) {
+  if (h <= 0 || h >= MJWF_MAXH || !g_arena[h].top) return 0;
+  const mjwf_block* b = g_arena[h].top;
+  return b->base + b->used;
+}
+
+void* _mjwf_arena_alloc(int h, size_t bytes) {
+  if (h <= 0 || h >= MJWF_MAXH) return NULL;
+  mjwf_arena* a = &g_arena[h];
+  bytes = (bytes + MJWF_ARENA_ALIGN - 1) & ~(size_t)(MJWF_ARENA_ALIGN - 1);
+  mjwf_block* b = a->top;
+  if (!b || b->cap - b->used < bytes) {
+    size_t cap = b ? 2 * b->cap : MJWF_ARENA_BLOCK;
+    while (cap < bytes) cap *= 2;
+    b = mjwf_block_new(a->top, cap);
+    if (!b) return NULL;
+    a->top = b;
+  }
+  void* p = (char*)b + mjwf_block_header() + b->used;
+  b->used += bytes;
+  return p;
+}
+
+void _mjwf_arena_reset(int h, size_t mark) {
+  if (h <= 0 || h >= MJWF_MAXH) return;
+  mjwf_arena* a = &g_arena[h];
+  // Drop whole blocks above the mark, except that an emptied chain is merged
+  // into a single block that fits next time.
+  if (mark == 0 && a->top && a->top->prev) {
+    const size_t total = a->top->base + a->top->cap;
+    mjwf_blocks_free(a->top);
+    a->top = mjwf_block_new(NULL, total);
+    return;
+  }
+  while (a->top && a->top->base > mark) {
+    mjwf_block* prev = a->top->prev;
+    free(a->top);
+    a->top = prev;
+  }
+  if (a->top) a->top->used = mark - a->top->base;
+}
+
+void* _mjwf_arena_buffer(int h, int slot, size_t bytes) {
+  if (h <= 0 || h >= MJWF_MAXH || slot < 0 || slot >= MJWF_NBUF) return NULL;
+  mjwf_arena* a = &g_arena[h];
+  if (a->buf_cap[slot] < bytes || !a->buf[slot]) {
+    free(a->buf[slot]);
+    a->buf[slot] = malloc(bytes > 0 ? bytes : 1);
+    a->buf_cap[slot] = a->buf[slot] ? bytes : 0;
+  }
+  return a->buf[slot];
+}
+
+void _mjwf_arena_release(int h) {
+  if (h <= 0 || h >= MJWF_MAXH) return;
+  mjwf_arena* a = &g_arena[h];
+  mjwf_blocks_free(a->top);
+  for (int i = 0; i < MJWF_NBUF; ++i) free(a->buf[i]);
+  memset(a, 0, sizeof(*a));
+}
+
+EMSCRIPTEN_KEEPALIVE double mjwf_arena_bytes(int h) {
+  if (h <= 0 || h >= MJWF_MAXH) return 0;
+  const mjwf_arena* a = &g_arena[h];
+  double bytes = a->top ? (double)(a->top->base + a->top->cap) : 0;
+  for (int i = 0; i < MJWF_NBUF; ++i) bytes += (double)a->buf_cap[i];
+  return bytes;
+}
+
+EMSCRIPTEN_KEEPALIVE const char* mjwf_malloc_name(void) { return MJWF_MALLOC_NAME; }
+
+EMSCRIPTEN_KEEPALIVE int mjwf_pointer_bytes(void) { return (int)sizeof(void*); }
+
+EMSCRIPTEN_KEEPALIVE int mjwf_heap_stats(double* out) {
+  if (!out) return 0;
+  for (int i = 0; i < MJWF_HEAP_NSTAT; ++i) out[i] = -1;
+#if defined(__EMSCRIPTEN__)
+  // Linear memory never shrinks, so its size is also the peak.
+  out[MJWF_HEAP_MEMORY] = (double)emscripten_get_heap_size();
+  out[MJWF_HEAP_BRK] = (double)(uintptr_t)sbrk(0);
+#endif
+#if defined(MJWF_HAVE_MALLINFO)
+  const struct mallinfo mi = mallinfo();
+  out[MJWF_HEAP_IN_USE] = (double)(unsigned)mi.uordblks;
+  out[MJWF_HEAP_FREE] = (double)(unsigned)mi.fordblks;
+#elif defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+  const struct mallinfo2 mi = mallinfo2();
+  out[MJWF_HEAP_IN_USE] = (double)mi.uordblks;
+  out[MJWF_HEAP_FREE] = (double)mi.fordblks;
+#endif
+  double arena = 0;
+  for (int h = 1; h < MJWF_MAXH; ++h) arena += mjwf_arena_bytes(h);
+  out[MJWF_HEAP_ARENA] = arena;
+  return 1;
+}
@@ -0,0 +1,237 @@
+// Process-wide asset cache for MuJoCo WASM 3.3.8-alpha
+// Mesh, heightfield and texture files registered here are read and hashed
+// once and kept in a single mjVFS that every model load in the handle layer
+// passes to MuJoCo (mjwf_make_from_xml, mjwf_make_editable, recompiles,
+// replication), so MuJoCo no longer reads them from the file system. Because
+// VFS resources are stamped with a hash of their contents, MuJoCo's own
+// processed-mesh cache also keeps hitting across loads, which is what skips
+// repeated convex hull computation.
+//
+// Entries are keyed by the path MuJoCo resolves for the asset (model dir +
+// meshdir + file, or the absolute path from the XML) and carry a 64-bit
+// content hash:
+// - re-adding a file whose size and mtime are unchanged is a hit and does not
+//   touch the file; otherwise it is re-read, and if the content hash still
+//   matches the entry is kept as is;
+// - content already cached under another path is counted in the duplicate
+//   stats (mjVFS looks files up by name, so each path holds its own copy).
+// Entries are evicted least-recently-added first when the cache exceeds its
+// byte budget; evicted assets are simply read from disk again by MuJoCo.
+//
+// The cache is not locked: add/evict from one thread, not while a load that
+// uses it runs on another. Changes fail with code 153 while async makes
+// (mjwf_async.c) are compiling.
+
+#include <mujoco/mujoco.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "mjwf_exports.h"
+#include "mjwf_internal.h"
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#else
+#ifndef EMSCRIPTEN_KEEPALIVE
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#endif
+
+#define MJWF_ASSET_NAME 512
+
+typedef struct {
+  char name[MJWF_ASSET_NAME];
+  uint64_t hash;
+  size_t size;
+  long long mtime;  // -1 for buffers added from memory
+  uint64_t tick;    // last add, for LRU eviction
+} mjwf_asset;
+
+static mjVFS g_vfs;
+static int g_vfs_init = 0;
+static mjwf_asset* g_assets = NULL;
+static int g_nasset = 0;
+static int g_capasset = 0;
+static size_t g_bytes = 0;
+static size_t g_budget = 0;  // 0 = unlimited
+static uint64_t g_tick = 0;
+static double g_stat[MJWF_ASSET_NSTAT];
+
+// 64-bit hash over 8-byte words (murmur-style mixing); only used to tell
+// contents apart, not for anything adversarial.
+static uint64_t mjwf_hash64(const unsigned char* p, size_t n) {
+  const uint64_t k = 0x9E3779B97F4A7C15ull;
+  uint64_t h = 0xCBF29CE484222325ull ^ (uint64_t)n;
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    uint64_t w;
+    memcpy(&w, p + i, 8);
+    w *= k;
+    w ^= w >> 29;
+    h = (h ^ w) * 0xBF58476D1CE4E5B9ull;
+  }
+  uint64_t tail = 0;
+  for (size_t j = 0; i + j < n; ++j) tail |= (uint64_t)p[i + j] << (8 * j);
+  h = (h ^ (tail * k)) * 0x94D049BB133111EBull;
+  h ^= h >> 31;
+  return h;
+}
+
+static mjwf_asset* mjwf_asset_find(const char* name) {
+  for (int i = 0; i < g_nasset; ++i) {
+    if (strcmp(g_assets[i].name, name) == 0) return &g_assets[i];
+  }
+  return NULL;
+}
+
+static int mjwf_asset_is_duplicate(const mjwf_asset* a) {
+  for (int i = 0; i < g_nasset; ++i) {
+    if (&g_assets[i] != a && g_assets[i].hash == a->hash && g_assets[i].size == a->size) return 1;
+  }
+  return 0;
+}
+
+static void mjwf_asset_drop(int i) {
+  mj_deleteFileVFS(&g_vfs, g_assets[i].name);
+  g_bytes -= g_assets[i].size;
+  g_assets[i] = g_assets[--g_nasset];
+}
+
+static void mjwf_asset_evict(const mjwf_asset* keep) {
+  while (g_budget && g_bytes > g_budget && g_nasset > 1) {
+    int lru = -1;
+    for (int i = 0; i < g_nasset; ++i) {
+      if (&g_assets[i] != keep && (lru < 0 || g_assets[i].tick < g_assets[lru].tick)) lru = i;
+    }
+    if (lru < 0) return;
+    const int moved = keep == &g_assets[g_nasset - 1];
+    mjwf_asset_drop(lru);
+    if (moved) keep = &g_assets[lru];
+    g_stat[MJWF_ASSET_STAT_EVICTIONS] += 1;
+  }
+}
+
+// Adds or replaces name with the given bytes; returns 1 when the cached
+// content changed (a miss), 0 when it was already there, -1 on failure.
+static int mjwf_asset_store(const char* name, const void* data, size_t size, long long mtime) {
+  const uint64_t hash = mjwf_hash64((const unsigned char*)data, size);
+  mjwf_asset* a = mjwf_asset_find(name);
+  if (a && a->hash == hash && a->size == size) {
+    a->mtime = mtime;
+    a->tick = ++g_tick;
+    return 0;
+  }
+  if (!g_vfs_init) {
+    mj_defaultVFS(&g_vfs);
+    g_vfs_init = 1;
+  }
+  if (a) mjwf_asset_drop((int)(a - g_assets));
+  if (g_nasset == g_capasset) {
+    const int cap = g_capasset ? 2 * g_capasset : 64;
+    mjwf_asset* grown = (mjwf_asset*)realloc(g_assets, sizeof(mjwf_asset) * cap);
+    if (!grown) return -1;
+    g_assets = grown;
+    g_capasset = cap;
+  }
+  if (mj_addBufferVFS(&g_vfs, name, data, (int)size) != 0) return -1;
+  a = &g_assets[g_nasset++];
+  snprintf(a->name, sizeof(a->name), "%s", name);
+  a->hash = hash;
+  a->size = size;
+  a->mtime = mtime;
+  a->tick = ++g_tick;
+  g_bytes += size;
+  if (mjwf_asset_is_duplicate(a)) g_stat[MJWF_ASSET_STAT_DUPLICATE_BYTES] += (double)size;
+  mjwf_asset_evict(a);
+  return 1;
+}
+
+const mjVFS* _mjwf_asset_vfs(void) {
+  return g_nasset > 0 ? &g_vfs : NULL;
+}
+
+static int mjwf_asset_busy(void) {
+  if (!_mjwf_async_running()) return 0;
+  _mjwf_set_global_error(153, "asset cache: in use by async makes, retry once they complete");
+  return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_asset_add_buffer(const char* name, const void* data, int nbytes) {
+  if (mjwf_asset_busy()) return 0;
+  if (!name || strlen(name) >= MJWF_ASSET_NAME || !data || nbytes < 0) {
+    _mjwf_set_global_error(150, "asset_add_buffer: bad name or buffer");
+    return 0;
+  }
+  const int r = mjwf_asset_store(name, data, (size_t)nbytes, -1);
+  if (r < 0) {
+    _mjwf_set_global_error(152, "asset cache: could not store asset");
+    return 0;
+  }
+  g_stat[r ? MJWF_ASSET_STAT_MISSES : MJWF_ASSET_STAT_HITS] += 1;
+  return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_asset_add_file(const char* path) {
+  if (mjwf_asset_busy()) return 0;
+  struct stat st;
+  if (!path || strlen(path) >= MJWF_ASSET_NAME || stat(path, &st) != 0) {
+    _mjwf_set_global_error(151, "asset_add_file: cannot stat file");
+    return 0;
+  }
+  mjwf_asset* a = mjwf_asset_find(path);
+  if (a && a->mtime == (long long)st.st_mtime && a->size == (size_t)st.st_size) {
+    a->tick = ++g_tick;
+    g_stat[MJWF_ASSET_STAT_HITS] += 1;
+    return 1;
+  }
+  FILE* f = fopen(path, "rb");
+  unsigned char* buf = (unsigned char*)malloc(st.st_size > 0 ? (size_t)st.st_size : 1);
+  const size_t n = (f && buf) ? fread(buf, 1, (size_t)st.st_size, f) : 0;
+  if (f) fclose(f);
+  if (!buf || n != (size_t)st.st_size) {
+    free(buf);
+    _mjwf_set_global_error(151, "asset_add_file: read failed");
+    return 0;
+  }
+  g_stat[MJWF_ASSET_STAT_BYTES_READ] += (double)n;
+  const int r = mjwf_asset_store(path, buf, n, (long long)st.st_mtime);
+  free(buf);
+  if (r < 0) {
+    _mjwf_set_global_error(152, "asset cache: could not store asset");
+    return 0;
+  }
+  // Touched but unchanged content still counts as a hit.
+  g_stat[r ? MJWF_ASSET_STAT_MISSES : MJWF_ASSET_STAT_HITS] += 1;
+  return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_asset_remove(const char* name) {
+  if (mjwf_asset_busy()) return 0;
+  mjwf_asset* a = name ? mjwf_asset_find(name) : NULL;
+  if (!a) return 0;
+  mjwf_asset_drop((int)(a - g_assets));
+  return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE void mjwf_asset_cache_set_budget(double bytes) {
+  if (mjwf_asset_busy()) return;
+  g_budget = bytes > 0 ? (size_t)bytes : 0;
+  mjwf_asset_evict(NULL);
+}
+
+EMSCRIPTEN_KEEPALIVE void mjwf_asset_cache_clear(void) {
+  if (mjwf_asset_busy()) return;
+  while (g_nasset > 0) mjwf_asset_drop(g_nasset - 1);
+  memset(g_stat, 0, sizeof(g_stat));
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_asset_cache_stats(double* out) {
+  if (!out) return 0;
+  memcpy(out, g_stat, sizeof(g_stat));
+  out[MJWF_ASSET_STAT_ENTRIES] = g_nasset;
+  out[MJWF_ASSET_STAT_BYTES] = (double)g_bytes;
+  return MJWF_ASSET_NSTAT;
+}
@@ -0,0 +1,215 @@
+// Command-buffer executor for MuJoCo WASM 3.3.8-alpha
+// Runs a packed sequence of mjwf operations (possibly spanning several
+// handles) in one boundary crossing and packs all results into a reply buffer.
+//
+// Layout (little-endian, every record 8-byte aligned):
+//   command buffer : header, then count x (record + payload)
+//   reply buffer   : header, then one (record + payload) per executed command
+// Record payloads (see MJWF_CMD_* in mjwf_exports.h):
+//   SET_VIEW         arg=view id; payload = i32 offset, i32 count, count elements in view dtype
+//   STEP             arg=n
+//   FORWARD          -
+//   RESET            arg=keyframe, or <0 for mj_resetData
+//   SAVE_STATE       arg=slot
+//   RESTORE_STATE    arg=slot
+//   GATHER_VIEW      arg=view id; payload = i32 offset, i32 count (<0: to end of view)
+//                    reply payload = elements in view dtype
+//   GATHER_CONTACTS  reply payload = i32 ncon, i32 pad, ncon x {f64 pos[3], f64 dist, i32 geom[2]}
+// Execution stops at the first failing command; its reply record carries the
+// status and the reply header count tells how many commands ran.
+
+#include <mujoco/mujoco.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mjwf_exports.h"
+#include "mjwf_internal.h"
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#else
+#ifndef EMSCRIPTEN_KEEPALIVE
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#endif
+
+typedef struct {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t flags;
+  uint32_t count;
+  uint32_t nbytes;
+} mjwfCmdHeader;
+
+typedef struct {
+  uint16_t op;
+  uint16_t status;  // reply only
+  int32_t  handle;
+  uint32_t size;    // payload bytes, multiple of 8
+  int32_t  arg;
+} mjwfCmdRecord;
+
+typedef struct {
+  double  pos[3];
+  double  dist;
+  int32_t geom[2];
+} mjwfCmdContact;
+
+#define MJWF_ALIGN8(n) (((n) + 7u) & ~7u)
+
+static int mjwf_cmd_range(const mjModel* m, int view, int32_t offset, int32_t* count) {
+  const int size = _mjwf_view_size(m, view);
+  if (offset < 0 || offset > size) return 0;
+  if (*count < 0) *count = size - offset;
+  return *count <= size - offset;  // offset + count could wrap
+}
+
+static uint16_t mjwf_cmd_set_view(int h, const mjwfCmdRecord* rec, const char* payload) {
+  if (rec->size < 8) return MJWF_CMD_E_ARG;
+  const int view = rec->arg;
+  if (!mjwf_view_writable(view)) {
+    _mjwf_set_error(h, 20, "view is not writable");
+    return MJWF_CMD_E_VIEW;
+  }
+  int32_t offset, count;
+  memcpy(&offset, payload, 4);
+  memcpy(&count, payload + 4, 4);
+  mjModel* m = _mjwf_model_of(h);
+  const int esz = _mjwf_view_elem_bytes(view);
+  if (!mjwf_cmd_range(m, view, offset, &count) || (uint64_t)count * esz > rec->size - 8u) {
+    _mjwf_set_error(h, 21, "set_view range out of bounds");
+    return MJWF_CMD_E_RANGE;
+  }
+  char* dst = (char*)_mjwf_view_writable_addr(h, view);
+  if (!dst) return MJWF_CMD_E_VIEW;
+  memcpy(dst + (size_t)offset * esz, payload + 8, (size_t)count * esz);
+  return MJWF_CMD_OK;
+}
+
+static uint16_t mjwf_cmd_gather_view(int h, const mjwfCmdRecord* rec, const char* payload,
+                                     char* out, uint32_t cap, uint32_t* written) {
+  if (rec->size < 8) return MJWF_CMD_E_ARG;
+  const int view = rec->arg;
+  if (view < 0 || view >= mjwf_view_count()) return MJWF_CMD_E_VIEW;
+  int32_t offset, count;
+  memcpy(&offset, payload, 4);
+  memcpy(&count, payload + 4, 4);
+  mjModel* m = _mjwf_model_of(h);
+  if (!mjwf_cmd_range(m, view, offset, &count)) {
+    _mjwf_set_error(h, 21, "gather_view range out of bounds");
+    return MJWF_CMD_E_RANGE;
+  }
+  const int esz = _mjwf_view_elem_bytes(view);
+  const uint64_t nbytes = (uint64_t)count * esz;
+  if (nbytes > cap || MJWF_ALIGN8(nbytes) > cap) return MJWF_CMD_E_REPLY;
+  const char* src = (const char*)_mjwf_view_addr(m, _mjwf_data_of(h), view);
+  if (!src) return MJWF_CMD_E_VIEW;
+  memcpy(out, src + (size_t)offset * esz, (size_t)nbytes);
+  memset(out + nbytes, 0, (size_t)(MJWF_ALIGN8(nbytes) - nbytes));
+  *written = (uint32_t)MJWF_ALIGN8(nbytes);
+  return MJWF_CMD_OK;
+}
+
+static uint16_t mjwf_cmd_gather_contacts(int h, char* out, uint32_t cap, uint32_t* written) {
+  const mjData* d = _mjwf_data_of(h);
+  const int32_t ncon = d->ncon;
+  const uint32_t nbytes = 8u + (uint32_t)ncon * sizeof(mjwfCmdContact);
+  if (nbytes > cap) return MJWF_CMD_E_REPLY;
+  const int32_t pad = 0;
+  memcpy(out, &ncon, 4);
+  memcpy(out + 4, &pad, 4);
+  mjwfCmdContact* dst = (mjwfCmdContact*)(out + 8);
+  for (int i = 0; i < ncon; ++i) {
+    const mjContact* c = &d->contact[i];
+    dst[i].pos[0] = c->pos[0];
+    dst[i].pos[1] = c->pos[1];
+    dst[i].pos[2] = c->pos[2];
+    dst[i].dist = c->dist;
+    dst[i].geom[0] = c->geom[0];
+    dst[i].geom[1] = c->geom[1];
+  }
+  *written = nbytes;
+  return MJWF_CMD_OK;
+}
+
+static uint16_t mjwf_cmd_run(const mjwfCmdRecord* rec, const char* payload,
+                             char* out, uint32_t cap, uint32_t* written) {
+  const int h = rec->handle;
+  *written = 0;
+  if (!mjwf_valid(h)) return MJWF_CMD_E_HANDLE;
+  switch (rec->op) {
+    case MJWF_CMD_SET_VIEW:
+      return mjwf_cmd_set_view(h, rec, payload);
+    case MJWF_CMD_STEP:
+      return mjwf_step(h, rec->arg) ? MJWF_CMD_OK : MJWF_CMD_E_ARG;
+    case MJWF_CMD_FORWARD:
+      return mjwf_forward(h) ? MJWF_CMD_OK : MJWF_CMD_E_ARG;
+    case MJWF_CMD_RESET: {
+      mjModel* m = _mjwf_model_of(h);
+      if (rec->arg < 0) {
+        mj_resetData(m, _mjwf_data_of(h));
+      } else if (rec->arg < m->nkey) {
+        mj_resetDataKeyframe(m, _mjwf_data_of(h), rec->arg);
+      } else {
+        return MJWF_CMD_E_ARG;
+      }
+      return MJWF_CMD_OK;
+    }
+    case MJWF_CMD_SAVE_STATE:
+      return mjwf_state_save(h, rec->arg) ? MJWF_CMD_OK : MJWF_CMD_E_STATE;
+    case MJWF_CMD_RESTORE_STATE:
+      return mjwf_state_restore(h, rec->arg) ? MJWF_CMD_OK : MJWF_CMD_E_STATE;
+    case MJWF_CMD_GATHER_VIEW:
+      return mjwf_cmd_gather_view(h, rec, payload, out, cap, written);
+    case MJWF_CMD_GATHER_CONTACTS:
+      return mjwf_cmd_gather_contacts(h, out, cap, written);
+    default:
+      return MJWF_CMD_E_OP;
+  }
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_cmdbuf_exec(const void* cmd, int cmd_bytes, void* reply, int reply_cap) {
+  const char* in = (const char*)cmd;
+  char* out = (char*)reply;
+  if (!in || !out || cmd_bytes < (int)sizeof(mjwfCmdHeader) || reply_cap < (int)sizeof(mjwfCmdHeader)) {
+    _mjwf_set_global_error(30, "cmdbuf: null or truncated buffer");
+    return -1;
+  }
+  mjwfCmdHeader hdr;
+  memcpy(&hdr, in, sizeof(hdr));
+  if (hdr.magic != MJWF_CMDBUF_MAGIC || hdr.version != MJWF_CMDBUF_VERSION || hdr.nbytes > (uint32_t)cmd_bytes) {
+    _mjwf_set_global_error(31, "cmdbuf: bad header");
+    return -1;
+  }
+
+  uint32_t off = sizeof(mjwfCmdHeader);
+  uint32_t roff = sizeof(mjwfCmdHeader);
+  uint32_t nrec = 0;
+  for (uint32_t i = 0; i < hdr.count; ++i) {
+    mjwfCmdRecord rec;
+    if (off + sizeof(rec) > hdr.nbytes) break;
+    memcpy(&rec, in + off, sizeof(rec));
+    if ((rec.size & 7u) || off + sizeof(rec) + rec.size > hdr.nbytes) {
+      _mjwf_set_global_error(32, "cmdbuf: malformed record");
+      break;
+    }
+    if (roff + sizeof(mjwfCmdRecord) > (uint32_t)reply_cap) {
+      _mjwf_set_global_error(33, "cmdbuf: reply buffer full");
+      break;
+    }
+    uint32_t written = 0;
+    const uint32_t cap = (uint32_t)reply_cap - roff - sizeof(mjwfCmdRecord);
+    mjwfCmdRecord res = rec;
+    res.status = mjwf_cmd_run(&rec, in + off + sizeof(rec), out + roff + sizeof(res), cap, &written);
+    res.size = written;
+    memcpy(out + roff, &res, sizeof(res));
+    roff += sizeof(res) + written;
+    off += sizeof(rec) + rec.size;
+    ++nrec;
+    if (res.status != MJWF_CMD_OK) break;
+  }
+
+  mjwfCmdHeader rh = { MJWF_REPLY_MAGIC, MJWF_CMDBUF_VERSION, 0, nrec, roff };
+  memcpy(out, &rh, sizeof(rh));
+  return (int)roff;
+}
@@ -0,0 +1,85 @@
+// Batched collision queries for MuJoCo WASM 3.3.8-alpha
+// Tests K configurations with kinematics + collision detection only (no
+// dynamics), each on a per-worker scratch mjData synced from the handle, so
+// mocap poses and other non-qpos state come from the handle's current data.
+//
+// Per configuration k (qpos is K x nq):
+//   colliding[k] = 1 if any contact has dist < threshold (threshold 0: penetration)
+//   ncon[k]      = contacts generated (within geom margins), optional
+//   mindist[k]   = smallest contact dist, mjMAXVAL when no contact, optional
+// Returns the number of colliding configurations, or -1 on error.
+//
+// Models with flexes are supported: mj_flex runs after mj_kinematics so flex
+// vertex positions and bounding boxes follow each configuration's bodies
+// before mj_collision uses them.
+
+#include <mujoco/mujoco.h>
+#include <string.h>
+
+#include "mjwf_exports.h"
+#include "mjwf_internal.h"
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#else
+#ifndef EMSCRIPTEN_KEEPALIVE
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#endif
+
+typedef struct {
+  int h;
+  const mjModel* m;
+  const double* qpos;
+  double threshold;
+  unsigned char* colliding;
+  int* ncon;
+  double* mindist;
+  int hits[MJWF_MAXWORKERS];
+} mjwf_collide_job;
+
+static void mjwf_collide_range(void* ctx, int worker, int begin, int end) {
+  mjwf_collide_job* job = (mjwf_collide_job*)ctx;
+  const mjModel* m = job->m;
+  mjData* d = _mjwf_scratch_of(job->h, worker);
+  int hits = 0;
+  for (int k = begin; k < end; ++k) {
+    memcpy(d->qpos, job->qpos + (size_t)k * m->nq, sizeof(double) * m->nq);
+    mj_kinematics(m, d);
+    if (m->nflex > 0) mj_flex(m, d);
+    mj_collision(m, d);
+    double dmin = mjMAXVAL;
+    for (int i = 0; i < d->ncon; ++i) {
+      if (d->contact[i].dist < dmin) dmin = d->contact[i].dist;
+    }
+    const int hit = dmin < job->threshold;
+    hits += hit;
+    if (job->colliding) job->colliding[k] = (unsigned char)hit;
+    if (job->ncon) job->ncon[k] = d->ncon;
+    if (job->mindist) job->mindist[k] = dmin;
+  }
+  job->hits[worker] += hits;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_collision_batch(int h, const double* qpos, int K, double threshold,
+                                              unsigned char* colliding, int* ncon, double* mindist) {
+  if (!mjwf_valid(h)) return -1;
+  if (!qpos || K <= 0) {
+    _mjwf_set_error(h, 60, "collision_batch: empty input");
+    return -1;
+  }
+  mjwf_collide_job job = {0};
+  job.h = h;
+  job.m = _mjwf_model_of(h);
+  job.qpos = qpos;
+  job.threshold = threshold;
+  job.colliding = colliding;
+  job.ncon = ncon;
+  job.mindist = mindist;
+  const int nworker = _mjwf_worker_count(K);
+  if (!_mjwf_scratch_reserve(h, nworker)) return -1;
+  _mjwf_parallel_for(K, nworker, mjwf_collide_range, &job);
+  int total = 0;
+  for (int w = 0; w < nworker; ++w) total += job.hits[w];
+  return total;
+}
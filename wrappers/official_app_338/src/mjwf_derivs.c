@@ -0,0 +1,148 @@
+// Batched finite-difference derivatives for MuJoCo WASM 3.3.8-alpha
+// Evaluates mjd_transitionFD / mjd_inverseFD for every step of a trajectory in
+// one call, on per-worker scratch mjData, writing one packed output buffer.
+//
+// Trajectory inputs are row-major: states is T x mj_stateSize(m, sig) in
+// mj_getState layout, ctrls is T x nu (NULL keeps the ctrl carried by the state
+// or the handle), qaccs is T x nv.
+// Transition output per step (ndx = 2*nv + na, ns = nsensordata):
+//   A ndx*ndx | B ndx*nu | C ns*ndx | D ns*nu     (C, D only with MJWF_DERIV_SENSORS)
+// Inverse output per step:
+//   DfDq nv*nv | DfDv nv*nv | DfDa nv*nv
+
+#include <mujoco/mujoco.h>
+#include <string.h>
+
+#include "mjwf_exports.h"
+#include "mjwf_internal.h"
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#else
+#ifndef EMSCRIPTEN_KEEPALIVE
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#endif
+
+typedef struct {
+  int h;
+  const mjModel* m;
+  const double* states;
+  const double* ctrls;
+  const double* qaccs;
+  unsigned int sig;
+  int nstate;
+  double eps;
+  int flags;
+  int stride;
+  double* out;
+} mjwf_deriv_job;
+
+static int mjwf_deriv_ndx(const mjModel* m) {
+  return 2 * m->nv + m->na;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_transition_fd_stride(int h, int flags) {
+  const mjModel* m = _mjwf_model_of(h);
+  if (!m) return 0;
+  const int ndx = mjwf_deriv_ndx(m);
+  int stride = ndx * ndx + ndx * m->nu;
+  if (flags & MJWF_DERIV_SENSORS) stride += m->nsensordata * (ndx + m->nu);
+  return stride;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_inverse_fd_stride(int h) {
+  const mjModel* m = _mjwf_model_of(h);
+  return m ? 3 * m->nv * m->nv : 0;
+}
+
+static void mjwf_deriv_load(const mjwf_deriv_job* job, mjData* d, int t) {
+  const mjModel* m = job->m;
+  mj_setState(m, d, job->states + (size_t)t * job->nstate, job->sig);
+  if (job->ctrls && m->nu) {
+    memcpy(d->ctrl, job->ctrls + (size_t)t * m->nu, sizeof(double) * m->nu);
+  }
+}
+
+static void mjwf_transition_range(void* ctx, int worker, int begin, int end) {
+  const mjwf_deriv_job* job = (const mjwf_deriv_job*)ctx;
+  const mjModel* m = job->m;
+  mjData* d = _mjwf_scratch_of(job->h, worker);
+  const int ndx = mjwf_deriv_ndx(m);
+  const int sensors = (job->flags & MJWF_DERIV_SENSORS) && m->nsensordata;
+  for (int t = begin; t < end; ++t) {
+    double* A = job->out + (size_t)t * job->stride;
+    double* B = A + ndx * ndx;
+    double* C = sensors ? B + ndx * m->nu : NULL;
+    double* D = sensors ? C + m->nsensordata * ndx : NULL;
+    mjwf_deriv_load(job, d, t);
+    mjd_transitionFD(m, d, job->eps, (mjtByte)((job->flags & MJWF_DERIV_CENTERED) != 0),
+                     A, m->nu ? B : NULL, C, (sensors && m->nu) ? D : NULL);
+  }
+}
+
+static void mjwf_inverse_range(void* ctx, int worker, int begin, int end) {
+  const mjwf_deriv_job* job = (const mjwf_deriv_job*)ctx;
+  const mjModel* m = job->m;
+  mjData* d = _mjwf_scratch_of(job->h, worker);
+  const int nv2 = m->nv * m->nv;
+  for (int t = begin; t < end; ++t) {
+    double* DfDq = job->out + (size_t)t * job->stride;
+    mjwf_deriv_load(job, d, t);
+    memcpy(d->qacc, job->qaccs + (size_t)t * m->nv, sizeof(double) * m->nv);
+    mjd_inverseFD(m, d, job->eps, (mjtByte)((job->flags & MJWF_DERIV_ACTUATION) != 0),
+                  DfDq, DfDq + nv2, DfDq + 2 * nv2, NULL, NULL, NULL, NULL);
+  }
+}
+
+static int mjwf_deriv_prepare(mjwf_deriv_job* job, int h, const double* states, int sig, int T, double* out) {
+  if (!mjwf_valid(h)) return 0;
+  if (!states || !out || T <= 0) {
+    _mjwf_set_error(h, 41, "derivatives: empty trajectory or output");
+    return 0;
+  }
+  if (sig <= 0 || sig >= (1 << mjNSTATE)) {
+    _mjwf_set_error(h, 42, "derivatives: invalid state signature");
+    return 0;
+  }
+  job->h = h;
+  job->m = _mjwf_model_of(h);
+  job->states = states;
+  job->sig = (unsigned int)sig;
+  job->nstate = mj_stateSize(job->m, job->sig);
+  job->out = out;
+  if (job->eps <= 0) job->eps = 1e-6;
+  const int nworker = _mjwf_worker_count(T);
+  if (!_mjwf_scratch_reserve(h, nworker)) return 0;
+  return nworker;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_transition_fd_batch(int h, const double* states, int sig, const double* ctrls,
+                                                  int T, double eps, int flags, double* out) {
+  mjwf_deriv_job job = {0};
+  job.ctrls = ctrls;
+  job.eps = eps;
+  job.flags = flags;
+  job.stride = mjwf_transition_fd_stride(h, flags);
+  const int nworker = mjwf_deriv_prepare(&job, h, states, sig, T, out);
+  if (!nworker) return 0;
+  _mjwf_parallel_for(T, nworker, mjwf_transition_range, &job);
+  return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_inverse_fd_batch(int h, const double* states, int sig, const double* qaccs,
+                                               int T, double eps, int flags, double* out) {
+  if (mjwf_valid(h) && !qaccs) {
+    _mjwf_set_error(h, 41, "derivatives: qacc trajectory required");
+    return 0;
+  }
+  mjwf_deriv_job job = {0};
+  job.qaccs = qaccs;
+  job.eps = eps;
+  job.flags = flags;
+  job.stride = mjwf_inverse_fd_stride(h);
+  const int nworker = mjwf_deriv_prepare(&job, h, states, sig, T, out);
+  if (!nworker) return 0;
+  _mjwf_parallel_for(T, nworker, mjwf_inverse_range, &job);
+  return 1;
+}
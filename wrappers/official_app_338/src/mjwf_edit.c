@@ -0,0 +1,139 @@
+// In-place model editing for MuJoCo WASM 3.3.8-alpha
+// Handles created with mjwf_make_editable keep their mjSpec. Edits change the
+// spec only -- either through the helpers below or through mjwf_spec_ptr and
+// the mjwf_mjs_* aliases -- and mjwf_recompile applies any number of them
+// with mj_recompile, which reallocates the handle's mjModel/mjData in place
+// and carries the integration state over (qpos/qvel of joints that still
+// exist are kept, new joints start at qpos0).
+//
+// After a recompile every pointer into the model or data may have moved:
+// JS views must be re-derived (mjwf_model_generation changes), state slots,
+// scratch data and overlays are dropped, and vector envs created on the
+// handle stop working. Handles whose model is shared cannot be recompiled.
+
+#include <mujoco/mujoco.h>
+
+#include "mjwf_exports.h"
+#include "mjwf_internal.h"
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#else
+#ifndef EMSCRIPTEN_KEEPALIVE
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#endif
+
+static mjSpec* mjwf_edit_spec(int h) {
+  if (!mjwf_valid(h)) return NULL;
+  mjSpec* spec = _mjwf_spec_of(h);
+  if (!spec) _mjwf_set_error(h, 140, "edit: handle was not created with mjwf_make_editable");
+  return spec;
+}
+
+static mjsElement* mjwf_edit_find(int h, mjSpec* spec, int objtype, const char* name) {
+  mjsElement* el = (spec && name) ? mjs_findElement(spec, (mjtObj)objtype, name) : NULL;
+  if (spec && !el) _mjwf_set_error(h, 141, "edit: no element with that type and name");
+  return el;
+}
+
+static void mjwf_edit_copy(double* dst, const double* src, int n) {
+  if (!src) return;
+  for (int i = 0; i < n; ++i) dst[i] = src[i];
+}
+
+EMSCRIPTEN_KEEPALIVE void* mjwf_spec_ptr(int h) {
+  return mjwf_valid(h) ? _mjwf_spec_of(h) : NULL;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_model_generation(int h) {
+  return _mjwf_model_generation(h);
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_edit_body(int h, const char* name, const double* pos, const double* quat) {
+  mjSpec* spec = mjwf_edit_spec(h);
+  mjsElement* el = mjwf_edit_find(h, spec, mjOBJ_BODY, name);
+  if (!el) return 0;
+  mjsBody* body = mjs_asBody(el);
+  mjwf_edit_copy(body->pos, pos, 3);
+  mjwf_edit_copy(body->quat, quat, 4);
+  return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_edit_geom(int h, const char* name, const double* pos, const double* quat,
+                                        const double* size) {
+  mjSpec* spec = mjwf_edit_spec(h);
+  mjsElement* el = mjwf_edit_find(h, spec, mjOBJ_GEOM, name);
+  if (!el) return 0;
+  mjsGeom* geom = mjs_asGeom(el);
+  mjwf_edit_copy(geom->pos, pos, 3);
+  mjwf_edit_copy(geom->quat, quat, 4);
+  mjwf_edit_copy(geom->size, size, 3);
+  return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_edit_mesh(int h, const char* name, const char* file, const double* scale) {
+  mjSpec* spec = mjwf_edit_spec(h);
+  mjsElement* el = mjwf_edit_find(h, spec, mjOBJ_MESH, name);
+  if (!el) return 0;
+  mjsMesh* mesh = mjs_asMesh(el);
+  if (file) mjs_setString(mesh->file, file);
+  mjwf_edit_copy(mesh->scale, scale, 3);
+  return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_edit_attach(int h, const char* parent, const char* path, const char* prefix,
+                                          const double* pos) {
+  mjSpec* spec = mjwf_edit_spec(h);
+  if (!spec) return 0;
+  mjsBody* body = mjs_findBody(spec, (parent && parent[0]) ? parent : "world");
+  if (!body) {
+    _mjwf_set_error(h, 141, "edit_attach: no parent body with that name");
+    return 0;
+  }
+  char error[1024] = {0};
+  mjSpec* child = path ? mj_parseXML(path, _mjwf_asset_vfs(), error, sizeof(error)) : NULL;
+  if (!child) {
+    _mjwf_set_error(h, 142, error[0] ? error : "edit_attach: parseXML failed");
+    return 0;
+  }
+  mjsFrame* frame = mjs_addFrame(body, NULL);
+  mjwf_edit_copy(frame->pos, pos, 3);
+  // The child is copied into the spec, so it can go right away.
+  const int ok = mjs_attach(frame->element, child->element, prefix ? prefix : "", "") != NULL;
+  if (!ok) _mjwf_set_error(h, 142, mjs_getError(spec));
+  mj_deleteSpec(child);
+  return ok;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_edit_delete(int h, int objtype, const char* name) {
+  mjSpec* spec = mjwf_edit_spec(h);
+  mjsElement* el = mjwf_edit_find(h, spec, objtype, name);
+  if (!el) return 0;
+  if (mjs_delete(spec, el) != 0) {
+    _mjwf_set_error(h, 142, mjs_getError(spec));
+    return 0;
+  }
+  return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_recompile(int h) {
+  mjSpec* spec = mjwf_edit_spec(h);
+  if (!spec) return 0;
+  if (_mjwf_share_count(h) > 0) {
+    _mjwf_set_error(h, 144, "recompile: handle still has shared models");
+    return 0;
+  }
+  // Overlay copies point into the old model; put the nominal arrays back
+  // before mj_recompile replaces the buffer.
+  _mjwf_overlay_release(h);
+  mjModel* m = _mjwf_model_of(h);
+  mjData* d = _mjwf_data_of(h);
+  if (mj_recompile(spec, _mjwf_asset_vfs(), m, d) != 0) {
+    _mjwf_set_error(h, 143, mjs_getError(spec));
+    return 0;
+  }
+  _mjwf_model_changed(h);
+  mj_forward(m, d);
+  return 1;
+}
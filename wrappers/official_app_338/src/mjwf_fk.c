@@ -0,0 +1,109 @@
+// Batched forward kinematics for MuJoCo WASM 3.3.8-alpha
+// Evaluates body/site poses (and optionally Jacobians) for K joint
+// configurations with mj_kinematics only, on per-worker scratch mjData synced
+// from the handle (mocap poses come from the handle's current data).
+//
+// objs is nobj x 2 (objtype, id) with objtype mjOBJ_BODY or mjOBJ_SITE.
+// Output is K x nobj x stride, per object:
+//   pos 3 | mat 9 (or quat 4 with MJWF_FK_QUAT) [| jacp 3*nv | jacr 3*nv]
+// Jacobians (MJWF_FK_JACOBIAN) also run mj_comPos and use mj_jacSite /
+// mj_jacBody at the object origin.
+
+#include <mujoco/mujoco.h>
+#include <string.h>
+
+#include "mjwf_exports.h"
+#include "mjwf_internal.h"
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#else
+#ifndef EMSCRIPTEN_KEEPALIVE
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#endif
+
+typedef struct {
+  int h;
+  const mjModel* m;
+  const double* qpos;
+  const int* objs;
+  int nobj;
+  int flags;
+  int stride;
+  double* out;
+} mjwf_fk_job;
+
+EMSCRIPTEN_KEEPALIVE int mjwf_fk_stride(int h, int flags) {
+  const mjModel* m = _mjwf_model_of(h);
+  if (!m) return 0;
+  int stride = (flags & MJWF_FK_QUAT) ? 7 : 12;
+  if (flags & MJWF_FK_JACOBIAN) stride += 6 * m->nv;
+  return stride;
+}
+
+static void mjwf_fk_range(void* ctx, int worker, int begin, int end) {
+  const mjwf_fk_job* job = (const mjwf_fk_job*)ctx;
+  const mjModel* m = job->m;
+  mjData* d = _mjwf_scratch_of(job->h, worker);
+  const int quat = (job->flags & MJWF_FK_QUAT) != 0;
+  const int jac = (job->flags & MJWF_FK_JACOBIAN) != 0;
+  for (int k = begin; k < end; ++k) {
+    memcpy(d->qpos, job->qpos + (size_t)k * m->nq, sizeof(double) * m->nq);
+    mj_kinematics(m, d);
+    if (jac) mj_comPos(m, d);
+    double* row = job->out + (size_t)k * job->nobj * job->stride;
+    for (int i = 0; i < job->nobj; ++i) {
+      const int site = job->objs[2 * i] == mjOBJ_SITE;
+      const int id = job->objs[2 * i + 1];
+      const double* pos = site ? d->site_xpos + 3 * id : d->xpos + 3 * id;
+      const double* mat = site ? d->site_xmat + 9 * id : d->xmat + 9 * id;
+      double* o = row + (size_t)i * job->stride;
+      mju_copy3(o, pos);
+      if (quat) {
+        mju_mat2Quat(o + 3, mat);
+        o += 7;
+      } else {
+        mju_copy(o + 3, mat, 9);
+        o += 12;
+      }
+      if (jac) {
+        if (site) mj_jacSite(m, d, o, o + 3 * m->nv, id);
+        else mj_jacBody(m, d, o, o + 3 * m->nv, id);
+      }
+    }
+  }
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_fk_batch(int h, const double* qpos, int K, const int* objs, int nobj,
+                                       int flags, double* out) {
+  if (!mjwf_valid(h)) return 0;
+  if (!qpos || !objs || !out || K <= 0 || nobj <= 0) {
+    _mjwf_set_error(h, 70, "fk_batch: empty input or output");
+    return 0;
+  }
+  const mjModel* m = _mjwf_model_of(h);
+  for (int i = 0; i < nobj; ++i) {
+    const int type = objs[2 * i];
+    const int id = objs[2 * i + 1];
+    const int ok = (type == mjOBJ_SITE && id >= 0 && id < m->nsite) ||
+                   (type == mjOBJ_BODY && id >= 0 && id < m->nbody);
+    if (!ok) {
+      _mjwf_set_error(h, 71, "fk_batch: objects must be valid sites or bodies");
+      return 0;
+    }
+  }
+  mjwf_fk_job job = {0};
+  job.h = h;
+  job.m = m;
+  job.qpos = qpos;
+  job.objs = objs;
+  job.nobj = nobj;
+  job.flags = flags;
+  job.stride = mjwf_fk_stride(h, flags);
+  job.out = out;
+  const int nworker = _mjwf_worker_count(K);
+  if (!_mjwf_scratch_reserve(h, nworker)) return 0;
+  _mjwf_parallel_for(K, nworker, mjwf_fk_range, &job);
+  return 1;
+}
@@ -0,0 +1,84 @@
+// Render geometry manifest for MuJoCo WASM 3.3.8-alpha
+// Renderers need every mesh's vertices/normals/faces and every heightfield's
+// samples once per model. Instead of per-mesh getter calls, mjwf_geometry_manifest
+// writes one mjwf_geometry_header (counts plus the addresses of the pooled
+// model arrays) followed by a mesh table and an hfield table of int32 rows, so
+// JS builds all its typed-array views over HEAP memory from a single call:
+//
+//   mesh i:   vert   = mesh_vert  [3*vertadr   .. 3*(vertadr+vertnum))
+//             normal = mesh_normal[3*normaladr .. 3*(normaladr+normalnum))
+//             face   = mesh_face  [3*faceadr   .. 3*(faceadr+facenum))
+//   hfield i: data   = hfield_data[adr .. adr + nrow*ncol), size = hfield_size[4*i]
+//
+// Face indices are local to the mesh (add vertadr to index mesh_vert);
+// mesh_facenormal rows index the mesh's normals the same way. Everything
+// points into the handle's mjModel: re-read the manifest whenever
+// mjwf_model_generation changes.
+
+#include <mujoco/mujoco.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mjwf_exports.h"
+#include "mjwf_internal.h"
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#else
+#ifndef EMSCRIPTEN_KEEPALIVE
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#endif
+
+static int mjwf_geometry_bytes(const mjModel* m) {
+  return (int)sizeof(mjwf_geometry_header) +
+         (int)sizeof(int32_t) * (MJWF_GEOMETRY_MESH_COLS * m->nmesh + MJWF_GEOMETRY_HFIELD_COLS * m->nhfield);
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_geometry_manifest_size(int h) {
+  return mjwf_valid(h) ? mjwf_geometry_bytes(_mjwf_model_of(h)) : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_geometry_manifest(int h, void* out, int cap) {
+  if (!mjwf_valid(h)) return 0;
+  const mjModel* m = _mjwf_model_of(h);
+  const int bytes = mjwf_geometry_bytes(m);
+  if (!out || cap < bytes) {
+    _mjwf_set_error(h, 160, "geometry_manifest: buffer smaller than mjwf_geometry_manifest_size");
+    return 0;
+  }
+  mjwf_geometry_header hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.version = MJWF_GEOMETRY_VERSION;
+  hdr.nmesh = m->nmesh;
+  hdr.nhfield = m->nhfield;
+  hdr.nmeshvert = m->nmeshvert;
+  hdr.nmeshnormal = m->nmeshnormal;
+  hdr.nmeshface = m->nmeshface;
+  hdr.nhfielddata = m->nhfielddata;
+  hdr.mesh_table = (int32_t)sizeof(mjwf_geometry_header);
+  hdr.hfield_table = hdr.mesh_table + (int32_t)sizeof(int32_t) * MJWF_GEOMETRY_MESH_COLS * m->nmesh;
+  hdr.mesh_vert = (uint64_t)(uintptr_t)m->mesh_vert;
+  hdr.mesh_normal = (uint64_t)(uintptr_t)m->mesh_normal;
+  hdr.mesh_face = (uint64_t)(uintptr_t)m->mesh_face;
+  hdr.mesh_facenormal = (uint64_t)(uintptr_t)m->mesh_facenormal;
+  hdr.hfield_data = (uint64_t)(uintptr_t)m->hfield_data;
+  hdr.hfield_size = (uint64_t)(uintptr_t)m->hfield_size;
+  memcpy(out, &hdr, sizeof(hdr));
+
+  int32_t* row = (int32_t*)((char*)out + hdr.mesh_table);
+  for (int i = 0; i < m->nmesh; ++i, row += MJWF_GEOMETRY_MESH_COLS) {
+    row[0] = m->mesh_vertadr[i];
+    row[1] = m->mesh_vertnum[i];
+    row[2] = m->mesh_faceadr[i];
+    row[3] = m->mesh_facenum[i];
+    row[4] = m->mesh_normaladr[i];
+    row[5] = m->mesh_normalnum[i];
+  }
+  for (int i = 0; i < m->nhfield; ++i, row += MJWF_GEOMETRY_HFIELD_COLS) {
+    row[0] = m->hfield_adr[i];
+    row[1] = m->hfield_nrow[i];
+    row[2] = m->hfield_ncol[i];
+  }
+  return bytes;
+}
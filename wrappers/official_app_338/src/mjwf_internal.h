@@ -0,0 +1,149 @@
+// Internal helpers shared by the mjwf translation units (not exported).
+// Public surface lives in include/mjwf_exports.h; this header only wires
+// the handle pool and generated view table into the feature modules.
+
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Handle pool size; native libmjwf builds raise it (MJWF_MAX_HANDLES in CMake).
+#ifndef MJWF_MAXH
+#define MJWF_MAXH 64
+#endif
+#define MJWF_STATE_SLOTS 4
+#define MJWF_MAXWORKERS 16
+
+// Handle pool (mjwf_handles.c)
+mjModel* _mjwf_model_of(int h);
+mjData*  _mjwf_data_of(int h);
+void     _mjwf_set_error(int h, int code, const char* msg);
+void     _mjwf_set_global_error(int code, const char* msg);
+
+// Per-worker scratch mjData, synced from the handle's data by reserve().
+int      _mjwf_scratch_reserve(int h, int nworker);
+mjData*  _mjwf_scratch_of(int h, int worker);
+
+// Worker fan-out (mjwf_workers.c). fn receives a contiguous [begin, end) chunk;
+// without MJWF_THREADS everything runs inline as worker 0.
+typedef void (*mjwf_range_fn)(void* ctx, int worker, int begin, int end);
+int  _mjwf_worker_count(int n);
+void _mjwf_parallel_for(int n, int nworker, mjwf_range_fn fn, void* ctx);
+
+// View table (generated from codegen/spec_*.yaml into mjwf_exports_generated.c).
+// Addresses are resolved against an explicit (m, d) pair so scratch mjData
+// instances can be read through the same ids as the handle's own data.
+void* _mjwf_view_addr(const mjModel* m, mjData* d, int id);
+int   _mjwf_view_size(const mjModel* m, int id);
+int   _mjwf_view_elem_bytes(int id);
+// Copies view[offset, offset + count) into out as doubles (count < 0: to the
+// end of the view); returns the number of elements written.
+int   _mjwf_view_read_f64(const mjModel* m, mjData* d, int id, int offset, int count, double* out);
+// Overlay views: model arrays a handle may override copy-on-write.
+int    _mjwf_view_is_overlay(int id);
+// Views of mjModel arrays (as opposed to mjData), overlay or not.
+int    _mjwf_view_is_model(int id);
+void** _mjwf_view_model_slot(mjModel* m, int id);
+// Model count a view's length is a multiple of (MJWF_EXTENT_*), with the
+// multiplier in *row.
+int    _mjwf_view_extent(int id, int* row);
+
+// Shared models (mjwf_handles.c): base handle of a shared handle, 0 otherwise.
+int   _mjwf_shared_base(int h);
+// New handle owning m (fresh mjData); on failure m is deleted, the global
+// error is set and -1 returned.
+int   _mjwf_make_from_model(mjModel* m);
+
+// Async makes (mjwf_async.c): claim() takes a free slot with no model yet
+// (-1 when none), install() gives it its model and data once compiled, and
+// release() abandons or drops h's compile job. running() counts jobs still
+// compiling; the asset cache refuses changes meanwhile.
+int   _mjwf_claim_handle(void);
+void  _mjwf_install(int h, mjModel* m, mjData* d);
+void  _mjwf_async_release(int h);
+int   _mjwf_async_running(void);
+
+// Editable handles (mjwf_handles.c): the spec kept by mjwf_make_editable (NULL
+// otherwise), live shares of h's model, and a generation counter that changes
+// whenever h's model/data are reallocated in place (or the id is reused).
+// _mjwf_model_changed() drops state slots and scratch data sized for the old
+// model and bumps the generation.
+mjSpec* _mjwf_spec_of(int h);
+int     _mjwf_share_count(int h);
+int     _mjwf_model_generation(int h);
+void    _mjwf_model_changed(int h);
+
+// Copy-on-write overlays (mjwf_overlay.c). acquire() gives the handle a private
+// copy of an overlay view and returns it; writable_addr() is the address to use
+// for any write through a view id; release() restores nominal arrays.
+void* _mjwf_overlay_acquire(int h, int id);
+void* _mjwf_view_writable_addr(int h, int id);
+void  _mjwf_overlay_release(int h);
+// Points every overlaid array of handle h back at its nominal array in m
+// (used when cloning h's model struct for a shared handle).
+void  _mjwf_overlay_strip(int h, mjModel* m);
+
+// Scene replication (mjwf_replicate.c): drops handle h's replica record.
+void  _mjwf_replica_release(int h);
+
+// Paced stepping (mjwf_pacing.c): monotonic wall clock in microseconds, and
+// forgetting handle h's step-cost average.
+double _mjwf_now_us(void);
+void   _mjwf_pace_release(int h);
+
+// Asset cache (mjwf_assets.c): VFS to pass to every load, NULL while empty.
+const mjVFS* _mjwf_asset_vfs(void);
+
+// State snapshots (mjwf_snapshot.c): drops handle h's codec state.
+void  _mjwf_snapshot_release(int h);
+
+// Replay logs (mjwf_replay.c): record() appends the step just taken when h is
+// recording; release() closes its log.
+int   _mjwf_replay_recording(int h);
+void  _mjwf_replay_record(int h);
+void  _mjwf_replay_release(int h);
+
+// Sensor subsets (mjwf_sensors.c): drops handle h's selection.
+void  _mjwf_sensor_release(int h);
+
+// Hibernation (mjwf_hibernate.c). touch() is called by mjwf_valid for every
+// live handle: it ticks the LRU clock and wakes h when it is hibernated
+// (returns 0 if that fails, or if h has no data and no blob). release() drops
+// h's blob. The pool side (mjwf_handles.c) never wakes h: peek() returns the
+// model of a live handle with its share root and the root's generation (mjData
+// of handles with equal root and generation are interchangeable); detach()
+// takes h's mjData, freeing its scratch data, and attach() gives it one.
+int      _mjwf_hibernate_touch(int h, int awake);
+void     _mjwf_hibernate_release(int h);
+mjModel* _mjwf_model_peek(int h, int* root, int* generation);
+mjData*  _mjwf_data_detach(int h);
+void     _mjwf_data_attach(int h, mjData* d);
+// Resident bytes of one mjData, and of h's mjData plus scratch data.
+double   _mjwf_mjdata_bytes(const mjData* d);
+double   _mjwf_data_bytes(int h);
+
+// Per-handle scratch (mjwf_arena.c). Per-call temporaries: take a mark, bump
+// allocate (16-byte aligned; NULL when out of memory) and reset to the mark
+// before returning. Buffers that outlive the call and only grow live in the
+// slots below; _mjwf_arena_buffer returns the slot resized to at least bytes
+// (contents are not kept across growth). All of it is freed with the handle.
+enum {
+  MJWF_BUF_CONTACT_POS,
+  MJWF_BUF_CONTACT_FRAME,
+  MJWF_BUF_RAY_VEC,
+  MJWF_BUF_RAY_GEOMID,
+  MJWF_NBUF
+};
+size_t _mjwf_arena_mark(int h);
+void*  _mjwf_arena_alloc(int h, size_t bytes);
+void   _mjwf_arena_reset(int h, size_t mark);
+void*  _mjwf_arena_buffer(int h, int slot, size_t bytes);
+void   _mjwf_arena_release(int h);
+
+#ifdef __cplusplus
+}
+#endif
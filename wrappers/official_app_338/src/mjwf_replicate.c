@@ -0,0 +1,247 @@
+// Scene replication for MuJoCo WASM 3.3.8-alpha
+// Builds one mjModel holding n copies of a base model with the mjs_* spec
+// API: each copy is attached (names prefixed "e<i>/") to its own frame on a
+// square grid in the world body, so a single mj_step advances every env.
+//
+// Copies never collide with each other: the handle layer installs
+// mjcb_contactfilter, which keeps the default contype/conaffinity test and
+// additionally rejects geom pairs from different copies (for models built
+// here; other models see the default behaviour). Parent/child and weld
+// filtering is done by MuJoCo before the callback and is unaffected.
+//
+// Attachment keeps each copy's joints, dofs, actuators and sensors
+// contiguous, so per-env slices of qpos/qvel/ctrl/sensordata/... are strided
+// views: env i owns view[offset + i * stride, offset + (i + 1) * stride)
+// (mjwf_replica_slice). Bodies skip the shared world body. Geoms and sites
+// are strided only when the base has none attached to its world body, since
+// those of all copies come first in the world body.
+
+#include <math.h>
+#include <mujoco/mujoco.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mjwf_exports.h"
+#include "mjwf_exports_generated.h"  // MJWF_EXTENT_*
+#include "mjwf_internal.h"
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#else
+#ifndef EMSCRIPTEN_KEEPALIVE
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#endif
+
+typedef struct {
+  int n;                             // copies; 0 = not a replicated handle
+  const int* key;                    // m->geom_bodyid, also seen by shared handles
+  int* geom_env;                     // copy owning each geom
+  int nbody;                         // bodies per copy (without the world body)
+  int offset[MJWF_EXTENT_OTHER];     // per-extent slices, valid where strided[e]
+  int stride[MJWF_EXTENT_OTHER];
+  unsigned char strided[MJWF_EXTENT_OTHER];
+} mjwf_replica;
+
+static mjwf_replica g_replica[MJWF_MAXH];
+// Replicated handles, compact: the contact filter runs per broadphase pair of
+// every model, so it scans these rather than all MJWF_MAXH slots.
+static int g_live[MJWF_MAXH];
+static int g_nlive = 0;
+
+static int mjwf_extent_count(const mjModel* m, int extent) {
+  switch (extent) {
+    case MJWF_EXTENT_NQ:          return m->nq;
+    case MJWF_EXTENT_NV:          return m->nv;
+    case MJWF_EXTENT_NU:          return m->nu;
+    case MJWF_EXTENT_NA:          return m->na;
+    case MJWF_EXTENT_NBODY:       return m->nbody;
+    case MJWF_EXTENT_NJNT:        return m->njnt;
+    case MJWF_EXTENT_NGEOM:       return m->ngeom;
+    case MJWF_EXTENT_NSITE:       return m->nsite;
+    case MJWF_EXTENT_NMAT:        return m->nmat;
+    case MJWF_EXTENT_NSENSORDATA: return m->nsensordata;
+    default:                      return 0;
+  }
+}
+
+static int mjwf_count_world(const int* bodyid, int n) {
+  int c = 0;
+  for (int i = 0; i < n; ++i) c += bodyid[i] == 0;
+  return c;
+}
+
+static const mjwf_replica* mjwf_replica_of_model(const mjModel* m) {
+  for (int i = 0; i < g_nlive; ++i) {
+    const mjwf_replica* r = &g_replica[g_live[i]];
+    if (r->key == m->geom_bodyid) return r;
+  }
+  return NULL;
+}
+
+static const mjwf_replica* mjwf_replica_of(int h) {
+  if (!mjwf_valid(h)) return NULL;
+  const int base = _mjwf_shared_base(h);
+  const mjwf_replica* r = &g_replica[base ? base : h];
+  return r->n ? r : NULL;
+}
+
+static int mjwf_replica_filter(const mjModel* m, mjData* d, int g1, int g2) {
+  (void)d;
+  if (!(m->geom_contype[g1] & m->geom_conaffinity[g2]) && !(m->geom_contype[g2] & m->geom_conaffinity[g1])) {
+    return 1;
+  }
+  const mjwf_replica* r = mjwf_replica_of_model(m);
+  return r && r->geom_env[g1] != r->geom_env[g2];
+}
+
+// Fills the extent slices and geom ownership from the base model and the
+// replicated one; returns 0 when the layout is not the expected block layout.
+static int mjwf_replica_layout(mjwf_replica* r, const mjModel* mb, const mjModel* m, int n) {
+  const int gworld = mjwf_count_world(mb->geom_bodyid, mb->ngeom);
+  const int sworld = mjwf_count_world(mb->site_bodyid, mb->nsite);
+  for (int e = 0; e < MJWF_EXTENT_OTHER; ++e) {
+    const int shared = e == MJWF_EXTENT_NBODY;  // the world body
+    const int cb = mjwf_extent_count(mb, e) - shared;
+    const int cr = mjwf_extent_count(m, e) - shared;
+    r->offset[e] = shared;
+    r->stride[e] = cb;
+    r->strided[e] = cr == n * cb && !(e == MJWF_EXTENT_NGEOM && gworld) && !(e == MJWF_EXTENT_NSITE && sworld);
+  }
+  if (m->ngeom != n * mb->ngeom || mjwf_count_world(m->geom_bodyid, m->ngeom) != n * gworld ||
+      !r->strided[MJWF_EXTENT_NBODY] || !r->strided[MJWF_EXTENT_NQ] || !r->strided[MJWF_EXTENT_NV] ||
+      !r->strided[MJWF_EXTENT_NU] || !r->strided[MJWF_EXTENT_NSENSORDATA]) {
+    return 0;
+  }
+  r->nbody = mb->nbody - 1;
+  r->geom_env = (int*)malloc(sizeof(int) * (m->ngeom > 0 ? m->ngeom : 1));
+  if (!r->geom_env) return 0;
+  // World-body geoms of all copies come first, in attachment order.
+  for (int g = 0, w = 0; g < m->ngeom; ++g) {
+    const int b = m->geom_bodyid[g];
+    r->geom_env[g] = b ? (b - 1) / r->nbody : w++ / gworld;
+  }
+  r->key = m->geom_bodyid;
+  r->n = n;
+  return 1;
+}
+
+static mjModel* mjwf_replica_compile(mjSpec* base, int n, double spacing) {
+  mjSpec* spec = mj_makeSpec();
+  if (!spec) return NULL;
+  spec->compiler = base->compiler;
+  spec->option = base->option;
+  spec->visual = base->visual;
+  spec->stat = base->stat;
+  if (base->memory != (size_t)-1) spec->memory = base->memory * (size_t)n;
+  mjsBody* world = mjs_findBody(spec, "world");
+  const int cols = (int)ceil(sqrt((double)n));
+  const double center = 0.5 * (cols - 1) * spacing;
+  for (int i = 0; i < n; ++i) {
+    char prefix[32];
+    snprintf(prefix, sizeof(prefix), "e%d/", i);
+    mjsFrame* frame = mjs_addFrame(world, NULL);
+    frame->pos[0] = (i % cols) * spacing - center;
+    frame->pos[1] = (i / cols) * spacing - center;
+    if (!mjs_attach(frame->element, base->element, prefix, "")) {
+      _mjwf_set_global_error(121, mjs_getError(spec));
+      mj_deleteSpec(spec);
+      return NULL;
+    }
+  }
+  mjModel* m = mj_compile(spec, _mjwf_asset_vfs());
+  if (!m) _mjwf_set_global_error(121, mjs_getError(spec));
+  mj_deleteSpec(spec);
+  return m;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_make_replicated(const char* path, int n, double spacing) {
+  if (!path || n <= 0) {
+    _mjwf_set_global_error(120, "make_replicated: need a model path and n > 0");
+    return -1;
+  }
+  if (mjcb_contactfilter && mjcb_contactfilter != mjwf_replica_filter) {
+    _mjwf_set_global_error(123, "make_replicated: mjcb_contactfilter is already in use");
+    return -1;
+  }
+  char error[1024] = {0};
+  mjSpec* base = mj_parseXML(path, _mjwf_asset_vfs(), error, sizeof(error));
+  if (!base) {
+    _mjwf_set_global_error(121, error[0] ? error : "parseXML failed");
+    return -1;
+  }
+  mjModel* mb = mj_compile(base, _mjwf_asset_vfs());
+  if (!mb) {
+    _mjwf_set_global_error(121, mjs_getError(base));
+    mj_deleteSpec(base);
+    return -1;
+  }
+  mjModel* m = mjwf_replica_compile(base, n, spacing);
+  mj_deleteSpec(base);
+  if (!m) {
+    mj_deleteModel(mb);
+    return -1;
+  }
+  mjwf_replica r = {0};
+  const int ok = mjwf_replica_layout(&r, mb, m, n);
+  mj_deleteModel(mb);
+  if (!ok) {
+    free(r.geom_env);
+    mj_deleteModel(m);
+    _mjwf_set_global_error(122, "make_replicated: copies are not laid out contiguously");
+    return -1;
+  }
+  const int h = _mjwf_make_from_model(m);
+  if (h < 0) {
+    free(r.geom_env);
+    return -1;
+  }
+  g_replica[h] = r;
+  g_live[g_nlive++] = h;
+  mjcb_contactfilter = mjwf_replica_filter;
+  return h;
+}
+
+void _mjwf_replica_release(int h) {
+  if (h <= 0 || h >= MJWF_MAXH || !g_replica[h].n) return;
+  free(g_replica[h].geom_env);
+  g_replica[h] = (mjwf_replica){0};
+  for (int i = 0; i < g_nlive; ++i) {
+    if (g_live[i] == h) {
+      g_live[i] = g_live[--g_nlive];
+      break;
+    }
+  }
+  if (!g_nlive && mjcb_contactfilter == mjwf_replica_filter) mjcb_contactfilter = NULL;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_replica_count(int h) {
+  const mjwf_replica* r = mjwf_replica_of(h);
+  return r ? r->n : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_replica_slice(int h, int view, int* offset, int* stride) {
+  const mjwf_replica* r = mjwf_replica_of(h);
+  if (!r) {
+    if (mjwf_valid(h)) _mjwf_set_error(h, 120, "replica_slice: not a replicated handle");
+    return 0;
+  }
+  int row = 0;
+  const int e = _mjwf_view_extent(view, &row);
+  if (e == MJWF_EXTENT_OTHER || !r->strided[e]) {
+    _mjwf_set_error(h, 124, "replica_slice: view is not strided per env");
+    return 0;
+  }
+  if (offset) *offset = r->offset[e] * row;
+  if (stride) *stride = r->stride[e] * row;
+  return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_replica_env_of(int h, int objtype, int id) {
+  const mjwf_replica* r = mjwf_replica_of(h);
+  const mjModel* m = _mjwf_model_of(h);
+  if (!r) return -1;
+  if (objtype == mjOBJ_BODY && id > 0 && id < m->nbody) return (id - 1) / r->nbody;
+  if (objtype == mjOBJ_GEOM && id >= 0 && id < m->ngeom) return r->geom_env[id];
+  return -1;
+}
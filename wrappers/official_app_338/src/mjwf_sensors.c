@@ -0,0 +1,238 @@
+// Named sensor subsets for MuJoCo WASM 3.3.8-alpha
+// mjwf_sensor_select resolves a comma-separated list of sensor names once
+// through sensor_adr/sensor_dim; gathers then pack just those values, in list
+// order, into a caller buffer instead of reading all of sensordata. Sensors
+// that sit next to each other in sensordata (in list order) are copied as one
+// run. The subset keeps its names and is re-resolved after an in-place
+// recompile (mjwf_model_generation changes); a name that no longer exists
+// fails the gather.
+//
+// Values are what mjwf_sensordata_ptr shows: sensors are evaluated in the
+// forward pass at the start of mj_step, so after a step they describe the
+// state before its integration (call mjwf_forward for post-step values).
+
+#include <mujoco/mujoco.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mjwf_exports.h"
+#include "mjwf_internal.h"
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#else
+#ifndef EMSCRIPTEN_KEEPALIVE
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#endif
+
+typedef struct {
+  char* names;     // the list as selected, re-resolved on model changes
+  int generation;
+  int nsensor;
+  int width;       // packed doubles
+  int* offset;     // nsensor + 1 packed offsets
+  int nrun;
+  int* run;        // nrun x (sensordata adr, length)
+} mjwf_subset;
+
+static mjwf_subset g_subset[MJWF_MAXH];
+
+void _mjwf_sensor_release(int h) {
+  if (h <= 0 || h >= MJWF_MAXH) return;
+  mjwf_subset* s = &g_subset[h];
+  free(s->names);
+  free(s->offset);
+  free(s->run);
+  memset(s, 0, sizeof(*s));
+}
+
+// Resolves names against h's current model into s. Returns 1, or 0 with the
+// handle error set (s untouched).
+static int mjwf_sensor_resolve(int h, const char* names, mjwf_subset* s) {
+  const mjModel* m = _mjwf_model_of(h);
+  const size_t len = strlen(names);
+  char* list = (char*)malloc(len + 1);
+  int* offset = (int*)malloc(sizeof(int) * (len / 2 + 2));
+  int* run = (int*)malloc(sizeof(int) * (len + 2));
+  if (!list || !offset || !run) {
+    free(list);
+    free(offset);
+    free(run);
+    _mjwf_set_error(h, 192, "sensor_select: allocation failed");
+    return 0;
+  }
+  memcpy(list, names, len + 1);
+
+  int nsensor = 0, nrun = 0, width = 0;
+  char name[256];
+  for (const char* p = names; *p;) {
+    while (*p == ' ' || *p == ',') ++p;
+    const char* end = p;
+    while (*end && *end != ',') ++end;
+    const char* last = end;
+    while (last > p && last[-1] == ' ') --last;
+    if (last == p) break;
+    const size_t n = (size_t)(last - p) < sizeof(name) - 1 ? (size_t)(last - p) : sizeof(name) - 1;
+    memcpy(name, p, n);
+    name[n] = 0;
+    p = end;
+
+    const int id = mj_name2id(m, mjOBJ_SENSOR, name);
+    if (id < 0) {
+      char msg[320];
+      snprintf(msg, sizeof(msg), "sensor_select: no sensor named '%s'", name);
+      _mjwf_set_error(h, 190, msg);
+      free(list);
+      free(offset);
+      free(run);
+      return 0;
+    }
+    const int adr = m->sensor_adr[id];
+    const int dim = m->sensor_dim[id];
+    if (nrun && run[2 * nrun - 2] + run[2 * nrun - 1] == adr) {
+      run[2 * nrun - 1] += dim;
+    } else {
+      run[2 * nrun] = adr;
+      run[2 * nrun + 1] = dim;
+      nrun += 1;
+    }
+    offset[nsensor++] = width;
+    width += dim;
+  }
+  if (nsensor == 0) {
+    _mjwf_set_error(h, 190, "sensor_select: empty sensor list");
+    free(list);
+    free(offset);
+    free(run);
+    return 0;
+  }
+  offset[nsensor] = width;
+
+  free(s->names);
+  free(s->offset);
+  free(s->run);
+  s->names = list;
+  s->generation = _mjwf_model_generation(h);
+  s->nsensor = nsensor;
+  s->width = width;
+  s->offset = offset;
+  s->nrun = nrun;
+  s->run = run;
+  return 1;
+}
+
+// The handle's subset, re-resolved if the model changed; NULL with the error set.
+static mjwf_subset* mjwf_sensor_subset(int h) {
+  if (!mjwf_valid(h)) return NULL;
+  mjwf_subset* s = &g_subset[h];
+  if (!s->names) {
+    _mjwf_set_error(h, 191, "sensor_gather: no sensor subset selected");
+    return NULL;
+  }
+  if (s->generation != _mjwf_model_generation(h) && !mjwf_sensor_resolve(h, s->names, s)) return NULL;
+  return s;
+}
+
+static void mjwf_sensor_pack(const mjwf_subset* s, const mjtNum* sensordata, double* out) {
+  for (int r = 0; r < s->nrun; ++r) {
+    const int len = s->run[2 * r + 1];
+    memcpy(out, sensordata + s->run[2 * r], sizeof(double) * len);
+    out += len;
+  }
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_sensor_select(int h, const char* names) {
+  if (!mjwf_valid(h)) return -1;
+  if (!names) {
+    _mjwf_set_error(h, 190, "sensor_select: empty sensor list");
+    return -1;
+  }
+  if (!mjwf_sensor_resolve(h, names, &g_subset[h])) return -1;
+  return g_subset[h].width;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_sensor_offset(int h, int k) {
+  mjwf_subset* s = mjwf_sensor_subset(h);
+  if (!s || k < 0 || k > s->nsensor) return -1;
+  return s->offset[k];
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_sensor_gather(int h, double* out) {
+  mjwf_subset* s = mjwf_sensor_subset(h);
+  if (!s || !out) return -1;
+  mjwf_sensor_pack(s, _mjwf_data_of(h)->sensordata, out);
+  return s->width;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_step_gather(int h, int n, double* out) {
+  mjwf_subset* s = mjwf_sensor_subset(h);
+  if (!s || !out || n <= 0) return -1;
+  const mjData* d = _mjwf_data_of(h);
+  for (int i = 0; i < n; ++i) {
+    if (!mjwf_step(h, 1)) return -1;
+    mjwf_sensor_pack(s, d->sensordata, out + (size_t)i * s->width);
+  }
+  return n * s->width;
+}
+
+typedef struct {
+  const int* handles;
+  const int* row;   // packed offset of each handle's values
+  int nstep;
+  double* out;
+} mjwf_sensor_batch_job;
+
+static void mjwf_sensor_batch_range(void* ctx, int worker, int begin, int end) {
+  (void)worker;
+  const mjwf_sensor_batch_job* job = (const mjwf_sensor_batch_job*)ctx;
+  for (int k = begin; k < end; ++k) {
+    const int h = job->handles[k];
+    if (job->nstep > 0) mjwf_step(h, job->nstep);
+    mjwf_sensor_pack(&g_subset[h], _mjwf_data_of(h)->sensordata, job->out + job->row[k]);
+  }
+}
+
+static int mjwf_int_cmp(const void* a, const void* b) {
+  const int x = *(const int*)a, y = *(const int*)b;
+  return (x > y) - (x < y);
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_sensor_gather_batch(const int* handles, int nh, int nstep, double* out) {
+  if (!handles || nh <= 0 || nstep < 0 || !out) {
+    _mjwf_set_global_error(193, "sensor_gather_batch: bad arguments");
+    return -1;
+  }
+  int* row = (int*)malloc(sizeof(int) * 2 * (size_t)nh);
+  if (!row) {
+    _mjwf_set_global_error(192, "sensor_gather_batch: allocation failed");
+    return -1;
+  }
+  int total = 0;
+  for (int k = 0; k < nh; ++k) {
+    const mjwf_subset* s = mjwf_sensor_subset(handles[k]);
+    if (!s) {
+      _mjwf_set_global_error(193, "sensor_gather_batch: handle without a valid sensor subset");
+      free(row);
+      return -1;
+    }
+    row[k] = total;
+    total += s->width;
+  }
+  // Handles are stepped concurrently, so each may appear only once.
+  int* sorted = row + nh;
+  memcpy(sorted, handles, sizeof(int) * (size_t)nh);
+  qsort(sorted, (size_t)nh, sizeof(int), mjwf_int_cmp);
+  for (int k = 1; k < nh; ++k) {
+    if (sorted[k] == sorted[k - 1]) {
+      _mjwf_set_global_error(193, "sensor_gather_batch: duplicate handle");
+      free(row);
+      return -1;
+    }
+  }
+  mjwf_sensor_batch_job job = {handles, row, nstep, out};
+  _mjwf_parallel_for(nh, nstep > 0 ? _mjwf_worker_count(nh) : 1, mjwf_sensor_batch_range, &job);
+  free(row);
+  return total;
+}
@@ -0,0 +1,93 @@
+// Worker fan-out for batched mjwf services (MuJoCo WASM 3.3.8-alpha)
+// Batched calls split their items into contiguous chunks, one per worker, and
+// each worker runs against its own scratch mjData. With MJWF_THREADS (native
+// builds, or the pthread WASM build) chunks run on short-lived pthreads;
+// otherwise everything runs inline on the caller.
+
+#include <stddef.h>
+
+#include "mjwf_internal.h"
+
+#if defined(MJWF_THREADS)
+#include <pthread.h>
+#endif
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#else
+#ifndef EMSCRIPTEN_KEEPALIVE
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#endif
+
+#if defined(MJWF_THREADS)
+static int g_threads = 4;
+#else
+static int g_threads = 1;
+#endif
+
+EMSCRIPTEN_KEEPALIVE int mjwf_set_threads(int n) {
+#if defined(MJWF_THREADS)
+  if (n < 1) n = 1;
+  if (n > MJWF_MAXWORKERS) n = MJWF_MAXWORKERS;
+  g_threads = n;
+#else
+  (void)n;
+#endif
+  return g_threads;
+}
+
+EMSCRIPTEN_KEEPALIVE int mjwf_threads(void) { return g_threads; }
+
+int _mjwf_worker_count(int n) {
+  int w = g_threads;
+  if (w > n) w = n;
+  return w < 1 ? 1 : w;
+}
+
+#if defined(MJWF_THREADS)
+typedef struct {
+  mjwf_range_fn fn;
+  void* ctx;
+  int worker;
+  int begin;
+  int end;
+} mjwf_chunk;
+
+static void* mjwf_chunk_main(void* arg) {
+  mjwf_chunk* c = (mjwf_chunk*)arg;
+  c->fn(c->ctx, c->worker, c->begin, c->end);
+  return NULL;
+}
+#endif
+
+void _mjwf_parallel_for(int n, int nworker, mjwf_range_fn fn, void* ctx) {
+  if (n <= 0) return;
+  if (nworker < 1) nworker = 1;
+  if (nworker > MJWF_MAXWORKERS) nworker = MJWF_MAXWORKERS;
+#if defined(MJWF_THREADS)
+  if (nworker > 1) {
+    mjwf_chunk chunks[MJWF_MAXWORKERS];
+    pthread_t tids[MJWF_MAXWORKERS];
+    int started[MJWF_MAXWORKERS] = {0};
+    for (int w = 0; w < nworker; ++w) {
+      chunks[w].fn = fn;
+      chunks[w].ctx = ctx;
+      chunks[w].worker = w;
+      chunks[w].begin = (int)((long long)n * w / nworker);
+      chunks[w].end = (int)((long long)n * (w + 1) / nworker);
+    }
+    // Worker 0 runs on the caller; a failed spawn falls back to inline.
+    for (int w = 1; w < nworker; ++w) {
+      started[w] = pthread_create(&tids[w], NULL, mjwf_chunk_main, &chunks[w]) == 0;
+    }
+    mjwf_chunk_main(&chunks[0]);
+    for (int w = 1; w < nworker; ++w) {
+      if (started[w]) pthread_join(tids[w], NULL);
+      else mjwf_chunk_main(&chunks[w]);
+    }
+    return;
+  }
+#endif
+  fn(ctx, 0, 0, n);
+}